@@ -28,9 +28,18 @@ void PitchDetector::prepare(double newSampleRate)
     
     // Update period bounds based on actual sample rate and frequency bounds
     maxPeriod = static_cast<int>(sampleRate / minFrequency);
-    minPeriod = static_cast<int>(sampleRate / maxFrequency);
     
-    yinBuffer.resize(maxPeriod);
+    // Size the YIN window for the lowest bound setFrequencyBounds() allows, so changing
+    // the bounds later only moves the lag range. Below no threshold dip, the deepest
+    // dip still counts if it's under 0.5.
+    YinPitchTracker::Settings yinSettings;
+    yinSettings.windowSize = 2 * (static_cast<int>(sampleRate / 20.0) + 2);
+    yinSettings.hopSize = 0;
+    yinSettings.minFrequency = minFrequency;
+    yinSettings.maxFrequency = maxFrequency;
+    yinSettings.threshold = yinTracker.getSettings().threshold;
+    yinSettings.fallbackThreshold = 0.5f;
+    yinTracker.prepare(sampleRate, yinSettings);
     
     // Prepare WORLD buffers
     if (worldOption)
@@ -59,8 +68,7 @@ void PitchDetector::prepare(double newSampleRate)
         
         // Initialize rolling buffer for DIO based on user-configurable buffer time
         dioBufferSize = static_cast<int>(sampleRate * dioBufferTimeSeconds);  
-        dioRollingBuffer.resize(dioBufferSize);
-        std::fill(dioRollingBuffer.begin(), dioRollingBuffer.end(), 0.0);
+        dioRollingBuffer.setSize(1, dioBufferSize);
         dioBufferWritePos = 0;
         dioSamplesAccumulated = 0;
         // Process when buffer is full (for initial analysis) or every 100ms for updates
@@ -77,8 +85,7 @@ void PitchDetector::setFrequencyBounds(float minFreq, float maxFreq)
     if (sampleRate > 0)
     {
         maxPeriod = static_cast<int>(sampleRate / minFrequency);
-        minPeriod = static_cast<int>(sampleRate / maxFrequency);
-        yinBuffer.resize(maxPeriod);
+        yinTracker.setFrequencyRange(minFrequency, maxFrequency);
         
         // Update WORLD parameters
         if (worldOption)
@@ -101,110 +108,15 @@ float PitchDetector::detectPitch(const float* buffer, int numSamples)
     if (numSamples < maxPeriod * 2)
         return 0.0f;
     
-    // Step 1: Calculate the difference function
-    differenceFunction(buffer, numSamples, yinBuffer.data(), maxPeriod);
+    const float pitch = yinTracker.analyse(buffer, numSamples).frequency;
     
-    // Step 2: Calculate the cumulative mean normalized difference function
-    cumulativeMeanNormalizedDifferenceFunction(yinBuffer.data(), maxPeriod);
-    
-    // Step 3: Find the first minimum below the threshold
-    int tau = absoluteThreshold(yinBuffer.data(), maxPeriod, yinThreshold);
-    
-    if (tau == -1)
-        return 0.0f; // No pitch found
-    
-    // Step 4: Parabolic interpolation for better precision
-    float betterTau = parabolicInterpolation(tau, yinBuffer.data(), maxPeriod);
-    
-    // Convert period to frequency
-    float pitch = static_cast<float>(sampleRate / betterTau);
-    
-    // Sanity check
+    // Sanity check (0 when no pitch found)
     if (pitch < 40.0f || pitch > 2000.0f)
         return 0.0f;
     
     return pitch;
 }
 
-void PitchDetector::differenceFunction(const float* buffer, int numSamples, float* result, int maxLag)
-{
-    // Calculate autocorrelation using the difference function
-    for (int tau = 0; tau < maxLag; ++tau)
-    {
-        float sum = 0.0f;
-        for (int i = 0; i < maxLag; ++i)
-        {
-            float delta = buffer[i] - buffer[i + tau];
-            sum += delta * delta;
-        }
-        result[tau] = sum;
-    }
-}
-
-void PitchDetector::cumulativeMeanNormalizedDifferenceFunction(float* df, int size)
-{
-    df[0] = 1.0f;
-    float runningSum = 0.0f;
-    
-    for (int tau = 1; tau < size; ++tau)
-    {
-        runningSum += df[tau];
-        df[tau] = df[tau] * tau / runningSum;
-    }
-}
-
-int PitchDetector::absoluteThreshold(const float* yinBuffer, int size, float threshold)
-{
-    // Start from minPeriod to avoid high frequency noise
-    for (int tau = minPeriod; tau < size - 1; ++tau)
-    {
-        if (yinBuffer[tau] < threshold)
-        {
-            // Check if this is a local minimum
-            while (tau + 1 < size && yinBuffer[tau + 1] < yinBuffer[tau])
-            {
-                tau++;
-            }
-            return tau;
-        }
-    }
-    
-    // No pitch found below threshold, find the minimum value
-    int minTau = minPeriod;
-    float minValue = yinBuffer[minPeriod];
-    
-    for (int tau = minPeriod + 1; tau < size; ++tau)
-    {
-        if (yinBuffer[tau] < minValue)
-        {
-            minValue = yinBuffer[tau];
-            minTau = tau;
-        }
-    }
-    
-    return minValue < 0.5f ? minTau : -1;
-}
-
-float PitchDetector::parabolicInterpolation(int tauEstimate, const float* yinBuffer, int yinBufferSize)
-{
-    if (tauEstimate < 1 || tauEstimate >= yinBufferSize - 1)
-        return static_cast<float>(tauEstimate);
-    
-    float s0 = yinBuffer[tauEstimate - 1];
-    float s1 = yinBuffer[tauEstimate];
-    float s2 = yinBuffer[tauEstimate + 1];
-    
-    float a = (s0 - 2.0f * s1 + s2) / 2.0f;
-    float b = (s2 - s0) / 2.0f;
-    
-    if (a == 0.0f)
-        return static_cast<float>(tauEstimate);
-    
-    float xOffset = -b / (2.0f * a);
-    
-    return static_cast<float>(tauEstimate) + xOffset;
-}
-
 float PitchDetector::detectPitchWORLD(const float* buffer, int numSamples)
 {
     static float lastValidPitch = 0.0f;
@@ -219,13 +131,9 @@ float PitchDetector::detectPitchWORLD(const float* buffer, int numSamples)
     
     // Add new samples to rolling buffer
     for (int i = 0; i < numSamples; ++i)
-    {
-        if (dioBufferWritePos >= 0 && dioBufferWritePos < static_cast<int>(dioRollingBuffer.size()))
-        {
-            dioRollingBuffer[dioBufferWritePos] = static_cast<double>(buffer[i]);
-            dioBufferWritePos = (dioBufferWritePos + 1) % dioBufferSize;
-        }
-    }
+        dioRollingBuffer.setSample(0, dioBufferWritePos + i, static_cast<double>(buffer[i]));
+    
+    dioBufferWritePos = dioRollingBuffer.wrap(dioBufferWritePos + numSamples);
     
     dioTotalSamplesReceived += numSamples;
     dioSamplesAccumulated += numSamples;
@@ -253,19 +161,9 @@ float PitchDetector::detectPitchWORLD(const float* buffer, int numSamples)
     }
     
     // Copy rolling buffer to linear buffer for DIO
-    // Start from the oldest sample (write position is the next position to write, so oldest is at writePos)
-    int readPos = dioBufferWritePos;
+    // Start from the oldest sample, dioBufferSize behind the write position
     int buffersToCopy = std::min(dioBufferSize, static_cast<int>(worldBuffer.size()));
-    buffersToCopy = std::min(buffersToCopy, static_cast<int>(dioRollingBuffer.size()));
-    
-    for (int i = 0; i < buffersToCopy; ++i)
-    {
-        if (i < static_cast<int>(worldBuffer.size()) && readPos < static_cast<int>(dioRollingBuffer.size()))
-        {
-            worldBuffer[i] = dioRollingBuffer[readPos];
-        }
-        readPos = (readPos + 1) % dioBufferSize;
-    }
+    dioRollingBuffer.read(0, dioBufferWritePos - dioBufferSize, worldBuffer.data(), buffersToCopy);
     
     DioOption* opt = static_cast<DioOption*>(worldOption);
     
@@ -402,24 +300,11 @@ void PitchDetector::setDIOBufferTime(float bufferTime)
         {
             std::lock_guard<std::mutex> lock(dioBufferMutex);
             
-            // Create new buffers with the new size
-            std::vector<double> newRollingBuffer(newBufferSize, 0.0);
+            // Old contents are not carried over: detection restarts and the
+            // buffer is completely refilled before dioBufferFilled is set again
             std::vector<double> newWorldBuffer(newBufferSize);
             
-            // Copy existing data if possible
-            int copySize = std::min(dioBufferSize, newBufferSize);
-            if (copySize > 0 && dioBufferSize > 0)
-            {
-                int readPos = dioBufferWritePos;
-                for (int i = 0; i < copySize; ++i)
-                {
-                    newRollingBuffer[i] = dioRollingBuffer[readPos];
-                    readPos = (readPos + 1) % dioBufferSize;
-                }
-            }
-            
-            // Swap with new buffers
-            dioRollingBuffer.swap(newRollingBuffer);
+            dioRollingBuffer.setSize(1, newBufferSize);
             worldBuffer.swap(newWorldBuffer);
             
             dioBufferSize = newBufferSize;
@@ -446,8 +331,5 @@ void PitchDetector::resetDIOState()
     dioSamplesAccumulated = 0;
     dioTotalSamplesReceived = 0;
     dioBufferFilled = false;
-    if (dioBufferSize > 0 && dioRollingBuffer.size() > 0)
-    {
-        std::fill(dioRollingBuffer.begin(), dioRollingBuffer.end(), 0.0);
-    }
+    dioRollingBuffer.clear();
 }
\ No newline at end of file
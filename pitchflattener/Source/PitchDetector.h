@@ -1,6 +1,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "RingBuffer.h"
+#include "YinPitchTracker.h"
 #include <vector>
 #include <memory>
 #include <mutex>
@@ -20,7 +22,7 @@ public:
     void prepare(double sampleRate);
     float detectPitch(const float* buffer, int numSamples);
     
-    void setThreshold(float threshold) { yinThreshold = threshold; }
+    void setThreshold(float threshold) { yinTracker.setThreshold(threshold); }
     void setFrequencyBounds(float minFreq, float maxFreq);
     void setAlgorithm(Algorithm algo);
     void resetDIOState();
@@ -41,21 +43,12 @@ private:
     double sampleRate = 48000.0;
     Algorithm algorithm = Algorithm::YIN;
     
-    // Yin algorithm parameters
-    float yinThreshold = 0.15f;
-    int minPeriod = 24;  // ~2000 Hz at 48kHz (will be updated based on actual sample rate)
+    // Yin algorithm (shared tracker, sized in prepare() for the lowest allowed bound)
+    YinPitchTracker yinTracker;
     int maxPeriod = 1200; // ~40 Hz at 48kHz (will be updated based on actual sample rate)
     float minFrequency = 40.0f;
     float maxFrequency = 2000.0f;
     
-    std::vector<float> yinBuffer;
-    
-    // Yin algorithm implementation
-    void differenceFunction(const float* buffer, int numSamples, float* result, int maxLag);
-    void cumulativeMeanNormalizedDifferenceFunction(float* df, int size);
-    int absoluteThreshold(const float* yinBuffer, int size, float threshold);
-    float parabolicInterpolation(int tauEstimate, const float* yinBuffer, int yinBufferSize);
-    
     // WORLD DIO implementation
     float detectPitchWORLD(const float* buffer, int numSamples);
     void* worldOption = nullptr;  // Use void* to avoid including WORLD headers here
@@ -65,7 +58,7 @@ private:
     int worldSamplesPerFrame = 0;
     
     // Rolling buffer for DIO
-    std::vector<double> dioRollingBuffer;
+    RingBuffer<double> dioRollingBuffer;
     int dioBufferWritePos = 0;
     int dioBufferSize = 0;
     float dioBufferTimeSeconds = 0.5f;
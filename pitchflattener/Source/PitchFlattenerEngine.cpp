@@ -127,7 +127,6 @@ void PitchFlattenerEngine::prepare(double newSampleRate, int newMaxBlockSize)
     // Initialize lookahead buffer
     lookaheadSize = static_cast<int>(maxBlockSize * lookaheadMultiplier);
     lookaheadBuffer.setSize(2, lookaheadSize + maxBlockSize * 2);
-    lookaheadBuffer.clear();
     lookaheadWritePos = 0;
     lookaheadReadPos = 0;
     
@@ -226,7 +225,6 @@ void PitchFlattenerEngine::setParameters(float detectedPitch, float targetPitch,
     {
         lookaheadSize = newLookaheadSize;
         lookaheadBuffer.setSize(2, lookaheadSize + maxBlockSize * 2);
-        lookaheadBuffer.clear();
         lookaheadWritePos = 0;
         lookaheadReadPos = 0;
     }
@@ -330,19 +328,12 @@ void PitchFlattenerEngine::process(juce::AudioBuffer<float>& buffer, float mixAm
     
     // Write input to lookahead buffer
     for (int ch = 0; ch < numChannels; ++ch)
-    {
-        const float* input = buffer.getReadPointer(ch);
-        float* lookaheadData = lookaheadBuffer.getWritePointer(ch);
-        
-        for (int i = 0; i < numSamples; ++i)
-        {
-            lookaheadData[(lookaheadWritePos + i) % lookaheadBuffer.getNumSamples()] = input[i];
-        }
-    }
-    lookaheadWritePos = (lookaheadWritePos + numSamples) % lookaheadBuffer.getNumSamples();
+        lookaheadBuffer.write(ch, lookaheadWritePos, buffer.getReadPointer(ch), numSamples);
+    
+    lookaheadWritePos = lookaheadBuffer.wrap(lookaheadWritePos + numSamples);
     
     // Calculate how many samples we can feed to RubberBand
-    int samplesInLookahead = (lookaheadWritePos - lookaheadReadPos + lookaheadBuffer.getNumSamples()) % lookaheadBuffer.getNumSamples();
+    int samplesInLookahead = lookaheadBuffer.wrap(lookaheadWritePos - lookaheadReadPos);
     int samplesToFeed = std::min(samplesInLookahead, static_cast<int>(maxBlockSize * lookaheadMultiplier));
     
     // Only process if we have enough lookahead
@@ -350,11 +341,7 @@ void PitchFlattenerEngine::process(juce::AudioBuffer<float>& buffer, float mixAm
     {
         // Process left channel with lookahead
         float* tempBufferLeft = inputBufferLeft.data();
-        const float* lookaheadLeft = lookaheadBuffer.getReadPointer(0);
-        for (int i = 0; i < samplesToFeed; ++i)
-        {
-            tempBufferLeft[i] = lookaheadLeft[(lookaheadReadPos + i) % lookaheadBuffer.getNumSamples()];
-        }
+        lookaheadBuffer.read(0, lookaheadReadPos, tempBufferLeft, samplesToFeed);
         
         inputPointers[0] = tempBufferLeft;
         outputPointers[0] = outputBufferLeft.data();
@@ -369,18 +356,14 @@ void PitchFlattenerEngine::process(juce::AudioBuffer<float>& buffer, float mixAm
         if (numChannels > 1 && rubberBandRight && inputBufferRight.size() >= static_cast<size_t>(samplesToFeed))
         {
             float* tempBufferRight = inputBufferRight.data();
-            const float* lookaheadRight = lookaheadBuffer.getReadPointer(1);
-            for (int i = 0; i < samplesToFeed; ++i)
-            {
-                tempBufferRight[i] = lookaheadRight[(lookaheadReadPos + i) % lookaheadBuffer.getNumSamples()];
-            }
+            lookaheadBuffer.read(1, lookaheadReadPos, tempBufferRight, samplesToFeed);
             
             inputPointers[0] = tempBufferRight;
             rubberBandRight->process(inputPointers.data(), static_cast<size_t>(samplesToFeed), false);
         }
         
         // Update read position after feeding
-        lookaheadReadPos = (lookaheadReadPos + numSamples) % lookaheadBuffer.getNumSamples();
+        lookaheadReadPos = lookaheadBuffer.wrap(lookaheadReadPos + numSamples);
     }
     else
     {
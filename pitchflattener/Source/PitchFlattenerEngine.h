@@ -2,6 +2,7 @@
 
 #include <JuceHeader.h>
 #include <rubberband/RubberBandStretcher.h>
+#include "RingBuffer.h"
 #include <memory>
 #include <vector>
 
@@ -19,6 +20,9 @@ public:
     void setAdditionalLatency(int samples) { totalProcessingLatency = latencyInSamples + samples; }
     float getCurrentPitchRatio() const { return currentPitchRatio; }
     
+    // How long output can go on after the input stops: the latency plus what's queued ahead of RubberBand
+    int getTailSamples() const { return totalProcessingLatency + lookaheadSize + maxBlockSize; }
+    
     // RubberBand configuration
     void setRubberBandOptions(bool formantPreserve, int pitchMode, int transients, int phase, int window);
     
@@ -41,7 +45,7 @@ private:
     int preBufferSamples = 0;
     
     // Lookahead buffer for consistent feeding
-    juce::AudioBuffer<float> lookaheadBuffer;
+    RingBuffer<float> lookaheadBuffer;
     int lookaheadSize = 0;
     float lookaheadMultiplier = 2.0f;
     int lookaheadWritePos = 0;
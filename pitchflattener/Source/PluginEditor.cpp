@@ -1187,12 +1187,14 @@ void PitchFlattenerAudioProcessorEditor::timerCallback()
     
     if (usingDIO)
     {
-        const int samplesNeeded = 64; // Process small chunks for real-time display
-        float audioData[samplesNeeded];
-        audioProcessor.getLatestAudioBlock(audioData, samplesNeeded);
+        // Everything that arrived since the last tick, so the spectrogram sees a continuous signal
+        constexpr int chunkSize = 512;
+        float audioData[chunkSize];
+        int numRead;
         
-        for (int i = 0; i < samplesNeeded; ++i)
-            pitchMeter.pushAudioSample(audioData[i]);
+        while ((numRead = audioProcessor.popVisualizationSamples(audioData, chunkSize)) > 0)
+            for (int i = 0; i < numRead; ++i)
+                pitchMeter.pushAudioSample(audioData[i]);
             
         // Update the pitch meter with the actual target frequency being used
         pitchMeter.setTargetFrequency(targetPitch);
@@ -1260,18 +1262,25 @@ void PitchFlattenerAudioProcessorEditor::timerCallback()
     }
     
     // Update status
-    if (audioProcessor.isProcessing())
+    const juce::String loadText = " - CPU " + juce::String(audioProcessor.getProcessLoad(), 1) + "%";
+    
+    if (audioProcessor.isIdle())
+    {
+        statusLabel.setText("Idle - Input silent" + loadText, juce::dontSendNotification);
+        statusLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+    }
+    else if (audioProcessor.isProcessing())
     {
         if (detectedPitch > 0)
         {
             statusLabel.setText("Processing - Detected: " + 
-                               juce::String(detectedPitch, 1) + " Hz", 
+                               juce::String(detectedPitch, 1) + " Hz" + loadText, 
                                juce::dontSendNotification);
             statusLabel.setColour(juce::Label::textColourId, juce::Colours::lightgreen);
         }
         else
         {
-            statusLabel.setText("Processing - Waiting for pitch...", 
+            statusLabel.setText("Processing - Waiting for pitch..." + loadText, 
                                juce::dontSendNotification);
             statusLabel.setColour(juce::Label::textColourId, juce::Colours::yellow);
         }
@@ -14,6 +14,9 @@ PitchFlattenerAudioProcessor::PitchFlattenerAudioProcessor()
 {
     pitchDetector = std::make_unique<PitchDetector>();
     pitchEngine = std::make_unique<PitchFlattenerEngine>();
+    
+    // Sized once: the editor may be reading from it whenever the engines are prepared
+    visualizationFifo.setSize(1, visualizationFifoSize);
 }
 
 PitchFlattenerAudioProcessor::~PitchFlattenerAudioProcessor()
@@ -254,9 +257,20 @@ void PitchFlattenerAudioProcessor::changeProgramName (int index, const juce::Str
 }
 
 void PitchFlattenerAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    silenceTracker.prepare();
+    loadMeasurer.reset(sampleRate, samplesPerBlock);
+    sessionRecorder.prepare(*this, sampleRate, samplesPerBlock);
+
+    // Building the RubberBand stretchers, warming them up and the DIO buffers take long
+    // enough to slow down host scans and session loads, so they're done in the background.
+    // Audio passes through dry until they're ready.
+    preparer.start([this, sampleRate, samplesPerBlock] { prepareEngines(sampleRate, samplesPerBlock); });
+}
+
+void PitchFlattenerAudioProcessor::prepareEngines (double sampleRate, int samplesPerBlock)
 {
     analysisBuffer.setSize(1, analysisBufferSize);
-    analysisBuffer.clear();
     analysisBufferWritePos = 0;
     
     filteredAnalysisBuffer.setSize(1, analysisBufferSize);
@@ -279,13 +293,16 @@ void PitchFlattenerAudioProcessor::prepareToPlay (double sampleRate, int samples
     
     // Initialize DIO delay buffer (max 1.5 seconds to prevent crashes)
     dioDelayBufferSize = static_cast<int>(sampleRate * 1.5); // Max 1.5 seconds
-    dioDelayBuffer.setSize(2, dioDelayBufferSize, false, true, false); // Stereo, clear, don't allocate on audio thread
+    dioDelayBuffer.setSize(2, dioDelayBufferSize);
     dioDelayWritePos = 0;
     dioDelayReadPos = 0;
 }
 
 void PitchFlattenerAudioProcessor::releaseResources()
 {
+    preparer.cancel();
+    sessionRecorder.stop();
+    
     if (pitchEngine)
         pitchEngine->reset();
     
@@ -320,12 +337,34 @@ bool PitchFlattenerAudioProcessor::isBusesLayoutSupported (const BusesLayout& la
 void PitchFlattenerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer (loadMeasurer, buffer.getNumSamples());
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+    sessionRecorder.recordBlock(buffer);
+
+    // Pass through until the engines are built, except when rendering offline
+    if (isNonRealtime())
+        preparer.waitUntilReady();
+    
+    if (! preparer.isReady())
+        return;
+
+    // Silence in, and RubberBand and the delay lines have run dry: skip detection and
+    // shifting altogether. Their buffers hold nothing but silence, so they carry on
+    // from where they are when signal returns.
+    silenceTracker.setTailLength(pitchEngine->getTailSamples());
+    
+    if (silenceTracker.canSkipBlock(buffer, totalNumInputChannels, buffer.getNumSamples()))
+    {
+        buffer.clear();
+        currentVolumeDb.store(-60.0f);
+        return;
+    }
+
     // Always update target pitch
     targetPitch.store(*parameters.getRawParameterValue("targetPitch"));
     
@@ -440,25 +479,8 @@ void PitchFlattenerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
             pitchDetector->setDIOBufferTime(dioBufferTime);
             lastDioBufferTime = dioBufferTime;
             
-            // Also resize the audio delay buffer to match
-            // Limit to 1.5 seconds to prevent memory issues
-            int newDelaySize = static_cast<int>(getSampleRate() * 1.5); // Max 1.5 seconds
-            if (newDelaySize > 0 && newDelaySize != dioDelayBufferSize)
-            {
-                // Create new buffer with proper size
-                juce::AudioBuffer<float> newDelayBuffer(2, newDelaySize);
-                newDelayBuffer.clear();
-                
-                // Swap buffers atomically
-                {
-                    std::lock_guard<std::mutex> lock(delayBufferMutex);
-                    dioDelayBuffer = std::move(newDelayBuffer);
-                    dioDelayBufferSize = newDelaySize;
-                    dioDelayWritePos.store(0);
-                    dioDelayReadPos.store(0);
-                }
-            }
-            
+            // The delay buffer is already sized for the longest buffer time in prepareEngines(),
+            // so only the read position (set from dioBufferTime below) has to follow
             DBG("DIO Buffer time changed to: " << dioBufferTime << " seconds");
         }
     }
@@ -480,29 +502,17 @@ void PitchFlattenerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
         int delayInSamples = static_cast<int>(getSampleRate() * dioBufferTime);
         
         // Store incoming audio in delay buffer
+        if (dioDelayBuffer.getNumChannels() > 0 && dioDelayBufferSize > 0)
         {
-            std::lock_guard<std::mutex> lock(delayBufferMutex);
-            if (dioDelayBuffer.getNumChannels() > 0 && dioDelayBufferSize > 0)
+            const int writePos = dioDelayWritePos.load();
+            
+            for (int channel = 0; channel < totalNumInputChannels; ++channel)
             {
-                for (int channel = 0; channel < totalNumInputChannels; ++channel)
-                {
-                    const float* inputData = buffer.getReadPointer(channel);
-                    int delayChannel = channel % dioDelayBuffer.getNumChannels();
-                    float* delayData = dioDelayBuffer.getWritePointer(delayChannel);
-                    
-                    int writePos = dioDelayWritePos.load();
-                    for (int i = 0; i < numSamples; ++i)
-                    {
-                        if (writePos >= 0 && writePos < dioDelayBufferSize)
-                        {
-                            delayData[writePos] = inputData[i];
-                        }
-                        writePos = (writePos + 1) % dioDelayBufferSize;
-                    }
-                }
-                // Update write position once for all channels
-                dioDelayWritePos.store((dioDelayWritePos.load() + numSamples) % dioDelayBufferSize);
+                int delayChannel = channel % dioDelayBuffer.getNumChannels();
+                dioDelayBuffer.write(delayChannel, writePos, buffer.getReadPointer(channel), numSamples);
             }
+            // Update write position once for all channels
+            dioDelayWritePos.store(dioDelayBuffer.wrap(writePos + numSamples));
         }
         
         // Apply detection filters to DIO input
@@ -523,17 +533,11 @@ void PitchFlattenerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
         // For DIO, continuously feed filtered samples and get pitch
         float pitch = pitchDetector->detectPitch(filteredData, numSamples);
         
-        // Store filtered audio for FFT visualization (only for DIO)
+        // Store filtered audio for FFT visualization (only for DIO). Whatever doesn't
+        // fit while the editor is closed or behind is dropped.
         {
-            std::lock_guard<std::mutex> lock(visualizationBufferMutex);
-            if (visualizationBuffer.getNumChannels() > 0 && visualizationBuffer.getNumSamples() > 0)
-            {
-                for (int i = 0; i < numSamples; ++i)
-                {
-                    visualizationBuffer.setSample(0, visualizationBufferWritePos, filteredData[i]);
-                    visualizationBufferWritePos = (visualizationBufferWritePos + 1) % visualizationBuffer.getNumSamples();
-                }
-            }
+            const float* visualizationChannels[] = { filteredData };
+            visualizationFifo.push(visualizationChannels, 1, numSamples);
         }
         
         // Check if we're still in prebuffer phase
@@ -592,7 +596,7 @@ void PitchFlattenerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
         }
         
         // Read delayed audio for processing (aligned with pitch detection)
-        dioDelayReadPos.store((dioDelayWritePos.load() - delayInSamples + dioDelayBufferSize) % dioDelayBufferSize);
+        dioDelayReadPos.store(dioDelayBuffer.wrap(dioDelayWritePos.load() - delayInSamples));
         
         // During prebuffer phase, output silence but continue to process below
         if (inPrebufferPhase)
@@ -606,30 +610,14 @@ void PitchFlattenerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
         else
         {
             // After prebuffer, copy delayed audio back to buffer for processing
+            if (dioDelayBuffer.getNumChannels() > 0 && dioDelayBufferSize > 0)
             {
-                std::lock_guard<std::mutex> lock(delayBufferMutex);
-                if (dioDelayBuffer.getNumChannels() > 0 && dioDelayBufferSize > 0)
+                const int readPos = dioDelayReadPos.load();
+                
+                for (int channel = 0; channel < totalNumOutputChannels; ++channel)
                 {
-                    for (int channel = 0; channel < totalNumOutputChannels; ++channel)
-                    {
-                        float* outputData = buffer.getWritePointer(channel);
-                        int delayChannel = channel % dioDelayBuffer.getNumChannels();
-                        const float* delayData = dioDelayBuffer.getReadPointer(delayChannel);
-                        
-                        int currentReadPos = dioDelayReadPos.load();
-                        for (int i = 0; i < numSamples; ++i)
-                        {
-                            if (currentReadPos >= 0 && currentReadPos < dioDelayBufferSize)
-                            {
-                                outputData[i] = delayData[currentReadPos];
-                            }
-                            else
-                            {
-                                outputData[i] = 0.0f; // Safety fallback
-                            }
-                            currentReadPos = (currentReadPos + 1) % dioDelayBufferSize;
-                        }
-                    }
+                    int delayChannel = channel % dioDelayBuffer.getNumChannels();
+                    dioDelayBuffer.read(delayChannel, readPos, buffer.getWritePointer(channel), numSamples);
                 }
             }
         }
@@ -650,7 +638,7 @@ void PitchFlattenerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
         for (int i = 0; i < numSamples; ++i)
         {
             analysisBuffer.setSample(0, analysisBufferWritePos, channelData[i]);
-            analysisBufferWritePos = (analysisBufferWritePos + 1) % analysisBufferSize;
+            analysisBufferWritePos = analysisBuffer.wrap(analysisBufferWritePos + 1);
             detectionCounter++;
             
             // Perform pitch detection at user-specified rate
@@ -661,17 +649,8 @@ void PitchFlattenerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
                 // Only detect pitch if volume is above threshold
                 if (rms >= volumeThreshold)
                 {
-                    // Create a properly ordered buffer for pitch detection
-                    static AudioBuffer<float> orderedBuffer(1, analysisBufferSize);
-                    int readPos = analysisBufferWritePos;
-                    for (int j = 0; j < analysisBufferSize; ++j)
-                    {
-                        orderedBuffer.setSample(0, j, analysisBuffer.getSample(0, readPos));
-                        readPos = (readPos + 1) % analysisBufferSize;
-                    }
-                    
-                    // Apply bandpass filter to the ordered buffer for pitch detection
-                    filteredAnalysisBuffer.copyFrom(0, 0, orderedBuffer, 0, 0, analysisBufferSize);
+                    // Unroll the ring oldest-first straight into the filter buffer
+                    analysisBuffer.read(0, analysisBufferWritePos, filteredAnalysisBuffer.getWritePointer(0), analysisBufferSize);
                     
                     // Process through filters - highpass first, then lowpass
                     // Don't reset filters here as it would clear their state
@@ -1051,6 +1030,8 @@ void PitchFlattenerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
     
     pitchEngine->setAdditionalLatency(additionalLatency);
     pitchEngine->process(buffer, mix);
+    
+    silenceTracker.blockProcessed(buffer, totalNumOutputChannels, numSamples);
 }
 
 bool PitchFlattenerAudioProcessor::hasEditor() const
@@ -1090,36 +1071,13 @@ void PitchFlattenerAudioProcessor::setStateInformation (const void* data, int si
     }
 }
 
-void PitchFlattenerAudioProcessor::getLatestAudioBlock(float* buffer, int numSamples)
+int PitchFlattenerAudioProcessor::popVisualizationSamples(float* buffer, int maxSamples)
 {
-    if (!buffer || numSamples <= 0)
-        return;
-        
-    std::lock_guard<std::mutex> lock(visualizationBufferMutex);
-    
-    // Check if buffer is initialized
-    if (visualizationBuffer.getNumChannels() == 0 || visualizationBuffer.getNumSamples() == 0)
-    {
-        // Zero out the buffer if not initialized
-        for (int i = 0; i < numSamples; ++i)
-            buffer[i] = 0.0f;
-        return;
-    }
-    
-    int availableSamples = std::min(numSamples, visualizationBuffer.getNumSamples());
-    int readStart = visualizationBufferWritePos - availableSamples;
-    if (readStart < 0)
-        readStart += visualizationBuffer.getNumSamples();
-    
-    for (int i = 0; i < availableSamples; ++i)
-    {
-        int readPos = (readStart + i) % visualizationBuffer.getNumSamples();
-        buffer[i] = visualizationBuffer.getSample(0, readPos);
-    }
+    if (!buffer || maxSamples <= 0)
+        return 0;
     
-    // Zero out remaining samples if requested more than available
-    for (int i = availableSamples; i < numSamples; ++i)
-        buffer[i] = 0.0f;
+    float* channels[] = { buffer };
+    return visualizationFifo.pop(channels, 1, maxSamples);
 }
 
 bool PitchFlattenerAudioProcessor::isUsingDIO() const
@@ -3,7 +3,10 @@
 #include <JuceHeader.h>
 #include "PitchDetector.h"
 #include "PitchFlattenerEngine.h"
-#include <mutex>
+#include "RingBuffer.h"
+#include "SilenceTracker.h"
+#include "BackgroundPreparer.h"
+#include "SessionRecorder.h"
 
 class PitchFlattenerAudioProcessor : public juce::AudioProcessor
 {
@@ -58,12 +61,17 @@ public:
         wasFreezeEnabled = false;
     }
     
-    // Audio data access for FFT visualization
-    void getLatestAudioBlock(float* buffer, int numSamples);
+    // Filtered DIO input for the FFT visualization, in order and without gaps while the
+    // editor keeps up. Message thread only; returns how many samples were copied.
+    int popVisualizationSamples(float* buffer, int maxSamples);
     bool isUsingDIO() const;
     
     // Get the current pitch ratio for visualization
     float getCurrentPitchRatio() const;
+    
+    // Processing time as a percentage of the block's duration, and whether silence is being skipped
+    float getProcessLoad() const { return static_cast<float>(loadMeasurer.getLoadAsPercentage()); }
+    bool isIdle() const { return silenceTracker.isIdle(); }
 
 private:
     std::unique_ptr<PitchDetector> pitchDetector;
@@ -116,26 +124,35 @@ private:
     float pitchSlope = 0.0f;  // Hz per second slope
     float flattenedTargetPitch = 0.0f;  // The stable pitch we're flattening to
     
-    juce::AudioBuffer<float> analysisBuffer;
+    RingBuffer<float> analysisBuffer;
     int analysisBufferWritePos = 0;
     static constexpr int analysisBufferSize = 2048;  // Optimized for pitch detection
     
     // Audio delay buffer for DIO compensation
-    juce::AudioBuffer<float> dioDelayBuffer;
+    RingBuffer<float> dioDelayBuffer;
     int dioDelayBufferSize = 0;
     std::atomic<int> dioDelayWritePos{0};
     std::atomic<int> dioDelayReadPos{0};
-    mutable std::mutex delayBufferMutex;
     
     // Bandpass filter for pitch detection
     juce::dsp::IIR::Filter<float> detectionHighpass;
     juce::dsp::IIR::Filter<float> detectionLowpass;
     juce::AudioBuffer<float> filteredAnalysisBuffer;
     
-    // Audio buffer for FFT visualization
-    juce::AudioBuffer<float> visualizationBuffer;
-    std::mutex visualizationBufferMutex;
-    int visualizationBufferWritePos = 0;
+    // Audio for FFT visualization, from the audio thread to the editor
+    SpscRingBuffer<float> visualizationFifo;
+    static constexpr int visualizationFifoSize = 16384;
+    
+    // Idle detection and load measurement
+    SilenceTracker silenceTracker;
+    juce::AudioProcessLoadMeasurer loadMeasurer;
+
+    // Opt-in capture of the input and automation, for replaying sessions offline
+    SessionRecorder sessionRecorder;
+    
+    // Runs prepareEngines() off the message thread
+    void prepareEngines (double sampleRate, int samplesPerBlock);
+    BackgroundPreparer preparer { "PitchFlattener Prepare" };
     
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
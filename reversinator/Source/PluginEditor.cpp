@@ -392,13 +392,34 @@ ReversinatorAudioProcessorEditor::ReversinatorAudioProcessorEditor (Reversinator
         crossfadeValueLabel.setVisible(isForwardBackwards);
         resized();
     };
+    
+    // Processing load, updated by the timer
+    loadLabel.setFont(getCustomFonts()->getFont(12.0f));
+    loadLabel.setJustificationType(juce::Justification::centredLeft);
+    loadLabel.setColour(juce::Label::textColourId, accentColor.withAlpha(0.7f));
+    loadLabel.setTooltip("Processing time as a share of each block. Idle means the input is silent and processing is skipped.");
+    addAndMakeVisible(loadLabel);
+    
+    timerCallback();
+    startTimerHz(4);
 }
 
 ReversinatorAudioProcessorEditor::~ReversinatorAudioProcessorEditor()
 {
+    stopTimer();
     setLookAndFeel(nullptr);
 }
 
+void ReversinatorAudioProcessorEditor::timerCallback()
+{
+    juce::String text = "CPU " + juce::String(audioProcessor.getProcessLoad(), 1) + "%";
+    
+    if (audioProcessor.isIdle())
+        text << " (idle)";
+    
+    loadLabel.setText(text, juce::dontSendNotification);
+}
+
 void ReversinatorAudioProcessorEditor::setupSlider(juce::Slider& slider, juce::Label& label, 
                                                   juce::Label& valueLabel, const juce::String& labelText, 
                                                   const juce::String& suffix)
@@ -587,4 +608,5 @@ void ReversinatorAudioProcessorEditor::resized()
     // About button at bottom - less bottom space
     auto bottomArea = area.removeFromBottom(20);
     aboutButton.setBounds(bottomArea.removeFromRight(60).withSizeKeepingCentre(50, 20));
+    loadLabel.setBounds(bottomArea.removeFromLeft(160).withTrimmedLeft(10));
 }
\ No newline at end of file
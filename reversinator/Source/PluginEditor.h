@@ -52,7 +52,8 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AboutWindow)
 };
 
-class ReversinatorAudioProcessorEditor : public juce::AudioProcessorEditor
+class ReversinatorAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                         private juce::Timer
 {
 public:
     ReversinatorAudioProcessorEditor (ReversinatorAudioProcessor&);
@@ -62,6 +63,8 @@ public:
     void resized() override;
 
 private:
+    void timerCallback() override;
+    
     ReversinatorAudioProcessor& audioProcessor;
     
     // Main controls
@@ -93,6 +96,9 @@ private:
     juce::Label crossfadeValueLabel;
     juce::Label envelopeValueLabel;
     
+    // Processing load readout
+    juce::Label loadLabel;
+    
     // Website link
     juce::HyperlinkButton websiteLink;
     
@@ -140,10 +140,19 @@ void ReversinatorAudioProcessor::prepareToPlay (double sampleRate, int samplesPe
     reverseEngine->prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
     reverserCrossfade.reset(sampleRate, 0.1); // 100ms crossfade for smooth on/off
     reverserCrossfade.setCurrentAndTargetValue(reverserEnabled->load() ? 1.0f : 0.0f);
+    
+    wetBuffer.setSize(getTotalNumOutputChannels(), samplesPerBlock);
+    crossfadeRamp.allocate(static_cast<size_t>(samplesPerBlock), true);
+    crossfadeRampSize = samplesPerBlock;
+    
+    silenceTracker.prepare();
+    loadMeasurer.reset(sampleRate, samplesPerBlock);
+    sessionRecorder.prepare(*this, sampleRate, samplesPerBlock);
 }
 
 void ReversinatorAudioProcessor::releaseResources()
 {
+    sessionRecorder.stop();
     reverseEngine->reset();
 }
 
@@ -171,12 +180,26 @@ bool ReversinatorAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
 void ReversinatorAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer (loadMeasurer, buffer.getNumSamples());
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+    sessionRecorder.recordBlock(buffer);
+
+    // The engine holds up to two windows of audio, and each grain fades out over the envelope time
+    const double tailSeconds = 2.0 * windowTime->load() + envelopeTime->load() / 1000.0;
+    silenceTracker.setTailLength(static_cast<int>(std::ceil(tailSeconds * getSampleRate())));
+    
+    // Silence in, and everything has run out: skip the grains and the crossfade entirely
+    if (silenceTracker.canSkipBlock(buffer, totalNumInputChannels, buffer.getNumSamples(), ! reverserCrossfade.isSmoothing()))
+    {
+        buffer.clear();
+        return;
+    }
+
     bool currentReverserState = reverserEnabled->load() > 0.5f;
     if (currentReverserState != previousReverserState)
     {
@@ -194,28 +217,47 @@ void ReversinatorAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
         envelopeTime->load() / 1000.0f  // Convert ms to seconds
     );
     
-    if (reverserCrossfade.isSmoothing() || currentReverserState)
+    const int numSamples = buffer.getNumSamples();
+    
+    if (! reverserCrossfade.isSmoothing())
     {
-        juce::AudioBuffer<float> wetBuffer(totalNumOutputChannels, buffer.getNumSamples());
-        for (int channel = 0; channel < totalNumOutputChannels; ++channel)
-        {
-            wetBuffer.copyFrom(channel, 0, buffer, channel, 0, buffer.getNumSamples());
-        }
+        // Crossfade has settled: fully wet is the engine output, fully dry is the input
+        if (currentReverserState)
+            reverseEngine->process(buffer);
         
-        reverseEngine->process(wetBuffer);
+        silenceTracker.blockProcessed(buffer, totalNumOutputChannels, numSamples);
+        return;
+    }
+    
+    // Only reallocate if the host exceeds the prepared block size
+    if (numSamples > crossfadeRampSize)
+    {
+        crossfadeRamp.allocate(static_cast<size_t>(numSamples), true);
+        crossfadeRampSize = numSamples;
+    }
+    
+    wetBuffer.setSize(totalNumOutputChannels, numSamples, false, false, true);
+    
+    for (int channel = 0; channel < totalNumOutputChannels; ++channel)
+        wetBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+    
+    reverseEngine->process(wetBuffer);
+    
+    for (int sample = 0; sample < numSamples; ++sample)
+        crossfadeRamp[sample] = reverserCrossfade.getNextValue();
+    
+    // out = dry + (wet - dry) * crossfade
+    for (int channel = 0; channel < totalNumOutputChannels; ++channel)
+    {
+        float* dry = buffer.getWritePointer(channel);
+        float* wet = wetBuffer.getWritePointer(channel);
         
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            float crossfade = reverserCrossfade.getNextValue();
-            
-            for (int channel = 0; channel < totalNumOutputChannels; ++channel)
-            {
-                float dry = buffer.getSample(channel, sample);
-                float wet = wetBuffer.getSample(channel, sample);
-                buffer.setSample(channel, sample, dry * (1.0f - crossfade) + wet * crossfade);
-            }
-        }
+        juce::FloatVectorOperations::subtract(wet, dry, numSamples);
+        juce::FloatVectorOperations::multiply(wet, crossfadeRamp.getData(), numSamples);
+        juce::FloatVectorOperations::add(dry, wet, numSamples);
     }
+    
+    silenceTracker.blockProcessed(buffer, totalNumOutputChannels, numSamples);
 }
 
 bool ReversinatorAudioProcessor::hasEditor() const
@@ -2,6 +2,8 @@
 
 #include <JuceHeader.h>
 #include "ReverseEngine.h"
+#include "SilenceTracker.h"
+#include "SessionRecorder.h"
 
 class ReversinatorAudioProcessor : public juce::AudioProcessor
 {
@@ -39,6 +41,10 @@ public:
 
     juce::AudioProcessorValueTreeState& getValueTreeState() { return valueTreeState; }
     
+    // Processing time as a percentage of the block's duration, and whether silence is being skipped
+    float getProcessLoad() const { return static_cast<float>(loadMeasurer.getLoadAsPercentage()); }
+    bool isIdle() const { return silenceTracker.isIdle(); }
+    
     enum EffectMode
     {
         ReversePlayback = 0,
@@ -64,5 +70,16 @@ private:
     bool previousReverserState = false;
     juce::SmoothedValue<float> reverserCrossfade;
 
+    // Preallocated scratch for the wet signal and the per-sample crossfade ramp
+    juce::AudioBuffer<float> wetBuffer;
+    juce::HeapBlock<float> crossfadeRamp;
+    int crossfadeRampSize = 0;
+    
+    SilenceTracker silenceTracker;
+    juce::AudioProcessLoadMeasurer loadMeasurer;
+
+    // Opt-in capture of the input and automation, for replaying sessions offline
+    SessionRecorder sessionRecorder;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReversinatorAudioProcessor)
 };
\ No newline at end of file
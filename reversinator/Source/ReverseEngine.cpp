@@ -10,81 +10,46 @@ ReverseEngine::~ReverseEngine()
 
 void ReverseEngine::prepare(double newSampleRate, int samplesPerBlock, int newNumChannels)
 {
+    juce::ignoreUnused(samplesPerBlock);
+    
     sampleRate = newSampleRate;
-    numChannels = newNumChannels;
+    numChannels = std::max(1, newNumChannels);
     
-    channels.clear();
-    for (int i = 0; i < numChannels; ++i)
-    {
-        auto channel = std::make_unique<Channel>();
-        channel->windowSamples = static_cast<int>(windowTime * sampleRate);
-        channel->hopSize = channel->windowSamples / 2;  // 50% overlap
-        
-        // Initialize delay line (2x window size for safety)
-        channel->delayLine.resize(channel->windowSamples * 2);
-        channel->delayWritePos = 0;
-        
-        // Initialize grains
-        for (int g = 0; g < Channel::NUM_GRAINS; ++g)
-        {
-            channel->grains[g].buffer.resize(channel->windowSamples);
-            channel->grains[g].grainSize = channel->windowSamples;
-            channel->grains[g].active = false;
-            channel->grains[g].readPosition = 0;
-        }
-        
-        // Initialize output buffer (2x window size for overlap accumulation)
-        channel->outputBuffer.resize(channel->windowSamples * 2);
-        channel->outputReadPos = 0;
-        channel->outputWritePos = channel->windowSamples; // Start with latency
-        
-        // Initialize window function
-        channel->windowFunction.resize(channel->windowSamples);
-        channel->repeatBuffer.resize(channel->windowSamples);
-        
-        channel->vibratoPhase.reset(sampleRate, 0.001);
-        channel->feedbackGainSmoothed.reset(sampleRate, 0.001); // 1ms smoothing like original
-        
-        // Create window function
-        createWindowFunction(channel->windowFunction, channel->windowSamples);
-        
-        channels.push_back(std::move(channel));
-    }
+    windowSamples = static_cast<int>(windowTime * sampleRate);
+    hopSize = windowSamples / 2;  // 50% overlap
+    
+    feedbackSamples.assign(numChannels, 0.0f);
+    resizeBuffers();
+    
+    vibratoPhase.reset(sampleRate, 0.001);
+    feedbackGainSmoothed.reset(sampleRate, 0.001); // 1ms smoothing like original
     
     reset();
 }
 
 void ReverseEngine::reset()
 {
-    for (auto& channel : channels)
+    std::fill(delayLine.begin(), delayLine.end(), 0.0f);
+    std::fill(outputBuffer.begin(), outputBuffer.end(), 0.0f);
+    std::fill(feedbackSamples.begin(), feedbackSamples.end(), 0.0f);
+    
+    delayWritePos = 0;
+    outputReadPos = 0;
+    outputWritePos = windowSamples;
+    grainCounter = 0;
+    
+    // Reset all grains
+    for (int g = 0; g < NUM_GRAINS; ++g)
     {
-        std::fill(channel->delayLine.begin(), channel->delayLine.end(), 0.0f);
-        std::fill(channel->outputBuffer.begin(), channel->outputBuffer.end(), 0.0f);
-        std::fill(channel->repeatBuffer.begin(), channel->repeatBuffer.end(), 0.0f);
-        
-        channel->delayWritePos = 0;
-        channel->outputReadPos = 0;
-        channel->outputWritePos = channel->windowSamples;
-        channel->currentGrain = 0;
-        channel->grainCounter = 0;
-        
-        // Reset all grains
-        for (int g = 0; g < Channel::NUM_GRAINS; ++g)
-        {
-            std::fill(channel->grains[g].buffer.begin(), channel->grains[g].buffer.end(), 0.0f);
-            channel->grains[g].active = false;
-            channel->grains[g].readPosition = 0;
-        }
-        
-        channel->feedbackSample = 0.0f;
-        channel->crossfadePosition = 0.0f;
-        channel->crossfadeDirection = true;
-        channel->repeatPosition = 0;
-        channel->isRepeating = false;
-        channel->vibratoPhase.setCurrentAndTargetValue(0.0f);
-        channel->grainSpawnOffset = 0;
-        channel->feedbackGainSmoothed.setCurrentAndTargetValue(0.0f);
+        std::fill(grainBuffers[g].begin(), grainBuffers[g].end(), 0.0f);
+        grains[g].active = false;
+        grains[g].readPosition = 0;
     }
+    
+    isRepeating = false;
+    vibratoPhase.setCurrentAndTargetValue(0.0f);
+    grainSpawnOffset = 0;
+    feedbackGainSmoothed.setCurrentAndTargetValue(0.0f);
 }
 
 void ReverseEngine::setParameters(float windowTimeSeconds, float feedbackAmount, float wetMixAmount, float dryMixAmount, int mode, float crossfadePercent, float envelopeSeconds)
@@ -103,218 +68,248 @@ void ReverseEngine::setParameters(float windowTimeSeconds, float feedbackAmount,
     
     int newWindowSamples = static_cast<int>(windowTime * sampleRate);
     
-    for (auto& channel : channels)
+    if (windowSamples != newWindowSamples && ! feedbackSamples.empty())
     {
-        if (channel->windowSamples != newWindowSamples)
-        {
-            channel->windowSamples = newWindowSamples;
-            channel->hopSize = channel->windowSamples / 2;
-            
-            // Resize buffers
-            channel->delayLine.resize(channel->windowSamples * 2);
-            channel->outputBuffer.resize(channel->windowSamples * 2);
-            channel->windowFunction.resize(channel->windowSamples);
-            channel->repeatBuffer.resize(channel->windowSamples);
-            
-            // Reset positions
-            channel->delayWritePos = 0;
-            channel->outputReadPos = 0;
-            channel->outputWritePos = channel->windowSamples;
-            channel->currentGrain = 0;
-            channel->grainCounter = 0;
-            
-            // Resize grain buffers
-            for (int g = 0; g < Channel::NUM_GRAINS; ++g)
-            {
-                channel->grains[g].buffer.resize(channel->windowSamples);
-                channel->grains[g].grainSize = channel->windowSamples;
-                channel->grains[g].active = false;
-                channel->grains[g].readPosition = 0;
-            }
-            
-            // Recreate window function
-            createWindowFunction(channel->windowFunction, channel->windowSamples);
-        }
+        windowSamples = newWindowSamples;
+        hopSize = windowSamples / 2;
+        
+        resizeBuffers();
+        
+        // Reset positions
+        delayWritePos = 0;
+        outputReadPos = 0;
+        outputWritePos = windowSamples;
+        grainCounter = 0;
     }
 }
 
+void ReverseEngine::resizeBuffers()
+{
+    bufferLength = windowSamples * 2;
+    
+    // Sample data is interleaved across channels, so a resize reinterprets the
+    // old contents; start the new layout from silence instead
+    delayLine.assign(static_cast<size_t>(bufferLength * numChannels), 0.0f);
+    outputBuffer.assign(static_cast<size_t>(bufferLength * numChannels), 0.0f);
+    
+    for (int g = 0; g < NUM_GRAINS; ++g)
+    {
+        grainBuffers[g].assign(static_cast<size_t>(windowSamples * numChannels), 0.0f);
+        grains[g].grainSize = windowSamples;
+        grains[g].active = false;
+        grains[g].readPosition = 0;
+    }
+    
+    windowFunction.resize(windowSamples);
+    createWindowFunction(windowFunction, windowSamples);
+}
+
 void ReverseEngine::process(juce::AudioBuffer<float>& buffer)
 {
     const int numSamples = buffer.getNumSamples();
+    const int numLanes = std::min(numChannels, buffer.getNumChannels());
+    
+    if (numLanes <= 0 || windowSamples <= 0)
+        return;
+    
+    // All channels are processed in a single pass over the shared grain schedule
+    float* const* channelData = buffer.getArrayOfWritePointers();
+    
+    switch (effectMode)
+    {
+        case ReversePlayback:
+            processReversePlayback(channelData, numLanes, numSamples);
+            break;
+        case ForwardBackwards:
+            processForwardBackwards(channelData, numLanes, numSamples);
+            break;
+        case ReverseRepeat:
+            processReverseRepeat(channelData, numLanes, numSamples);
+            break;
+    }
+}
+
+void ReverseEngine::spawnGrain(int grainIndex, int delayReadPos)
+{
+    // Copy one window of frames out of the delay line, splitting at the wrap point
+    const int firstFrames = std::min(windowSamples, bufferLength - delayReadPos);
+    const float* source = delayLine.data();
+    float* dest = grainBuffers[grainIndex].data();
+    
+    std::copy(source + delayReadPos * numChannels,
+              source + (delayReadPos + firstFrames) * numChannels,
+              dest);
+    std::copy(source,
+              source + (windowSamples - firstFrames) * numChannels,
+              dest + firstFrames * numChannels);
+}
+
+void ReverseEngine::writeInputFrame(float* const* channelData, int numLanes, int sampleIndex)
+{
+    // Write to delay line WITHOUT feedback (feedback comes from output)
+    float* delayFrame = delayLine.data() + delayWritePos * numChannels;
+    for (int c = 0; c < numLanes; ++c)
+        delayFrame[c] = channelData[c][sampleIndex];
+    
+    // Clear output buffer position
+    float* outFrame = outputBuffer.data() + outputWritePos * numChannels;
+    std::fill(outFrame, outFrame + numChannels, 0.0f);
+}
+
+void ReverseEngine::writeOutputFrame(float* const* channelData, int numLanes, int sampleIndex, float feedbackGain)
+{
+    const float FEEDBACK_HARD_LIMIT = 0.95f;
+    const float* outFrame = outputBuffer.data() + outputReadPos * numChannels;
     
-    // Process each channel
-    for (int ch = 0; ch < numChannels && ch < buffer.getNumChannels(); ++ch)
+    for (int c = 0; c < numLanes; ++c)
     {
-        float* channelData = buffer.getWritePointer(ch);
+        float inputSample = channelData[c][sampleIndex];
         
-        switch (effectMode)
+        // Add feedback from previous output (matching original)
+        float wetSignal = outFrame[c] + (feedbackSamples[c] * feedbackGain);
+        
+        // Apply soft limiting like original
+        if (std::fabs(wetSignal) > FEEDBACK_HARD_LIMIT)
         {
-            case ReversePlayback:
-                processReversePlayback(*channels[ch], channelData, numSamples);
-                break;
-            case ForwardBackwards:
-                processForwardBackwards(*channels[ch], channelData, numSamples);
-                break;
-            case ReverseRepeat:
-                processReverseRepeat(*channels[ch], channelData, numSamples);
-                break;
+            wetSignal = std::tanh(wetSignal * 0.7f) * 1.4286f;
         }
+        
+        // Mix with dry signal
+        float processedSample = inputSample * dryMix + wetSignal * wetMix;
+        
+        // Store output for next sample's feedback (matching original)
+        feedbackSamples[c] = processedSample;
+        
+        channelData[c][sampleIndex] = processedSample;
     }
+    
+    // Update output buffer positions
+    if (++outputReadPos >= bufferLength)
+        outputReadPos = 0;
+    if (++outputWritePos >= bufferLength)
+        outputWritePos = 0;
 }
 
-void ReverseEngine::processReversePlayback(Channel& ch, float* channelData, int numSamples)
+void ReverseEngine::processReversePlayback(float* const* channelData, int numLanes, int numSamples)
 {
     // Match original: feedback * 0.5 safety factor
     const float FEEDBACK_SAFETY_FACTOR = 0.5f;
-    const float FEEDBACK_HARD_LIMIT = 0.95f;
     
     // Update smoothed feedback gain
-    ch.feedbackGainSmoothed.setTargetValue(feedback * FEEDBACK_SAFETY_FACTOR);
+    feedbackGainSmoothed.setTargetValue(feedback * FEEDBACK_SAFETY_FACTOR);
     
     for (int i = 0; i < numSamples; ++i)
     {
-        float inputSample = channelData[i];
-        
         // Get smoothed feedback gain
-        float currentFeedbackGain = ch.feedbackGainSmoothed.getNextValue();
+        float currentFeedbackGain = feedbackGainSmoothed.getNextValue();
         
-        // Write to delay line WITHOUT feedback (feedback comes from output)
-        ch.delayLine[ch.delayWritePos] = inputSample;
-        ch.delayWritePos = (ch.delayWritePos + 1) % ch.delayLine.size();
+        writeInputFrame(channelData, numLanes, i);
+        if (++delayWritePos >= bufferLength)
+            delayWritePos = 0;
         
-        // Clear output buffer position
-        ch.outputBuffer[ch.outputWritePos] = 0.0f;
+        float* outFrame = outputBuffer.data() + outputWritePos * numChannels;
         
         // Process active grains
-        for (int g = 0; g < Channel::NUM_GRAINS; ++g)
+        for (int g = 0; g < NUM_GRAINS; ++g)
         {
-            if (ch.grains[g].active)
+            if (grains[g].active)
             {
-                int readPos = ch.grains[g].readPosition;
-                if (readPos < ch.grains[g].grainSize)
+                int readPos = grains[g].readPosition;
+                if (readPos < grains[g].grainSize)
                 {
                     // Read from grain buffer in reverse
-                    int reverseIndex = ch.grains[g].grainSize - 1 - readPos;
-                    float grainSample = ch.grains[g].buffer[reverseIndex];
+                    int reverseIndex = grains[g].grainSize - 1 - readPos;
+                    const float* grainFrame = grainBuffers[g].data() + reverseIndex * numChannels;
                     
                     // Apply window
-                    float windowGain = ch.windowFunction[readPos];
+                    float windowGain = windowFunction[readPos];
+                    float amplitude = grains[g].amplitude;
                     
                     // Accumulate to output
-                    ch.outputBuffer[ch.outputWritePos] += grainSample * windowGain * ch.grains[g].amplitude;
+                    for (int c = 0; c < numLanes; ++c)
+                        outFrame[c] += grainFrame[c] * windowGain * amplitude;
                     
-                    ch.grains[g].readPosition++;
+                    grains[g].readPosition++;
                 }
                 else
                 {
-                    ch.grains[g].active = false;
+                    grains[g].active = false;
                 }
             }
         }
         
         // Spawn new grain at hop intervals
-        ch.grainCounter++;
-        if (ch.grainCounter >= ch.hopSize)
+        grainCounter++;
+        if (grainCounter >= hopSize)
         {
-            ch.grainCounter = 0;
+            grainCounter = 0;
             
             // Find inactive grain
-            for (int g = 0; g < Channel::NUM_GRAINS; ++g)
+            for (int g = 0; g < NUM_GRAINS; ++g)
             {
-                if (!ch.grains[g].active)
+                if (!grains[g].active)
                 {
                     // Copy from delay line to grain buffer
-                    int delayReadPos = (ch.delayWritePos - ch.windowSamples + ch.delayLine.size()) % ch.delayLine.size();
-                    
-                    for (int s = 0; s < ch.windowSamples; ++s)
-                    {
-                        ch.grains[g].buffer[s] = ch.delayLine[(delayReadPos + s) % ch.delayLine.size()];
-                    }
+                    spawnGrain(g, (delayWritePos - windowSamples + bufferLength) % bufferLength);
                     
-                    ch.grains[g].active = true;
-                    ch.grains[g].readPosition = 0;
-                    ch.grains[g].amplitude = 1.0f;
-                    ch.grains[g].grainSize = ch.windowSamples;
+                    grains[g].active = true;
+                    grains[g].readPosition = 0;
+                    grains[g].amplitude = 1.0f;
+                    grains[g].grainSize = windowSamples;
                     
                     break;
                 }
             }
         }
         
-        // Read from output buffer
-        float outputSample = ch.outputBuffer[ch.outputReadPos];
-        
-        // Add feedback from previous output (matching original)
-        float wetSignal = outputSample + (ch.feedbackSample * currentFeedbackGain);
-        
-        // Apply soft limiting like original
-        if (std::fabs(wetSignal) > FEEDBACK_HARD_LIMIT)
-        {
-            wetSignal = std::tanh(wetSignal * 0.7f) * 1.4286f;
-        }
-        
-        // Mix with dry signal
-        float processedSample = inputSample * dryMix + wetSignal * wetMix;
-        
-        // Store output for next sample's feedback (matching original)
-        ch.feedbackSample = processedSample;
-        
-        channelData[i] = processedSample;
-        
-        // Update output buffer positions
-        ch.outputReadPos = (ch.outputReadPos + 1) % ch.outputBuffer.size();
-        ch.outputWritePos = (ch.outputWritePos + 1) % ch.outputBuffer.size();
+        writeOutputFrame(channelData, numLanes, i, currentFeedbackGain);
     }
 }
 
-void ReverseEngine::processForwardBackwards(Channel& ch, float* channelData, int numSamples)
+void ReverseEngine::processForwardBackwards(float* const* channelData, int numLanes, int numSamples)
 {
     // Match original with 0.5 safety factor
     const float FEEDBACK_SAFETY_FACTOR = 0.5f;
-    const float FEEDBACK_HARD_LIMIT = 0.95f;
-    const int crossfadeSamples = static_cast<int>(ch.windowSamples * crossfadeTime);
+    const int crossfadeSamples = static_cast<int>(windowSamples * crossfadeTime);
     
     // Update smoothed feedback gain
-    ch.feedbackGainSmoothed.setTargetValue(feedback * FEEDBACK_SAFETY_FACTOR);
+    feedbackGainSmoothed.setTargetValue(feedback * FEEDBACK_SAFETY_FACTOR);
     
     for (int i = 0; i < numSamples; ++i)
     {
-        float inputSample = channelData[i];
-        float currentFeedbackGain = ch.feedbackGainSmoothed.getNextValue();
+        float currentFeedbackGain = feedbackGainSmoothed.getNextValue();
         
-        // Write to delay line without feedback
-        ch.delayLine[ch.delayWritePos] = inputSample;
+        writeInputFrame(channelData, numLanes, i);
         
-        // Clear output buffer
-        ch.outputBuffer[ch.outputWritePos] = 0.0f;
+        float* outFrame = outputBuffer.data() + outputWritePos * numChannels;
         
         // Process active grains
-        for (int g = 0; g < Channel::NUM_GRAINS; ++g)
+        for (int g = 0; g < NUM_GRAINS; ++g)
         {
-            if (ch.grains[g].active)
+            if (grains[g].active)
             {
-                int readPos = ch.grains[g].readPosition;
-                if (readPos < ch.grains[g].grainSize)
+                int readPos = grains[g].readPosition;
+                if (readPos < grains[g].grainSize)
                 {
-                    float grainSample;
+                    int halfGrain = grains[g].grainSize / 2;
+                    int sourceIndex;
                     
                     // First half: forward playback
-                    if (readPos < ch.grains[g].grainSize / 2)
+                    if (readPos < halfGrain)
                     {
-                        grainSample = ch.grains[g].buffer[readPos];
+                        sourceIndex = readPos;
                     }
                     // Second half: backward playback
                     else
                     {
-                        int reversePos = ch.grains[g].grainSize - 1 - (readPos - ch.grains[g].grainSize / 2);
-                        grainSample = ch.grains[g].buffer[reversePos];
+                        sourceIndex = grains[g].grainSize - 1 - (readPos - halfGrain);
                     }
                     
-                    float windowGain = ch.windowFunction[readPos];
+                    const float* grainFrame = grainBuffers[g].data() + sourceIndex * numChannels;
+                    float windowGain = windowFunction[readPos];
                     
                     // Apply crossfade at the transition point
                     float grainFade = 1.0f;
-                    int halfGrain = ch.grains[g].grainSize / 2;
                     
                     if (readPos >= halfGrain - crossfadeSamples && readPos < halfGrain)
                     {
@@ -329,184 +324,156 @@ void ReverseEngine::processForwardBackwards(Channel& ch, float* channelData, int
                         grainFade = fadePos;
                     }
                     
-                    ch.outputBuffer[ch.outputWritePos] += grainSample * windowGain * grainFade * ch.grains[g].amplitude;
+                    float amplitude = grains[g].amplitude;
                     
-                    ch.grains[g].readPosition++;
+                    for (int c = 0; c < numLanes; ++c)
+                        outFrame[c] += grainFrame[c] * windowGain * grainFade * amplitude;
+                    
+                    grains[g].readPosition++;
                 }
                 else
                 {
-                    ch.grains[g].active = false;
+                    grains[g].active = false;
                 }
             }
         }
         
-        // Spawn new grain pair at hop intervals
-        ch.grainCounter++;
-        if (ch.grainCounter >= ch.hopSize)
+        // Spawn new grain at hop intervals
+        grainCounter++;
+        if (grainCounter >= hopSize)
         {
-            ch.grainCounter = 0;
+            grainCounter = 0;
             
-            // Find two inactive grains for forward and backward
-            int forwardGrain = -1, reverseGrain = -1;
+            int forwardGrain = -1;
             
-            for (int g = 0; g < Channel::NUM_GRAINS; ++g)
+            for (int g = 0; g < NUM_GRAINS; ++g)
             {
-                if (!ch.grains[g].active)
+                if (!grains[g].active)
                 {
-                    if (forwardGrain == -1)
-                        forwardGrain = g;
-                    else if (reverseGrain == -1)
-                    {
-                        reverseGrain = g;
-                        break;
-                    }
+                    forwardGrain = g;
+                    break;
                 }
             }
             
             if (forwardGrain != -1)
             {
                 // Vary the read position to prevent feedback loops
-                int baseReadPos = (ch.delayWritePos - ch.windowSamples + ch.delayLine.size()) % ch.delayLine.size();
-                int delayReadPos = (baseReadPos - ch.grainSpawnOffset + ch.delayLine.size()) % ch.delayLine.size();
+                int baseReadPos = (delayWritePos - windowSamples + bufferLength) % bufferLength;
+                int delayReadPos = (baseReadPos - grainSpawnOffset + bufferLength) % bufferLength;
                 
                 // Copy from delay line
-                for (int s = 0; s < ch.windowSamples; ++s)
-                {
-                    float sample = ch.delayLine[(delayReadPos + s) % ch.delayLine.size()];
-                    ch.grains[forwardGrain].buffer[s] = sample;
-                    if (reverseGrain != -1)
-                        ch.grains[reverseGrain].buffer[s] = sample;
-                }
+                spawnGrain(forwardGrain, delayReadPos);
                 
-                ch.grains[forwardGrain].active = true;
-                ch.grains[forwardGrain].readPosition = 0;
-                ch.grains[forwardGrain].amplitude = 0.7f;  // Reduce amplitude to prevent buildup
-                ch.grains[forwardGrain].grainSize = ch.windowSamples;
+                grains[forwardGrain].active = true;
+                grains[forwardGrain].readPosition = 0;
+                grains[forwardGrain].amplitude = 0.7f;  // Reduce amplitude to prevent buildup
+                grains[forwardGrain].grainSize = windowSamples;
                 
-                // Update spawn offset for next grain pair (cycle through 25% of window)
-                ch.grainSpawnOffset = (ch.grainSpawnOffset + ch.windowSamples / 4) % (ch.windowSamples / 2);
+                // Update spawn offset for next grain (cycle through 25% of window)
+                grainSpawnOffset = (grainSpawnOffset + windowSamples / 4) % (windowSamples / 2);
             }
         }
         
-        // Read from output buffer
-        float outputSample = ch.outputBuffer[ch.outputReadPos];
-        
-        // Add feedback from previous output
-        float wetSignal = outputSample + (ch.feedbackSample * currentFeedbackGain);
+        writeOutputFrame(channelData, numLanes, i, currentFeedbackGain);
         
-        // Apply soft limiting like original
-        if (std::fabs(wetSignal) > FEEDBACK_HARD_LIMIT)
-        {
-            wetSignal = std::tanh(wetSignal * 0.7f) * 1.4286f;
-        }
-        
-        // Mix with dry signal
-        float processedSample = inputSample * dryMix + wetSignal * wetMix;
-        
-        // Store output for next sample's feedback
-        ch.feedbackSample = processedSample;
-        
-        channelData[i] = processedSample;
-        
-        // Update positions
-        ch.delayWritePos = (ch.delayWritePos + 1) % ch.delayLine.size();
-        ch.outputReadPos = (ch.outputReadPos + 1) % ch.outputBuffer.size();
-        ch.outputWritePos = (ch.outputWritePos + 1) % ch.outputBuffer.size();
+        if (++delayWritePos >= bufferLength)
+            delayWritePos = 0;
     }
 }
 
-void ReverseEngine::processReverseRepeat(Channel& ch, float* channelData, int numSamples)
+void ReverseEngine::processReverseRepeat(float* const* channelData, int numLanes, int numSamples)
 {
     // Match original with 0.5 safety factor
     const float FEEDBACK_SAFETY_FACTOR = 0.5f;
-    const float FEEDBACK_HARD_LIMIT = 0.95f;
     
     // Update smoothed feedback gain
-    ch.feedbackGainSmoothed.setTargetValue(feedback * FEEDBACK_SAFETY_FACTOR);
+    feedbackGainSmoothed.setTargetValue(feedback * FEEDBACK_SAFETY_FACTOR);
     
     for (int i = 0; i < numSamples; ++i)
     {
-        float inputSample = channelData[i];
-        float currentFeedbackGain = ch.feedbackGainSmoothed.getNextValue();
+        float currentFeedbackGain = feedbackGainSmoothed.getNextValue();
         
-        // Write to delay line without feedback
-        ch.delayLine[ch.delayWritePos] = inputSample;
+        writeInputFrame(channelData, numLanes, i);
         
-        // Clear output buffer
-        ch.outputBuffer[ch.outputWritePos] = 0.0f;
+        float* outFrame = outputBuffer.data() + outputWritePos * numChannels;
         
         // Process active grains
-        for (int g = 0; g < Channel::NUM_GRAINS; ++g)
+        for (int g = 0; g < NUM_GRAINS; ++g)
         {
-            if (ch.grains[g].active)
+            if (grains[g].active)
             {
-                int readPos = ch.grains[g].readPosition;
-                if (readPos < ch.grains[g].grainSize)
+                int readPos = grains[g].readPosition;
+                if (readPos < grains[g].grainSize)
                 {
-                    float grainSample;
-                    
-                    // Always read in reverse
-                    int reverseIndex = ch.grains[g].grainSize - 1 - readPos;
+                    float windowGain = windowFunction[readPos];
+                    float amplitude = grains[g].amplitude;
                     
                     // Apply vibrato only on second repeat
-                    if (ch.isRepeating && readPos >= ch.grains[g].grainSize / 2)
+                    if (isRepeating && readPos >= grains[g].grainSize / 2)
                     {
                         // Apply subtle vibrato modulation
-                        float vibratoMod = getVibratoModulation(ch);
+                        float vibratoMod = getVibratoModulation();
                         float vibratoDepth = 0.005f; // 0.5% pitch variation - much more subtle
                         
                         // Apply vibrato to forward position first, then reverse
-                        float modulatedPos = (float)readPos + vibratoMod * vibratoDepth * ch.grains[g].grainSize;
+                        float modulatedPos = (float)readPos + vibratoMod * vibratoDepth * grains[g].grainSize;
                         int modulatedIndex = (int)modulatedPos;
                         float frac = modulatedPos - modulatedIndex;
                         
                         // Clamp and reverse the modulated position
-                        modulatedIndex = std::clamp(modulatedIndex, 0, ch.grains[g].grainSize - 1);
-                        int modulatedReverseIndex = ch.grains[g].grainSize - 1 - modulatedIndex;
+                        modulatedIndex = std::clamp(modulatedIndex, 0, grains[g].grainSize - 1);
+                        int modulatedReverseIndex = grains[g].grainSize - 1 - modulatedIndex;
                         int nextIndex = std::max(0, modulatedReverseIndex - 1);
                         
-                        float sample1 = ch.grains[g].buffer[modulatedReverseIndex];
-                        float sample2 = ch.grains[g].buffer[nextIndex];
-                        grainSample = sample1 * (1.0f - frac) + sample2 * frac;
+                        const float* frame1 = grainBuffers[g].data() + modulatedReverseIndex * numChannels;
+                        const float* frame2 = grainBuffers[g].data() + nextIndex * numChannels;
+                        
+                        for (int c = 0; c < numLanes; ++c)
+                        {
+                            float grainSample = frame1[c] * (1.0f - frac) + frame2[c] * frac;
+                            outFrame[c] += grainSample * windowGain * amplitude;
+                        }
                     }
                     else
                     {
-                        grainSample = ch.grains[g].buffer[reverseIndex];
+                        // Always read in reverse
+                        int reverseIndex = grains[g].grainSize - 1 - readPos;
+                        const float* grainFrame = grainBuffers[g].data() + reverseIndex * numChannels;
+                        
+                        for (int c = 0; c < numLanes; ++c)
+                            outFrame[c] += grainFrame[c] * windowGain * amplitude;
                     }
                     
-                    float windowGain = ch.windowFunction[readPos];
-                    ch.outputBuffer[ch.outputWritePos] += grainSample * windowGain * ch.grains[g].amplitude;
-                    
-                    ch.grains[g].readPosition++;
+                    grains[g].readPosition++;
                 }
                 else
                 {
                     // Check if we should repeat
-                    if (!ch.isRepeating)
+                    if (!isRepeating)
                     {
-                        ch.isRepeating = true;
-                        ch.grains[g].readPosition = 0;  // Restart for second pass
+                        isRepeating = true;
+                        grains[g].readPosition = 0;  // Restart for second pass
                     }
                     else
                     {
-                        ch.grains[g].active = false;
-                        ch.isRepeating = false;
+                        grains[g].active = false;
+                        isRepeating = false;
                     }
                 }
             }
         }
         
         // Spawn new grain at hop intervals
-        ch.grainCounter++;
-        if (ch.grainCounter >= ch.hopSize)
+        grainCounter++;
+        if (grainCounter >= hopSize)
         {
-            ch.grainCounter = 0;
+            grainCounter = 0;
             
             // Find inactive grain
             int grainToUse = -1;
-            for (int g = 0; g < Channel::NUM_GRAINS; ++g)
+            for (int g = 0; g < NUM_GRAINS; ++g)
             {
-                if (!ch.grains[g].active)
+                if (!grains[g].active)
                 {
                     grainToUse = g;
                     break;
@@ -515,45 +482,20 @@ void ReverseEngine::processReverseRepeat(Channel& ch, float* channelData, int nu
             
             if (grainToUse != -1)
             {
-                int delayReadPos = (ch.delayWritePos - ch.windowSamples + ch.delayLine.size()) % ch.delayLine.size();
+                spawnGrain(grainToUse, (delayWritePos - windowSamples + bufferLength) % bufferLength);
                 
-                for (int s = 0; s < ch.windowSamples; ++s)
-                {
-                    ch.grains[grainToUse].buffer[s] = ch.delayLine[(delayReadPos + s) % ch.delayLine.size()];
-                }
-                
-                ch.grains[grainToUse].active = true;
-                ch.grains[grainToUse].readPosition = 0;
-                ch.grains[grainToUse].amplitude = 1.0f;
-                ch.grains[grainToUse].grainSize = ch.windowSamples;
-                ch.isRepeating = false;  // Reset repeat state for new grain
+                grains[grainToUse].active = true;
+                grains[grainToUse].readPosition = 0;
+                grains[grainToUse].amplitude = 1.0f;
+                grains[grainToUse].grainSize = windowSamples;
+                isRepeating = false;  // Reset repeat state for new grain
             }
         }
         
-        // Read from output buffer
-        float outputSample = ch.outputBuffer[ch.outputReadPos];
-        
-        // Add feedback from previous output
-        float wetSignal = outputSample + (ch.feedbackSample * currentFeedbackGain);
-        
-        // Apply soft limiting like original
-        if (std::fabs(wetSignal) > FEEDBACK_HARD_LIMIT)
-        {
-            wetSignal = std::tanh(wetSignal * 0.7f) * 1.4286f;
-        }
-        
-        // Mix with dry signal
-        float processedSample = inputSample * dryMix + wetSignal * wetMix;
-        
-        // Store output for next sample's feedback
-        ch.feedbackSample = processedSample;
+        writeOutputFrame(channelData, numLanes, i, currentFeedbackGain);
         
-        channelData[i] = processedSample;
-        
-        // Update positions
-        ch.delayWritePos = (ch.delayWritePos + 1) % ch.delayLine.size();
-        ch.outputReadPos = (ch.outputReadPos + 1) % ch.outputBuffer.size();
-        ch.outputWritePos = (ch.outputWritePos + 1) % ch.outputBuffer.size();
+        if (++delayWritePos >= bufferLength)
+            delayWritePos = 0;
     }
 }
 
@@ -586,11 +528,11 @@ void ReverseEngine::createWindowFunction(std::vector<float>& window, int length)
     }
 }
 
-float ReverseEngine::getVibratoModulation(Channel& ch)
+float ReverseEngine::getVibratoModulation()
 {
-    ch.vibratoPhase.setTargetValue(ch.vibratoPhase.getTargetValue() + ch.vibratoRate / sampleRate);
-    if (ch.vibratoPhase.getTargetValue() >= 1.0f)
-        ch.vibratoPhase.setCurrentAndTargetValue(ch.vibratoPhase.getTargetValue() - 1.0f);
+    vibratoPhase.setTargetValue(vibratoPhase.getTargetValue() + vibratoRate / sampleRate);
+    if (vibratoPhase.getTargetValue() >= 1.0f)
+        vibratoPhase.setCurrentAndTargetValue(vibratoPhase.getTargetValue() - 1.0f);
     
-    return std::sin(2.0f * juce::MathConstants<float>::pi * ch.vibratoPhase.getNextValue());
-}
\ No newline at end of file
+    return std::sin(2.0f * juce::MathConstants<float>::pi * vibratoPhase.getNextValue());
+}
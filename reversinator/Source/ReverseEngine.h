@@ -35,66 +35,59 @@ private:
     float crossfadeTime = 0.2f; // percentage of window time for crossfade
     float envelopeTime = 0.03f; // envelope time in seconds
     
+    // Grain schedule. All channels share the same parameters, so spawn timing,
+    // read positions and window gains are computed once per frame and applied
+    // to every channel.
     struct Grain
     {
-        std::vector<float> buffer;
         int readPosition = 0;
         int grainSize = 0;
         bool active = false;
         float amplitude = 0.0f;
     };
     
-    struct Channel
-    {
-        // Input delay line
-        std::vector<float> delayLine;
-        int delayWritePos = 0;
-        
-        // Grain system for overlap-add
-        static constexpr int NUM_GRAINS = 4;
-        Grain grains[NUM_GRAINS];
-        int currentGrain = 0;
-        int grainCounter = 0;
-        
-        // Output accumulation buffer
-        std::vector<float> outputBuffer;
-        int outputReadPos = 0;
-        int outputWritePos = 0;
-        
-        // Window function
-        std::vector<float> windowFunction;
-        
-        // Parameters
-        int windowSamples = 0;
-        int hopSize = 0;
-        
-        // For other modes
-        std::vector<float> repeatBuffer;
-        int repeatPosition = 0;
-        bool isRepeating = false;
-        
-        float feedbackSample = 0.0f;
-        float crossfadePosition = 0.0f;
-        bool crossfadeDirection = true;
-        
-        // Feedback parameter smoothing
-        juce::SmoothedValue<float> feedbackGainSmoothed;
-        
-        juce::SmoothedValue<float> vibratoPhase;
-        float vibratoRate = 5.0f;
-        
-        // For preventing feedback loops in Forward Backwards mode
-        int grainSpawnOffset = 0;
-    };
+    static constexpr int NUM_GRAINS = 4;
+    Grain grains[NUM_GRAINS];
+    int grainCounter = 0;
+    
+    int windowSamples = 0;
+    int hopSize = 0;
+    int bufferLength = 0; // delay line and output buffer length in frames (2x window)
+    
+    int delayWritePos = 0;
+    int outputReadPos = 0;
+    int outputWritePos = 0;
+    
+    bool isRepeating = false;
+    
+    // For preventing feedback loops in Forward Backwards mode
+    int grainSpawnOffset = 0;
+    
+    // Feedback parameter smoothing
+    juce::SmoothedValue<float> feedbackGainSmoothed;
+    
+    juce::SmoothedValue<float> vibratoPhase;
+    float vibratoRate = 5.0f;
+    
+    std::vector<float> windowFunction;
+    
+    // Per-channel sample data, frame-interleaved: index = frame * numChannels + channel
+    std::vector<float> delayLine;
+    std::vector<float> outputBuffer;
+    std::vector<float> grainBuffers[NUM_GRAINS];
+    std::vector<float> feedbackSamples;
     
-    std::vector<std::unique_ptr<Channel>> channels;
+    void processReversePlayback(float* const* channelData, int numLanes, int numSamples);
+    void processForwardBackwards(float* const* channelData, int numLanes, int numSamples);
+    void processReverseRepeat(float* const* channelData, int numLanes, int numSamples);
     
-    void processReversePlayback(Channel& ch, float* channelData, int numSamples);
-    void processForwardBackwards(Channel& ch, float* channelData, int numSamples);
-    void processReverseRepeat(Channel& ch, float* channelData, int numSamples);
+    void resizeBuffers();
+    void spawnGrain(int grainIndex, int delayReadPos);
+    void writeInputFrame(float* const* channelData, int numLanes, int sampleIndex);
+    void writeOutputFrame(float* const* channelData, int numLanes, int sampleIndex, float feedbackGain);
     
     void createWindowFunction(std::vector<float>& window, int length);
-    float getVibratoModulation(Channel& ch);
+    float getVibratoModulation();
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReverseEngine)
-};
\ No newline at end of file
+};
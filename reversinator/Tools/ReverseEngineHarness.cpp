@@ -0,0 +1,562 @@
+// Offline regression and benchmark harness for ReverseEngine.
+//
+// Renders impulses, sines and noise bursts through every effect mode across a
+// grid of window times, feedback amounts and host block sizes.
+//
+//   ReverseEngineHarness --write <dir>             render and store golden files
+//   ReverseEngineHarness --compare <dir>           render and compare against golden files
+//   ReverseEngineHarness --write-manifest <file>   render and store fingerprints of the goldens
+//   ReverseEngineHarness --check <file>            render and compare against stored fingerprints
+//   ReverseEngineHarness                           benchmark only
+//
+// Options:
+//   --tolerance <value>   maximum absolute sample difference (default 1e-6)
+//   --sample-rate <hz>    render sample rate (default 48000)
+//
+// Every block size is compared against the same golden file, so the harness also
+// checks that output does not depend on how the host splits the stream.
+//
+// The golden renders are too big to commit, so Tools/ReverseEngineGoldens.txt holds
+// fingerprints of them instead, rendered from the original ReverseEngine. --check
+// compares against those within limits derived from --tolerance; --write and
+// --compare are for a full sample-by-sample comparison around a change.
+
+#include <JuceHeader.h>
+#include "ReverseEngine.h"
+
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <map>
+
+namespace
+{
+    constexpr int numChannels = 2;
+
+    enum class Signal
+    {
+        Impulse,
+        Sine,
+        NoiseBurst
+    };
+
+    const char* signalName(Signal signal)
+    {
+        switch (signal)
+        {
+            case Signal::Impulse:    return "impulse";
+            case Signal::Sine:       return "sine";
+            case Signal::NoiseBurst: return "noise";
+        }
+
+        return "";
+    }
+
+    const char* modeName(int mode)
+    {
+        switch (mode)
+        {
+            case ReverseEngine::ReversePlayback:  return "reverse";
+            case ReverseEngine::ForwardBackwards: return "fwdback";
+            case ReverseEngine::ReverseRepeat:    return "repeat";
+        }
+
+        return "";
+    }
+
+    struct RenderCase
+    {
+        Signal signal;
+        int mode;
+        float windowSeconds;
+        float feedback;
+
+        juce::String getName() const
+        {
+            return juce::String(signalName(signal)) + "_" + modeName(mode)
+                 + "_w" + juce::String(juce::roundToInt(windowSeconds * 1000.0f))
+                 + "_fb" + juce::String(juce::roundToInt(feedback * 100.0f));
+        }
+    };
+
+    struct RenderStats
+    {
+        double totalNanoseconds = 0.0;
+        double worstBlockNanoseconds = 0.0;
+        juce::int64 numSamples = 0;
+    };
+
+    // Left and right carry different material so channel crosstalk shows up in the diff
+    juce::AudioBuffer<float> createInput(Signal signal, double sampleRate, int numSamples)
+    {
+        juce::AudioBuffer<float> input(numChannels, numSamples);
+        input.clear();
+
+        switch (signal)
+        {
+            case Signal::Impulse:
+            {
+                const int spacing = static_cast<int>(sampleRate * 0.5);
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = ch * spacing / 4; i < numSamples; i += spacing)
+                        input.setSample(ch, i, ch == 0 ? 1.0f : -0.5f);
+                break;
+            }
+
+            case Signal::Sine:
+            {
+                const double frequencies[numChannels] = { 440.0, 554.37 };
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    auto* data = input.getWritePointer(ch);
+                    const double increment = juce::MathConstants<double>::twoPi * frequencies[ch] / sampleRate;
+                    for (int i = 0; i < numSamples; ++i)
+                        data[i] = 0.5f * static_cast<float>(std::sin(increment * i));
+                }
+                break;
+            }
+
+            case Signal::NoiseBurst:
+            {
+                // 50ms bursts every 400ms, fixed seed so renders are reproducible
+                juce::Random random(0x5eed);
+                const int period = static_cast<int>(sampleRate * 0.4);
+                const int burstLength = static_cast<int>(sampleRate * 0.05);
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    auto* data = input.getWritePointer(ch);
+                    for (int i = 0; i < numSamples; ++i)
+                        if ((i + ch * period / 3) % period < burstLength)
+                            data[i] = random.nextFloat() * 1.6f - 0.8f;
+                }
+                break;
+            }
+        }
+
+        return input;
+    }
+
+    juce::AudioBuffer<float> render(const RenderCase& renderCase, const juce::AudioBuffer<float>& input,
+                                    double sampleRate, int blockSize, RenderStats& stats)
+    {
+        const int numSamples = input.getNumSamples();
+        const float wetMix = 1.0f;
+        const float dryMix = 0.0f;
+
+        ReverseEngine engine;
+        engine.setParameters(renderCase.windowSeconds, renderCase.feedback, wetMix, dryMix, renderCase.mode);
+        engine.prepare(sampleRate, blockSize, numChannels);
+
+        juce::AudioBuffer<float> output;
+        output.makeCopyOf(input);
+
+        juce::AudioBuffer<float> block(numChannels, blockSize);
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const int blockLength = std::min(blockSize, numSamples - start);
+            block.setSize(numChannels, blockLength, false, false, true);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                block.copyFrom(ch, 0, output, ch, start, blockLength);
+
+            // Parameters are pushed every block, as the processor does
+            const auto blockStart = std::chrono::high_resolution_clock::now();
+            engine.setParameters(renderCase.windowSeconds, renderCase.feedback, wetMix, dryMix, renderCase.mode);
+            engine.process(block);
+            const auto blockEnd = std::chrono::high_resolution_clock::now();
+
+            const double elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(blockEnd - blockStart).count());
+            stats.totalNanoseconds += elapsed;
+            stats.worstBlockNanoseconds = std::max(stats.worstBlockNanoseconds, elapsed);
+            stats.numSamples += blockLength;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                output.copyFrom(ch, start, block, ch, 0, blockLength);
+        }
+
+        return output;
+    }
+
+    bool writeGolden(const juce::File& file, const juce::AudioBuffer<float>& audio, double sampleRate)
+    {
+        file.deleteFile();
+        std::unique_ptr<juce::OutputStream> stream = file.createOutputStream();
+
+        if (stream == nullptr)
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate,
+                                                                            static_cast<unsigned int>(audio.getNumChannels()),
+                                                                            32, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release(); // owned by the writer now
+        return writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+    }
+
+    bool readGolden(const juce::File& file, juce::AudioBuffer<float>& audio)
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(file.createInputStream().release(), true));
+
+        if (reader == nullptr)
+            return false;
+
+        audio.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+        return reader->read(&audio, 0, audio.getNumSamples(), 0, true, true);
+    }
+
+    float maxAbsDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+            return std::numeric_limits<float>::infinity();
+
+        float maxDiff = 0.0f;
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+        {
+            const float* x = a.getReadPointer(ch);
+            const float* y = b.getReadPointer(ch);
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                maxDiff = std::max(maxDiff, std::abs(x[i] - y[i]));
+        }
+
+        return maxDiff;
+    }
+
+    // Per channel and per segment of a render: the sum, sum of squares, position-weighted
+    // sum and peak. A gain change moves the first two, a shift of even one sample moves
+    // the weighted sum, and a click moves the peak.
+    struct Fingerprint
+    {
+        static constexpr int segmentLength = 8192;
+
+        enum Stat { sum, sumOfSquares, weightedSum, peak, numStats };
+
+        int numChannels = 0;
+        int numSamples = 0;
+        std::vector<double> stats; // [channel][segment][stat]
+
+        int getNumSegments() const { return (numSamples + segmentLength - 1) / segmentLength; }
+
+        double get(int channel, int segment, Stat stat) const
+        {
+            return stats[static_cast<size_t>((channel * getNumSegments() + segment) * numStats + stat)];
+        }
+    };
+
+    Fingerprint createFingerprint(const juce::AudioBuffer<float>& audio)
+    {
+        Fingerprint fingerprint;
+        fingerprint.numChannels = audio.getNumChannels();
+        fingerprint.numSamples = audio.getNumSamples();
+
+        for (int ch = 0; ch < fingerprint.numChannels; ++ch)
+        {
+            const float* data = audio.getReadPointer(ch);
+
+            for (int start = 0; start < fingerprint.numSamples; start += Fingerprint::segmentLength)
+            {
+                const int length = std::min(Fingerprint::segmentLength, fingerprint.numSamples - start);
+                double segment[Fingerprint::numStats] = {};
+
+                for (int i = 0; i < length; ++i)
+                {
+                    const double x = data[start + i];
+                    segment[Fingerprint::sum] += x;
+                    segment[Fingerprint::sumOfSquares] += x * x;
+                    segment[Fingerprint::weightedSum] += x * (i + 1) / length;
+                    segment[Fingerprint::peak] = std::max(segment[Fingerprint::peak], std::abs(x));
+                }
+
+                fingerprint.stats.insert(fingerprint.stats.end(), std::begin(segment), std::end(segment));
+            }
+        }
+
+        return fingerprint;
+    }
+
+    // One manifest line: name, channels, samples, then the stats
+    juce::String toManifestLine(const juce::String& name, const Fingerprint& fingerprint)
+    {
+        juce::String line = name + " " + juce::String(fingerprint.numChannels) + " " + juce::String(fingerprint.numSamples);
+
+        for (auto value : fingerprint.stats)
+            line << " " << juce::String(value, 10, true);
+
+        return line;
+    }
+
+    // Returns false if the file can't be read or the sample rate doesn't match
+    bool readManifest(const juce::File& file, double sampleRate, std::map<juce::String, Fingerprint>& manifest)
+    {
+        if (! file.existsAsFile())
+            return false;
+
+        juce::StringArray lines;
+        lines.addLines(file.loadFileAsString());
+        bool sampleRateMatches = false;
+
+        for (const auto& line : lines)
+        {
+            juce::StringArray tokens;
+            tokens.addTokens(line, " ", {});
+            tokens.removeEmptyStrings();
+
+            if (tokens.isEmpty() || tokens[0].startsWith("#"))
+                continue;
+
+            if (tokens[0] == "sample-rate")
+            {
+                sampleRateMatches = tokens[1].getDoubleValue() == sampleRate;
+                continue;
+            }
+
+            Fingerprint fingerprint;
+            fingerprint.numChannels = tokens[1].getIntValue();
+            fingerprint.numSamples = tokens[2].getIntValue();
+
+            for (int i = 3; i < tokens.size(); ++i)
+                fingerprint.stats.push_back(tokens[i].getDoubleValue());
+
+            if (fingerprint.stats.size() == static_cast<size_t>(fingerprint.numChannels * fingerprint.getNumSegments() * Fingerprint::numStats))
+                manifest[tokens[0]] = std::move(fingerprint);
+        }
+
+        return sampleRateMatches;
+    }
+
+    // The furthest any stat is outside what a per-sample difference of tolerance allows,
+    // as a multiple of that allowance (so above 1 is a failure), and where it is
+    double compareFingerprints(const Fingerprint& expected, const Fingerprint& actual, float tolerance,
+                               int& worstChannel, int& worstSegment)
+    {
+        worstChannel = worstSegment = 0;
+
+        if (expected.numChannels != actual.numChannels || expected.numSamples != actual.numSamples)
+            return std::numeric_limits<double>::infinity();
+
+        double worst = 0.0;
+
+        for (int ch = 0; ch < expected.numChannels; ++ch)
+        {
+            for (int segment = 0; segment < expected.getNumSegments(); ++segment)
+            {
+                const int length = std::min(Fingerprint::segmentLength, expected.numSamples - segment * Fingerprint::segmentLength);
+                const double peak = expected.get(ch, segment, Fingerprint::peak);
+
+                double allowed[Fingerprint::numStats];
+                allowed[Fingerprint::sum] = tolerance * length;
+                allowed[Fingerprint::sumOfSquares] = tolerance * length * (2.0 * peak + tolerance);
+                allowed[Fingerprint::weightedSum] = tolerance * length;
+                allowed[Fingerprint::peak] = tolerance;
+
+                for (int stat = 0; stat < Fingerprint::numStats; ++stat)
+                {
+                    const double a = expected.get(ch, segment, static_cast<Fingerprint::Stat>(stat));
+                    const double b = actual.get(ch, segment, static_cast<Fingerprint::Stat>(stat));
+
+                    // Plus what rounding to the manifest's precision loses
+                    const double excess = std::abs(a - b) / (allowed[stat] + 1.0e-9 * std::abs(a) + 1.0e-12);
+
+                    if (excess > worst)
+                    {
+                        worst = excess;
+                        worstChannel = ch;
+                        worstSegment = segment;
+                    }
+                }
+            }
+        }
+
+        return worst;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    const bool writeGoldens = args.containsOption("--write");
+    const bool compareGoldens = args.containsOption("--compare");
+    const bool writeManifest = args.containsOption("--write-manifest");
+    const bool checkManifest = args.containsOption("--check");
+    const bool writeMode = writeGoldens || writeManifest;
+    const bool compareMode = compareGoldens || checkManifest;
+    const juce::String goldenPath = writeGoldens ? args.getValueForOption("--write") : args.getValueForOption("--compare");
+    const juce::String manifestPath = writeManifest ? args.getValueForOption("--write-manifest") : args.getValueForOption("--check");
+    const float tolerance = args.containsOption("--tolerance") ? args.getValueForOption("--tolerance").getFloatValue() : 1.0e-6f;
+    const double sampleRate = args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+
+    if (writeMode && compareMode)
+    {
+        std::cerr << "Use either --write/--write-manifest or --compare/--check, not both" << std::endl;
+        return 1;
+    }
+
+    juce::File goldenDir;
+    if (writeGoldens || compareGoldens)
+    {
+        goldenDir = juce::File::getCurrentWorkingDirectory().getChildFile(goldenPath);
+
+        if (writeGoldens && ! goldenDir.createDirectory())
+        {
+            std::cerr << "Cannot create " << goldenDir.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    juce::File manifestFile;
+    std::map<juce::String, Fingerprint> manifest;
+    juce::StringArray manifestLines { "# ReverseEngine golden fingerprints, written by ReverseEngineHarness --write-manifest",
+                                      "sample-rate " + juce::String(sampleRate) };
+
+    if (writeManifest || checkManifest)
+    {
+        manifestFile = juce::File::getCurrentWorkingDirectory().getChildFile(manifestPath);
+
+        if (checkManifest && ! readManifest(manifestFile, sampleRate, manifest))
+        {
+            std::cerr << "Cannot read " << manifestFile.getFullPathName() << " as a manifest for "
+                      << sampleRate << " Hz" << std::endl;
+            return 1;
+        }
+    }
+
+    const Signal signals[] = { Signal::Impulse, Signal::Sine, Signal::NoiseBurst };
+    const int modes[] = { ReverseEngine::ReversePlayback, ReverseEngine::ForwardBackwards, ReverseEngine::ReverseRepeat };
+    const float windowTimes[] = { 0.03f, 0.25f, 1.0f };
+    const float feedbackAmounts[] = { 0.0f, 0.5f, 0.9f };
+    const int blockSizes[] = { 32, 173, 512, 2048 };
+
+    // Per mode and block size timing summary
+    RenderStats modeStats[3][std::size(blockSizes)];
+    int numFailures = 0;
+    int numCases = 0;
+
+    for (auto signal : signals)
+    {
+        for (auto windowSeconds : windowTimes)
+        {
+            // Long enough for the reversed grains and several feedback passes to play out
+            const int numSamples = static_cast<int>(sampleRate * (windowSeconds * 4.0f + 1.0f));
+            const auto input = createInput(signal, sampleRate, numSamples);
+
+            for (auto mode : modes)
+            {
+                for (auto feedback : feedbackAmounts)
+                {
+                    const RenderCase renderCase { signal, mode, windowSeconds, feedback };
+                    const auto file = goldenDir.getChildFile(renderCase.getName() + ".wav");
+                    const auto expected = manifest.find(renderCase.getName());
+
+                    // In write mode the first block size becomes the reference for the others
+                    juce::AudioBuffer<float> reference;
+                    if ((compareGoldens && ! readGolden(file, reference)) || (checkManifest && expected == manifest.end()))
+                    {
+                        std::cerr << "MISSING " << renderCase.getName() << std::endl;
+                        numCases += static_cast<int>(std::size(blockSizes));
+                        numFailures += static_cast<int>(std::size(blockSizes));
+                        continue;
+                    }
+
+                    for (size_t b = 0; b < std::size(blockSizes); ++b)
+                    {
+                        auto output = render(renderCase, input, sampleRate, blockSizes[b], modeStats[mode][b]);
+                        ++numCases;
+
+                        if (writeMode && b == 0)
+                        {
+                            if (writeGoldens && ! writeGolden(file, output, sampleRate))
+                            {
+                                std::cerr << "Cannot write " << file.getFullPathName() << std::endl;
+                                return 1;
+                            }
+
+                            if (writeManifest)
+                                manifestLines.add(toManifestLine(renderCase.getName(), createFingerprint(output)));
+
+                            reference = std::move(output);
+                            continue;
+                        }
+
+                        bool failed = false;
+
+                        if (writeMode || compareGoldens)
+                        {
+                            const float diff = maxAbsDifference(reference, output);
+                            if (diff > tolerance)
+                            {
+                                std::cerr << "FAIL " << renderCase.getName() << " block " << blockSizes[b]
+                                          << " max diff " << diff << std::endl;
+                                failed = true;
+                            }
+                        }
+
+                        if (checkManifest)
+                        {
+                            int channel, segment;
+                            const double excess = compareFingerprints(expected->second, createFingerprint(output), tolerance, channel, segment);
+                            if (excess > 1.0)
+                            {
+                                std::cerr << "FAIL " << renderCase.getName() << " block " << blockSizes[b]
+                                          << " differs from the manifest in channel " << channel << " near "
+                                          << juce::String(segment * Fingerprint::segmentLength / sampleRate, 2) << " s ("
+                                          << juce::String(excess, 1) << "x the allowed difference)" << std::endl;
+                                failed = true;
+                            }
+                        }
+
+                        if (failed)
+                            ++numFailures;
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << std::endl << "ReverseEngine benchmark (" << numChannels << " channels, "
+              << sampleRate << " Hz)" << std::endl;
+
+    for (auto mode : modes)
+    {
+        for (size_t b = 0; b < std::size(blockSizes); ++b)
+        {
+            const auto& stats = modeStats[mode][b];
+            const double nsPerSample = stats.totalNanoseconds / static_cast<double>(juce::jmax<juce::int64>(1, stats.numSamples));
+            const double blockBudgetNs = 1.0e9 * blockSizes[b] / sampleRate;
+
+            std::cout << juce::String(modeName(mode)).paddedRight(' ', 10)
+                      << " block " << juce::String(blockSizes[b]).paddedLeft(' ', 5)
+                      << "  " << juce::String(nsPerSample, 2).paddedLeft(' ', 8) << " ns/sample"
+                      << "  worst block " << juce::String(stats.worstBlockNanoseconds / 1000.0, 1).paddedLeft(' ', 9) << " us"
+                      << " (" << juce::String(100.0 * stats.worstBlockNanoseconds / blockBudgetNs, 2) << "% of budget)"
+                      << std::endl;
+        }
+    }
+
+    if (writeGoldens)
+        std::cout << std::endl << "Wrote golden files to " << goldenDir.getFullPathName() << std::endl;
+
+    if (writeManifest)
+    {
+        if (! manifestFile.replaceWithText(manifestLines.joinIntoString("\n") + "\n"))
+        {
+            std::cerr << "Cannot write " << manifestFile.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        std::cout << std::endl << "Wrote fingerprints to " << manifestFile.getFullPathName() << std::endl;
+    }
+
+    if (writeMode || compareMode)
+    {
+        std::cout << std::endl << (numCases - numFailures) << "/" << numCases << " renders within tolerance "
+                  << tolerance << std::endl;
+        return numFailures == 0 ? 0 : 1;
+    }
+
+    return 0;
+}
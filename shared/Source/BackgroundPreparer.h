@@ -0,0 +1,69 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+
+/**
+    Runs the heavy part of a processor's preparation (large allocations, building
+    and priming engines) on a background thread, so prepareToPlay() returns at
+    once. Hosts prepare every plugin they scan or load with a session, and many
+    of those instances never get as far as processing audio.
+
+    The audio thread checks isReady() at the top of each block and passes audio
+    through untouched until the job has finished; nothing the job sets up may be
+    touched before then. Offline renders can't afford the dry blocks, so they
+    wait for the job with waitUntilReady() instead.
+
+    start() and cancel() belong with prepareToPlay() and releaseResources(). Both
+    wait for a job already in flight, since a half-built engine can't be dropped
+    part way through.
+*/
+class BackgroundPreparer : private juce::Thread
+{
+public:
+    explicit BackgroundPreparer(const juce::String& threadName) : juce::Thread(threadName) {}
+    ~BackgroundPreparer() override  { cancel(); }
+
+    /** Replaces any previous preparation with newJob, run on the background thread. */
+    void start(std::function<void()> newJob)
+    {
+        cancel();
+        job = std::move(newJob);
+        startThread();
+    }
+
+    /** Waits for a job in flight, then leaves the processor unprepared. */
+    void cancel()
+    {
+        stopThread(-1);
+        job = nullptr;
+        finished.reset();
+        ready.store(false, std::memory_order_release);
+    }
+
+    /** True once the job has finished; everything it wrote is visible from then on. */
+    bool isReady() const noexcept   { return ready.load(std::memory_order_acquire); }
+
+    /** Blocks until the job has finished, or timeoutMs has gone by. Not for realtime callbacks. */
+    bool waitUntilReady(int timeoutMs = -1)
+    {
+        return isReady() || (finished.wait(timeoutMs) && isReady());
+    }
+
+private:
+    void run() override
+    {
+        if (job != nullptr)
+            job();
+
+        ready.store(true, std::memory_order_release);
+        finished.signal();
+    }
+
+    std::function<void()> job;
+    juce::WaitableEvent finished { true };
+    std::atomic<bool> ready { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BackgroundPreparer)
+};
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+/**
+    Multi-channel circular buffer with a power-of-two capacity.
+
+    Positions wrap with a bit mask rather than a modulo, so callers can keep
+    free-running or loosely wrapped read/write positions and let the buffer fold
+    them back into range (negative positions work too). Bulk reads and writes are
+    split at the wrap point into at most two contiguous copies.
+
+    With mirrored storage every sample is also written one capacity further on,
+    so any run of up to getCapacity() samples can be read through a single
+    pointer. This is useful for interpolators that need a few neighbouring
+    samples around an arbitrary position.
+
+    setSize() allocates and must not be called on the audio thread. Everything
+    else is allocation free.
+*/
+template <typename SampleType>
+class RingBuffer
+{
+public:
+    RingBuffer() = default;
+
+    /** Allocates at least minimumCapacity samples per channel, rounded up to a power of two. */
+    void setSize(int newNumChannels, int minimumCapacity, bool shouldMirror = false)
+    {
+        numChannels = juce::jmax(0, newNumChannels);
+        capacity = juce::nextPowerOfTwo(juce::jmax(1, minimumCapacity));
+        mask = capacity - 1;
+        mirrored = shouldMirror;
+        stride = mirrored ? capacity * 2 : capacity;
+
+        storage.assign(static_cast<size_t>(numChannels) * static_cast<size_t>(stride), SampleType());
+    }
+
+    void clear() noexcept
+    {
+        std::fill(storage.begin(), storage.end(), SampleType());
+    }
+
+    int getNumChannels() const noexcept     { return numChannels; }
+    int getCapacity() const noexcept        { return capacity; }
+    bool isMirrored() const noexcept        { return mirrored; }
+
+    /** Folds any position, including negative ones, into [0, capacity). */
+    int wrap(int position) const noexcept   { return position & mask; }
+
+    SampleType* getWritePointer(int channel) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(channel, numChannels));
+        return storage.data() + static_cast<size_t>(channel) * static_cast<size_t>(stride);
+    }
+
+    const SampleType* getReadPointer(int channel) const noexcept
+    {
+        jassert(juce::isPositiveAndBelow(channel, numChannels));
+        return storage.data() + static_cast<size_t>(channel) * static_cast<size_t>(stride);
+    }
+
+    SampleType getSample(int channel, int position) const noexcept
+    {
+        return getReadPointer(channel)[wrap(position)];
+    }
+
+    void setSample(int channel, int position, SampleType value) noexcept
+    {
+        auto* data = getWritePointer(channel);
+        const int index = wrap(position);
+
+        data[index] = value;
+
+        if (mirrored)
+            data[index + capacity] = value;
+    }
+
+    /** Copies numSamples from source into the buffer starting at position.
+        If numSamples exceeds the capacity only the most recent samples are kept.
+    */
+    void write(int channel, int position, const SampleType* source, int numSamples) noexcept
+    {
+        if (numSamples > capacity)
+        {
+            const int skipped = numSamples - capacity;
+            source += skipped;
+            position += skipped;
+            numSamples = capacity;
+        }
+
+        auto* data = getWritePointer(channel);
+        const int start = wrap(position);
+        const int firstPart = juce::jmin(numSamples, capacity - start);
+
+        std::copy(source, source + firstPart, data + start);
+        std::copy(source + firstPart, source + numSamples, data);
+
+        if (mirrored)
+        {
+            std::copy(source, source + firstPart, data + start + capacity);
+            std::copy(source + firstPart, source + numSamples, data + capacity);
+        }
+    }
+
+    /** Copies numSamples starting at position out of the buffer (numSamples <= capacity). */
+    void read(int channel, int position, SampleType* dest, int numSamples) const noexcept
+    {
+        jassert(numSamples <= capacity);
+
+        const auto* data = getReadPointer(channel);
+        const int start = wrap(position);
+
+        if (mirrored)
+        {
+            std::copy(data + start, data + start + numSamples, dest);
+            return;
+        }
+
+        const int firstPart = juce::jmin(numSamples, capacity - start);
+
+        std::copy(data + start, data + start + firstPart, dest);
+        std::copy(data, data + (numSamples - firstPart), dest + firstPart);
+    }
+
+    /** Zeroes numSamples starting at position (numSamples <= capacity). */
+    void clear(int channel, int position, int numSamples) noexcept
+    {
+        jassert(numSamples <= capacity);
+
+        auto* data = getWritePointer(channel);
+        const int start = wrap(position);
+        const int firstPart = juce::jmin(numSamples, capacity - start);
+
+        std::fill(data + start, data + start + firstPart, SampleType());
+        std::fill(data, data + (numSamples - firstPart), SampleType());
+
+        if (mirrored)
+        {
+            std::fill(data + start + capacity, data + start + capacity + firstPart, SampleType());
+            std::fill(data + capacity, data + capacity + (numSamples - firstPart), SampleType());
+        }
+    }
+
+    /** Returns a pointer to getCapacity() contiguous samples starting at position.
+        Only valid with mirrored storage.
+    */
+    const SampleType* getContiguousReadPointer(int channel, int position) const noexcept
+    {
+        jassert(mirrored);
+        return getReadPointer(channel) + wrap(position);
+    }
+
+private:
+    std::vector<SampleType> storage;
+    int numChannels = 0;
+    int capacity = 0;
+    int mask = 0;
+    int stride = 0;
+    bool mirrored = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RingBuffer)
+};
+
+/**
+    Lock-free single-producer/single-consumer FIFO built on RingBuffer.
+
+    The read and write counters run freely and are only masked on access, so the
+    fill level is simply their difference. The producer publishes with a release
+    store after copying samples in, and the consumer acquires before copying out,
+    so one thread may push while another pops without locks.
+
+    setSize() and reset() must only be called while neither side is running.
+*/
+template <typename SampleType>
+class SpscRingBuffer
+{
+public:
+    SpscRingBuffer() = default;
+
+    void setSize(int numChannels, int minimumCapacity)
+    {
+        buffer.setSize(numChannels, minimumCapacity);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        buffer.clear();
+        writeCount.store(0, std::memory_order_relaxed);
+        readCount.store(0, std::memory_order_relaxed);
+    }
+
+    int getNumChannels() const noexcept     { return buffer.getNumChannels(); }
+    int getCapacity() const noexcept        { return buffer.getCapacity(); }
+
+    /** Number of samples the consumer can pop. */
+    int getNumReady() const noexcept
+    {
+        return static_cast<int>(writeCount.load(std::memory_order_acquire) - readCount.load(std::memory_order_relaxed));
+    }
+
+    /** Number of samples the producer can push without overwriting unread data. */
+    int getFreeSpace() const noexcept
+    {
+        return buffer.getCapacity() - static_cast<int>(writeCount.load(std::memory_order_relaxed) - readCount.load(std::memory_order_acquire));
+    }
+
+    /** Producer side. Pushes up to numSamples per channel and returns how many fitted. */
+    int push(const SampleType* const* source, int numSourceChannels, int numSamples) noexcept
+    {
+        const int toWrite = juce::jmin(numSamples, getFreeSpace());
+
+        if (toWrite <= 0)
+            return 0;
+
+        const auto position = static_cast<int>(writeCount.load(std::memory_order_relaxed));
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            if (ch < numSourceChannels)
+                buffer.write(ch, position, source[ch], toWrite);
+            else
+                buffer.clear(ch, position, toWrite);
+        }
+
+        writeCount.fetch_add(static_cast<juce::uint32>(toWrite), std::memory_order_release);
+        return toWrite;
+    }
+
+    /** Consumer side. Pops up to numSamples per channel and returns how many were read. */
+    int pop(SampleType* const* dest, int numDestChannels, int numSamples) noexcept
+    {
+        const int toRead = juce::jmin(numSamples, getNumReady());
+
+        if (toRead <= 0)
+            return 0;
+
+        const auto position = static_cast<int>(readCount.load(std::memory_order_relaxed));
+
+        for (int ch = 0; ch < juce::jmin(numDestChannels, buffer.getNumChannels()); ++ch)
+            buffer.read(ch, position, dest[ch], toRead);
+
+        readCount.fetch_add(static_cast<juce::uint32>(toRead), std::memory_order_release);
+        return toRead;
+    }
+
+    /** Consumer side. Discards up to numSamples and returns how many were dropped. */
+    int skip(int numSamples) noexcept
+    {
+        const int toSkip = juce::jmin(numSamples, getNumReady());
+
+        if (toSkip > 0)
+            readCount.fetch_add(static_cast<juce::uint32>(toSkip), std::memory_order_release);
+
+        return juce::jmax(0, toSkip);
+    }
+
+private:
+    RingBuffer<SampleType> buffer;
+    std::atomic<juce::uint32> writeCount { 0 };
+    std::atomic<juce::uint32> readCount { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpscRingBuffer)
+};
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+/**
+    Opt-in capture of everything a processor is fed, so a session that glitched
+    on a client's machine can be replayed on the bench (tools/SessionReplay).
+
+    Nothing is recorded unless the SAMMYJS_CAPTURE_DIR environment variable names
+    a directory. Then each prepare() starts a new .sjcap file there holding the
+    sample rate, block size, channel count and parameter names, followed block by
+    block by the input audio and whichever parameters changed since the block
+    before.
+
+    recordBlock() copies the block into a lock-free FIFO, and a writer thread
+    drains that to disk, so the audio thread never waits on the file. If the disk
+    falls behind, blocks that don't fit are dropped and a gap of the same length
+    is written in their place.
+
+    prepare() and stop() are for when audio is stopped (prepareToPlay and
+    releaseResources); recordBlock() is for the audio thread.
+*/
+class SessionRecorder : private juce::Thread
+{
+public:
+    static constexpr const char* captureDirectoryVariable = "SAMMYJS_CAPTURE_DIR";
+    static constexpr const char* fileExtension = ".sjcap";
+
+    /** What a capture starts with. */
+    struct Header
+    {
+        juce::String pluginName;
+        double sampleRate = 0.0;
+        int maxBlockSize = 0;
+        int numChannels = 0;
+        juce::StringArray parameterNames;
+
+        void write(juce::OutputStream& output) const
+        {
+            output.writeInt(static_cast<int>(magic));
+            output.writeInt(formatVersion);
+            output.writeString(pluginName);
+            output.writeDouble(sampleRate);
+            output.writeInt(maxBlockSize);
+            output.writeInt(numChannels);
+            output.writeInt(parameterNames.size());
+
+            for (const auto& name : parameterNames)
+                output.writeString(name);
+        }
+
+        /** False if the stream isn't a capture this version can read. */
+        bool read(juce::InputStream& input)
+        {
+            if (static_cast<juce::uint32>(input.readInt()) != magic || input.readInt() != formatVersion)
+                return false;
+
+            pluginName = input.readString();
+            sampleRate = input.readDouble();
+            maxBlockSize = input.readInt();
+            numChannels = input.readInt();
+
+            const int numParameters = input.readInt();
+            parameterNames.clear();
+
+            for (int i = 0; i < numParameters && ! input.isExhausted(); ++i)
+                parameterNames.add(input.readString());
+
+            return sampleRate > 0.0 && maxBlockSize > 0 && numChannels > 0 && parameterNames.size() == numParameters;
+        }
+    };
+
+    /** One recorded block, or a gap where blocks were dropped. */
+    struct Block
+    {
+        int numSamples = 0;     // Of audio; 0 for a gap
+        int gapSamples = 0;     // Dropped while the disk caught up
+        std::vector<std::pair<int, float>> parameterChanges;
+        juce::AudioBuffer<float> audio;
+
+        /** False at the end of the capture, or where it was cut off. */
+        bool read(juce::InputStream& input, int numChannels)
+        {
+            if (input.getNumBytesRemaining() < 8)
+                return false;
+
+            const int length = input.readInt();
+            const int numChanges = input.readInt();
+
+            numSamples = juce::jmax(0, length);
+            gapSamples = juce::jmax(0, -length);
+
+            parameterChanges.clear();
+
+            if (numChanges < 0 || input.getNumBytesRemaining() < static_cast<juce::int64>(numChanges) * 8)
+                return false;
+
+            for (int i = 0; i < numChanges; ++i)
+            {
+                const int index = input.readInt();
+                parameterChanges.emplace_back(index, input.readFloat());
+            }
+
+            audio.setSize(numChannels, numSamples, false, false, true);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                if (input.read(audio.getWritePointer(channel), static_cast<int>(sizeof(float)) * numSamples) != static_cast<int>(sizeof(float)) * numSamples)
+                    return false;
+
+            return true;
+        }
+    };
+
+    SessionRecorder() : juce::Thread("Session Recorder") {}
+    ~SessionRecorder() override  { stop(); }
+
+    /** Finishes any capture in progress, and starts a new one if capturing is switched on. */
+    void prepare(juce::AudioProcessor& processor, double sampleRate, int maxBlockSize)
+    {
+        stop();
+
+        const auto directoryPath = juce::SystemStats::getEnvironmentVariable(captureDirectoryVariable, {});
+
+        if (directoryPath.isEmpty() || ! juce::File::isAbsolutePath(directoryPath))
+            return;
+
+        const juce::File directory(directoryPath);
+
+        if (directory.createDirectory().failed())
+            return;
+
+        const auto fileName = processor.getName().removeCharacters(" ") + "_"
+                            + juce::Time::getCurrentTime().formatted("%Y-%m-%d_%H-%M-%S") + fileExtension;
+
+        stream = std::make_unique<juce::FileOutputStream>(directory.getChildFile(fileName).getNonexistentSibling());
+
+        if (stream->failedToOpen())
+        {
+            stream.reset();
+            return;
+        }
+
+        parameters = processor.getParameters();
+
+        Header header;
+        header.pluginName = processor.getName();
+        header.sampleRate = sampleRate;
+        header.maxBlockSize = maxBlockSize;
+        header.numChannels = juce::jmax(1, processor.getTotalNumInputChannels());
+
+        for (auto* parameter : parameters)
+            header.parameterNames.add(parameter->getName(128));
+
+        header.write(*stream);
+        numChannels = header.numChannels;
+
+        // A couple of seconds of input, which rides out a slow disk without much memory
+        const int capacity = static_cast<int>(sampleRate * 2.0) * numChannels * static_cast<int>(sizeof(float))
+                           + 64 * maxBlockSize;
+        storage.assign(static_cast<size_t>(capacity), 0);
+        fifo.setTotalSize(capacity);
+        fifo.reset();
+
+        lastValues.assign(static_cast<size_t>(parameters.size()), std::nanf(""));
+        currentValues.assign(static_cast<size_t>(parameters.size()), 0.0f);
+        changedIndices.assign(static_cast<size_t>(parameters.size()), 0);
+        droppedSamples = 0;
+
+        startThread();
+        recording = true;
+    }
+
+    /** Writes out what's left and closes the file. */
+    void stop()
+    {
+        recording = false;
+        stopThread(-1);
+        stream.reset();
+    }
+
+    bool isRecording() const noexcept   { return recording; }
+
+    /** Call at the top of processBlock() with the input, before anything touches it. */
+    void recordBlock(const juce::AudioBuffer<float>& buffer) noexcept
+    {
+        if (! recording)
+            return;
+
+        const int numSamples = buffer.getNumSamples();
+        int numChanged = 0;
+
+        for (int i = 0; i < parameters.size(); ++i)
+        {
+            const auto index = static_cast<size_t>(i);
+            currentValues[index] = parameters.getUnchecked(i)->getValue();
+
+            if (currentValues[index] != lastValues[index])
+                changedIndices[static_cast<size_t>(numChanged++)] = i;
+        }
+
+        const int gapBytes = droppedSamples > 0 ? 2 * static_cast<int>(sizeof(juce::int32)) : 0;
+        const int blockBytes = 2 * static_cast<int>(sizeof(juce::int32))
+                             + numChanged * static_cast<int>(sizeof(juce::int32) + sizeof(float))
+                             + numChannels * numSamples * static_cast<int>(sizeof(float));
+
+        if (fifo.getFreeSpace() < gapBytes + blockBytes)
+        {
+            droppedSamples = juce::jmin(droppedSamples + numSamples, maxGapSamples);
+            return;
+        }
+
+        fifo.prepareToWrite(gapBytes + blockBytes, reservedStart1, reservedSize1, reservedStart2, reservedSize2);
+        int offset = 0;
+
+        if (gapBytes > 0)
+        {
+            putInt(offset, -droppedSamples);
+            putInt(offset, 0);
+            droppedSamples = 0;
+        }
+
+        putInt(offset, numSamples);
+        putInt(offset, numChanged);
+
+        for (int i = 0; i < numChanged; ++i)
+        {
+            const auto index = static_cast<size_t>(changedIndices[static_cast<size_t>(i)]);
+            putInt(offset, changedIndices[static_cast<size_t>(i)]);
+            put(offset, &currentValues[index], sizeof(float));
+            lastValues[index] = currentValues[index];
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            if (channel < buffer.getNumChannels())
+                put(offset, buffer.getReadPointer(channel), sizeof(float) * static_cast<size_t>(numSamples));
+            else
+                putSilence(offset, sizeof(float) * static_cast<size_t>(numSamples));
+        }
+
+        fifo.finishedWrite(offset);
+    }
+
+private:
+    static constexpr juce::uint32 magic = 0x50434a53;  // "SJCP"
+    static constexpr int formatVersion = 1;
+    static constexpr int maxGapSamples = 1 << 30;
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            drain();
+            wait(20);
+        }
+
+        drain();
+        stream->flush();
+    }
+
+    void drain()
+    {
+        int readStart1, readSize1, readStart2, readSize2;
+        fifo.prepareToRead(fifo.getNumReady(), readStart1, readSize1, readStart2, readSize2);
+
+        stream->write(storage.data() + readStart1, static_cast<size_t>(readSize1));
+        stream->write(storage.data() + readStart2, static_cast<size_t>(readSize2));
+
+        fifo.finishedRead(readSize1 + readSize2);
+    }
+
+    // Copies into the region reserved by prepareToWrite(), across the wrap if need be.
+    // The FIFO holds the file's bytes as they are, in the machine's (little-endian) order.
+    void put(int& offset, const void* data, size_t numBytes) noexcept
+    {
+        const auto* bytes = static_cast<const char*>(data);
+        const int total = static_cast<int>(numBytes);
+        const int first = juce::jlimit(0, total, reservedSize1 - offset);
+
+        if (first > 0)
+            std::memcpy(storage.data() + reservedStart1 + offset, bytes, static_cast<size_t>(first));
+
+        if (total > first)
+            std::memcpy(storage.data() + reservedStart2 + offset + first - reservedSize1, bytes + first, static_cast<size_t>(total - first));
+
+        offset += total;
+    }
+
+    void putInt(int& offset, juce::int32 value) noexcept   { put(offset, &value, sizeof(value)); }
+
+    void putSilence(int& offset, size_t numBytes) noexcept
+    {
+        static constexpr float zeros[256] {};
+
+        for (size_t done = 0; done < numBytes; done += sizeof(zeros))
+            put(offset, zeros, juce::jmin(sizeof(zeros), numBytes - done));
+    }
+
+    std::unique_ptr<juce::FileOutputStream> stream;
+    juce::Array<juce::AudioProcessorParameter*> parameters;
+    int numChannels = 0;
+    bool recording = false;
+
+    std::vector<char> storage;
+    juce::AbstractFifo fifo { 1 };
+    int reservedStart1 = 0, reservedSize1 = 0, reservedStart2 = 0, reservedSize2 = 0;
+
+    std::vector<float> lastValues;
+    std::vector<float> currentValues;
+    std::vector<int> changedIndices;
+    int droppedSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionRecorder)
+};
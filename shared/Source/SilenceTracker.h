@@ -0,0 +1,98 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+/**
+    Decides when a processor can stop working on silence.
+
+    A block can be skipped once the input has stayed under the floor for longer
+    than the processor's tail, and everything the processor produced over that
+    time was under it too. By then its state is what processing the silence
+    would have left behind (delay lines, filters and envelopes have run out),
+    so skipped blocks are written as silence and the first block with signal in
+    it is processed as normal, picking up without a click. Requiring silent
+    output as well covers feedback and resonances that outlast the nominal tail.
+
+    The checks are a peak scan per channel, and the input scan stops at the
+    first channel with signal in it.
+
+    Audio thread only, apart from isIdle().
+*/
+class SilenceTracker
+{
+public:
+    static constexpr float defaultFloorDb = -90.0f;
+
+    /** Anything peaking under floorDb counts as silence. */
+    void prepare(float floorDb = defaultFloorDb) noexcept
+    {
+        floor = juce::Decibels::decibelsToGain(floorDb);
+        reset();
+    }
+
+    /** Forgets the silence so far; the next block is processed. */
+    void reset() noexcept
+    {
+        silentInputSamples = 0;
+        silentOutputSamples = 0;
+        idle.store(false, std::memory_order_relaxed);
+    }
+
+    /** How long the output can carry on after the input stops. Cheap enough to follow parameters every block. */
+    void setTailLength(int numSamples) noexcept     { tailSamples = juce::jmax(0, numSamples); }
+
+    /** Call at the top of the block with the input. True when the block can be skipped.
+        settled lets the processor hold off for state the tracker can't see, such as an
+        envelope that has still to finish.
+    */
+    bool canSkipBlock(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples, bool settled = true) noexcept
+    {
+        if (! isSilent(buffer, numChannels, numSamples))
+        {
+            silentInputSamples = 0;
+            idle.store(false, std::memory_order_relaxed);
+            return false;
+        }
+
+        silentInputSamples = addSamples(silentInputSamples, numSamples);
+
+        const bool skip = settled && silentInputSamples > tailSamples && silentOutputSamples > tailSamples;
+        idle.store(skip, std::memory_order_relaxed);
+
+        return skip;
+    }
+
+    /** Call after every block that wasn't skipped, with its output. */
+    void blockProcessed(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept
+    {
+        silentOutputSamples = isSilent(buffer, numChannels, numSamples) ? addSamples(silentOutputSamples, numSamples) : 0;
+    }
+
+    /** Whether the last block was skipped. Safe from any thread. */
+    bool isIdle() const noexcept    { return idle.load(std::memory_order_relaxed); }
+
+private:
+    bool isSilent(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) const noexcept
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            if (buffer.getMagnitude(channel, 0, numSamples) >= floor)
+                return false;
+
+        return true;
+    }
+
+    // Counts stop at maxCount rather than wrap; no tail is anywhere near that long
+    static int addSamples(int count, int numSamples) noexcept  { return juce::jmin(count, maxCount) + numSamples; }
+
+    static constexpr int maxCount = 1 << 30;
+
+    float floor = 0.0f;
+    int tailSamples = 0;
+    int silentInputSamples = 0;
+    int silentOutputSamples = 0;
+
+    std::atomic<bool> idle { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SilenceTracker)
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/**
+    Lock-free waveform overview handed from the audio thread to an editor.
+
+    The audio thread pushes samples for each lane (input, output, ...). They're
+    reduced into buckets of samplesPerBucket keeping min, max and RMS, and the
+    most recent numBuckets buckets of every lane are kept. publish() hands an
+    oldest-first copy of all lanes to the reader through a triple buffer: the
+    writer fills its back buffer and swaps it for the shared middle one, and
+    read() only swaps the middle buffer for its front one when something new
+    has been published. Neither side locks or allocates, and editors draw
+    ready-made per-pixel peaks instead of point sampling raw audio.
+
+    Publishing is rate limited to every publishIntervalBuckets completed
+    buckets, so tiny host blocks don't copy the summary thousands of times a
+    second.
+
+    One writer thread and one reader thread. prepare() allocates and must be
+    called before either starts.
+*/
+class WaveformSummaryFeed
+{
+public:
+    struct Bucket
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        float rms = 0.0f;
+
+        /** Whichever extreme is further from zero, for single-line displays. */
+        float getPeak() const noexcept { return std::abs(max) >= std::abs(min) ? max : min; }
+    };
+
+    struct Summary
+    {
+        int numLanes = 0;
+        int numBuckets = 0;
+        juce::uint32 sequence = 0;     // Bumped on every publish
+        std::vector<Bucket> buckets;   // Lane after lane, oldest first
+
+        const Bucket* getLane(int lane) const noexcept
+        {
+            jassert(juce::isPositiveAndBelow(lane, numLanes));
+            return buckets.data() + static_cast<size_t>(lane) * static_cast<size_t>(numBuckets);
+        }
+    };
+
+    WaveformSummaryFeed() = default;
+
+    void prepare(int numLanesToUse, int numBucketsToKeep, int samplesPerBucketToUse, int publishIntervalBucketsToUse = 0)
+    {
+        numLanes = juce::jmax(1, numLanesToUse);
+        numBuckets = juce::jmax(1, numBucketsToKeep);
+        samplesPerBucket = juce::jmax(1, samplesPerBucketToUse);
+        publishIntervalBuckets = publishIntervalBucketsToUse > 0 ? publishIntervalBucketsToUse : juce::jmax(1, numBuckets / 8);
+
+        lanes.assign(static_cast<size_t>(numLanes), Lane());
+
+        for (auto& lane : lanes)
+            lane.history.assign(static_cast<size_t>(numBuckets), Bucket());
+
+        for (auto& summary : summaries)
+        {
+            summary.numLanes = numLanes;
+            summary.numBuckets = numBuckets;
+            summary.sequence = 0;
+            summary.buckets.assign(static_cast<size_t>(numLanes) * static_cast<size_t>(numBuckets), Bucket());
+        }
+
+        backIndex = 0;
+        frontIndex = 1;
+        middle.store(2, std::memory_order_relaxed);
+        publishCount = 0;
+        bucketsSincePublish = 0;
+    }
+
+    int getNumBuckets() const noexcept          { return numBuckets; }
+    int getSamplesPerBucket() const noexcept    { return samplesPerBucket; }
+
+    //==============================================================================
+    // Audio thread
+
+    /** Adds samples to a lane. Every lane should get the same number of samples per block. */
+    void push(int lane, const float* samples, int numSamples) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(lane, numLanes));
+        auto& state = lanes[static_cast<size_t>(lane)];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float sample = samples[i];
+
+            state.min = juce::jmin(state.min, sample);
+            state.max = juce::jmax(state.max, sample);
+            state.sumOfSquares += sample * sample;
+
+            if (++state.count == samplesPerBucket)
+                completeBucket(lane, state);
+        }
+    }
+
+    /** Adds numSamples of silence to a lane, for sources that came up short. */
+    void pushSilence(int lane, int numSamples) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(lane, numLanes));
+        auto& state = lanes[static_cast<size_t>(lane)];
+
+        while (numSamples > 0)
+        {
+            const int toAdd = juce::jmin(numSamples, samplesPerBucket - state.count);
+
+            state.min = juce::jmin(state.min, 0.0f);
+            state.max = juce::jmax(state.max, 0.0f);
+            state.count += toAdd;
+            numSamples -= toAdd;
+
+            if (state.count == samplesPerBucket)
+                completeBucket(lane, state);
+        }
+    }
+
+    /** Call after pushing a block to every lane. Hands the summary over once enough has changed. */
+    void publish() noexcept
+    {
+        if (bucketsSincePublish < publishIntervalBuckets)
+            return;
+
+        bucketsSincePublish = 0;
+
+        auto& back = summaries[static_cast<size_t>(backIndex)];
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const auto& state = lanes[static_cast<size_t>(lane)];
+            auto* dest = back.buckets.data() + static_cast<size_t>(lane) * static_cast<size_t>(numBuckets);
+
+            // Unroll the lane's ring oldest first
+            const auto split = state.history.begin() + state.writePos;
+            dest = std::copy(split, state.history.end(), dest);
+            std::copy(state.history.begin(), split, dest);
+        }
+
+        back.sequence = ++publishCount;
+        backIndex = middle.exchange(backIndex | newDataFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    //==============================================================================
+    // Reader
+
+    /** The latest published summary. It stays valid and unchanged until the next read(). */
+    const Summary& read() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & newDataFlag) != 0)
+            frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & indexMask;
+
+        return summaries[static_cast<size_t>(frontIndex)];
+    }
+
+private:
+    struct Lane
+    {
+        std::vector<Bucket> history;
+        int writePos = 0;
+
+        // Bucket in progress
+        float min = std::numeric_limits<float>::max();
+        float max = std::numeric_limits<float>::lowest();
+        float sumOfSquares = 0.0f;
+        int count = 0;
+    };
+
+    void completeBucket(int lane, Lane& state) noexcept
+    {
+        auto& bucket = state.history[static_cast<size_t>(state.writePos)];
+        bucket.min = state.min;
+        bucket.max = state.max;
+        bucket.rms = std::sqrt(state.sumOfSquares / static_cast<float>(samplesPerBucket));
+
+        state.writePos = (state.writePos + 1) % numBuckets;
+        state.min = std::numeric_limits<float>::max();
+        state.max = std::numeric_limits<float>::lowest();
+        state.sumOfSquares = 0.0f;
+        state.count = 0;
+
+        // Lane 0 paces publishing; the others are pushed in step with it
+        if (lane == 0)
+            ++bucketsSincePublish;
+    }
+
+    static constexpr int indexMask = 3;
+    static constexpr int newDataFlag = 4;
+
+    int numLanes = 0;
+    int numBuckets = 0;
+    int samplesPerBucket = 1;
+    int publishIntervalBuckets = 1;
+
+    // Writer side
+    std::vector<Lane> lanes;
+    int backIndex = 0;
+    juce::uint32 publishCount = 0;
+    int bucketsSincePublish = 0;
+
+    // Shared: index of the middle buffer, plus newDataFlag until the reader takes it
+    std::atomic<int> middle { 2 };
+
+    // Reader side
+    int frontIndex = 1;
+
+    std::array<Summary, 3> summaries;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformSummaryFeed)
+};
@@ -0,0 +1,354 @@
+#include "YinPitchTracker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Below this integration length the direct kernel beats three FFTs
+    constexpr int minHalfLengthForFFT = 128;
+}
+
+YinPitchTracker::YinPitchTracker()
+{
+}
+
+YinPitchTracker::~YinPitchTracker()
+{
+}
+
+void YinPitchTracker::prepare(double newSampleRate, const Settings& newSettings)
+{
+    sampleRate = newSampleRate;
+    settings = newSettings;
+    settings.decimation = settings.decimation >= 4 ? 4 : (settings.decimation >= 2 ? 2 : 1);
+    settings.hopSize = std::max(0, settings.hopSize);
+
+    analysisRate = sampleRate / settings.decimation;
+    windowSize = std::max(8, settings.windowSize / settings.decimation);
+    maxHalfLength = windowSize / 2;
+
+    history.setSize(1, windowSize, true);
+
+    frameBuffer.assign(static_cast<size_t>(windowSize), 0.0f);
+    difference.assign(static_cast<size_t>(maxHalfLength), 0.0f);
+    energy.assign(static_cast<size_t>(windowSize) + 1, 0.0);
+
+    if (maxHalfLength >= minHalfLengthForFFT)
+    {
+        // Linear correlation of the first half against the whole frame needs 2 * half points
+        const int order = juce::roundToInt(std::log2(static_cast<double>(juce::nextPowerOfTwo(2 * maxHalfLength))));
+        fft = std::make_unique<juce::dsp::FFT>(order);
+        fftWindow.assign(static_cast<size_t>(fft->getSize()) * 2, 0.0f);
+        fftFrame.assign(static_cast<size_t>(fft->getSize()) * 2, 0.0f);
+    }
+    else
+    {
+        fft.reset();
+        fftWindow.clear();
+        fftFrame.clear();
+    }
+
+    setFrequencyRange(settings.minFrequency, settings.maxFrequency);
+    reset();
+}
+
+void YinPitchTracker::reset()
+{
+    history.clear();
+    historyWritePos = 0;
+    samplesUntilAnalysis = settings.hopSize;
+    decimationSum = 0.0f;
+    decimationCount = 0;
+    estimate = {};
+}
+
+void YinPitchTracker::setHopSize(int newHopSize) noexcept
+{
+    settings.hopSize = std::max(0, newHopSize);
+    samplesUntilAnalysis = std::min(samplesUntilAnalysis, settings.hopSize);
+}
+
+void YinPitchTracker::setFrequencyRange(float minFrequency, float maxFrequency) noexcept
+{
+    settings.minFrequency = std::max(1.0f, minFrequency);
+    settings.maxFrequency = std::max(settings.minFrequency, maxFrequency);
+    updateLagRange();
+}
+
+void YinPitchTracker::updateLagRange() noexcept
+{
+    // Lags covering the frequency range. Integrating over more than the longest lag
+    // only costs time, so the integration length follows it (up to half the window).
+    minTau = std::max(2, static_cast<int>(analysisRate / settings.maxFrequency));
+
+    const int longestPeriod = static_cast<int>(analysisRate / settings.minFrequency);
+    halfLength = juce::jlimit(std::min(4, maxHalfLength), maxHalfLength, longestPeriod + 2);
+    maxTau = std::min(longestPeriod, halfLength);
+}
+
+bool YinPitchTracker::push(const float* samples, int numSamples) noexcept
+{
+    if (windowSize == 0 || numSamples <= 0)
+        return false;
+
+    if (settings.decimation == 1)
+    {
+        history.write(0, historyWritePos, samples, numSamples);
+        historyWritePos = history.wrap(historyWritePos + numSamples);
+    }
+    else
+    {
+        const float scale = 1.0f / static_cast<float>(settings.decimation);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            decimationSum += samples[i];
+
+            if (++decimationCount == settings.decimation)
+            {
+                history.setSample(0, historyWritePos, decimationSum * scale);
+                historyWritePos = history.wrap(historyWritePos + 1);
+                decimationSum = 0.0f;
+                decimationCount = 0;
+            }
+        }
+    }
+
+    if (settings.hopSize == 0)
+        return false;
+
+    samplesUntilAnalysis -= numSamples;
+
+    if (samplesUntilAnalysis > 0)
+        return false;
+
+    // Only the latest window matters, however many hops this block covered
+    samplesUntilAnalysis = settings.hopSize - (-samplesUntilAnalysis) % settings.hopSize;
+    analyseLatest();
+    return true;
+}
+
+YinPitchTracker::Estimate YinPitchTracker::analyseLatest() noexcept
+{
+    if (windowSize == 0)
+        return {};
+
+    // Mirrored storage, so the newest 2 * halfLength samples are contiguous
+    const float* frame = history.getReadPointer(0) + history.wrap(historyWritePos - 2 * halfLength);
+    return analyseFrame(frame);
+}
+
+YinPitchTracker::Estimate YinPitchTracker::analyse(const float* frame, int numSamples) noexcept
+{
+    const int available = std::min(numSamples / settings.decimation, windowSize);
+
+    if (windowSize == 0 || frame == nullptr || available < 2 * halfLength)
+    {
+        estimate = {};
+        return estimate;
+    }
+
+    if (settings.decimation == 1)
+        return analyseFrame(frame);
+
+    const float scale = 1.0f / static_cast<float>(settings.decimation);
+
+    for (int i = 0; i < available; ++i)
+    {
+        float sum = 0.0f;
+
+        for (int j = 0; j < settings.decimation; ++j)
+            sum += frame[i * settings.decimation + j];
+
+        frameBuffer[static_cast<size_t>(i)] = sum * scale;
+    }
+
+    return analyseFrame(frameBuffer.data());
+}
+
+YinPitchTracker::Estimate YinPitchTracker::analyseFrame(const float* frame) noexcept
+{
+    estimate = {};
+
+    if (minTau >= maxTau)
+        return estimate;
+
+    // Step 1: squared difference of the signal with a shifted version of itself
+    computeDifference(frame);
+
+    // Step 2: cumulative mean normalised difference
+    cumulativeMeanNormalisedDifference();
+
+    // Step 3: first dip below threshold
+    float confidence = 0.0f;
+    const int tauEstimate = absoluteThreshold(confidence);
+
+    if (tauEstimate < 0)
+        return estimate;
+
+    // Step 4: parabolic interpolation to a fractional lag
+    const float betterTau = parabolicInterpolation(tauEstimate);
+    const float frequency = static_cast<float>(analysisRate) / betterTau;
+
+    if (frequency >= settings.minFrequency && frequency <= settings.maxFrequency)
+    {
+        estimate.frequency = frequency;
+        estimate.confidence = juce::jlimit(0.0f, 1.0f, confidence);
+    }
+
+    return estimate;
+}
+
+void YinPitchTracker::computeDifference(const float* frame) noexcept
+{
+    // d(tau) = sum x[i]^2 + sum x[i + tau]^2 - 2 * sum x[i] x[i + tau], i < halfLength.
+    // The energy terms come from a running sum of squares, kept in double so the
+    // subtraction doesn't eat the small differences near the period.
+    const int frameLength = 2 * halfLength;
+
+    energy[0] = 0.0;
+    for (int i = 0; i < frameLength; ++i)
+        energy[static_cast<size_t>(i) + 1] = energy[static_cast<size_t>(i)] + static_cast<double>(frame[i]) * frame[i];
+
+    if (fft != nullptr && halfLength >= minHalfLengthForFFT)
+        correlateFFT(frame);
+    else
+        correlateDirect(frame);
+
+    // difference[] now holds the correlation
+    const double windowEnergy = energy[static_cast<size_t>(halfLength)];
+
+    for (int tau = 0; tau < halfLength; ++tau)
+    {
+        const double shiftedEnergy = energy[static_cast<size_t>(tau + halfLength)] - energy[static_cast<size_t>(tau)];
+        const double value = windowEnergy + shiftedEnergy - 2.0 * difference[static_cast<size_t>(tau)];
+        difference[static_cast<size_t>(tau)] = static_cast<float>(std::max(0.0, value));
+    }
+}
+
+void YinPitchTracker::correlateDirect(const float* frame) noexcept
+{
+    // Eight independent partial sums, so the compiler can keep them in one vector register
+    constexpr int lanes = 8;
+    const int blocked = halfLength - halfLength % lanes;
+
+    for (int tau = 0; tau < halfLength; ++tau)
+    {
+        const float* shifted = frame + tau;
+        float partial[lanes] = {};
+
+        for (int i = 0; i < blocked; i += lanes)
+            for (int lane = 0; lane < lanes; ++lane)
+                partial[lane] += frame[i + lane] * shifted[i + lane];
+
+        float sum = 0.0f;
+
+        for (int lane = 0; lane < lanes; ++lane)
+            sum += partial[lane];
+
+        for (int i = blocked; i < halfLength; ++i)
+            sum += frame[i] * shifted[i];
+
+        difference[static_cast<size_t>(tau)] = sum;
+    }
+}
+
+void YinPitchTracker::correlateFFT(const float* frame) noexcept
+{
+    // r(tau) = sum x[i] x[i + tau] is the correlation of the first half with the whole
+    // frame. Zero padded to 2 * halfLength points or more, nothing wraps into the lags we read.
+    const int fftSize = fft->getSize();
+
+    std::fill(fftWindow.begin(), fftWindow.end(), 0.0f);
+    std::fill(fftFrame.begin(), fftFrame.end(), 0.0f);
+    std::copy(frame, frame + halfLength, fftWindow.begin());
+    std::copy(frame, frame + 2 * halfLength, fftFrame.begin());
+
+    fft->performRealOnlyForwardTransform(fftWindow.data(), true);
+    fft->performRealOnlyForwardTransform(fftFrame.data(), true);
+
+    // conj(A) * B
+    for (int bin = 0; bin <= fftSize / 2; ++bin)
+    {
+        const float ar = fftWindow[static_cast<size_t>(2 * bin)];
+        const float ai = fftWindow[static_cast<size_t>(2 * bin + 1)];
+        const float br = fftFrame[static_cast<size_t>(2 * bin)];
+        const float bi = fftFrame[static_cast<size_t>(2 * bin + 1)];
+
+        fftFrame[static_cast<size_t>(2 * bin)] = ar * br + ai * bi;
+        fftFrame[static_cast<size_t>(2 * bin + 1)] = ar * bi - ai * br;
+    }
+
+    fft->performRealOnlyInverseTransform(fftFrame.data());
+
+    std::copy(fftFrame.begin(), fftFrame.begin() + halfLength, difference.begin());
+}
+
+void YinPitchTracker::cumulativeMeanNormalisedDifference() noexcept
+{
+    // Normalising by the running mean finds the true period rather than just the first minimum
+    float runningSum = 0.0f;
+    difference[0] = 1.0f;
+
+    for (int tau = 1; tau < halfLength; ++tau)
+    {
+        runningSum += difference[static_cast<size_t>(tau)];
+
+        difference[static_cast<size_t>(tau)] = (runningSum != 0.0f)
+            ? difference[static_cast<size_t>(tau)] * static_cast<float>(tau) / runningSum
+            : 1.0f;
+    }
+}
+
+int YinPitchTracker::absoluteThreshold(float& confidence) const noexcept
+{
+    for (int tau = minTau; tau < maxTau; ++tau)
+    {
+        if (difference[static_cast<size_t>(tau)] < settings.threshold)
+        {
+            // Walk down to the bottom of the dip
+            while (tau + 1 < maxTau && difference[static_cast<size_t>(tau + 1)] < difference[static_cast<size_t>(tau)])
+                ++tau;
+
+            // The threshold bounds the aperiodic power tolerated, so periodicity is what's left
+            confidence = 1.0f - difference[static_cast<size_t>(tau)];
+            return tau;
+        }
+    }
+
+    if (settings.fallbackThreshold > 0.0f)
+    {
+        const auto first = difference.begin() + minTau;
+        const auto lowest = std::min_element(first, difference.begin() + maxTau);
+
+        if (*lowest < settings.fallbackThreshold)
+        {
+            confidence = 1.0f - *lowest;
+            return static_cast<int>(lowest - difference.begin());
+        }
+    }
+
+    confidence = 0.0f;
+    return -1;
+}
+
+float YinPitchTracker::parabolicInterpolation(int tauEstimate) const noexcept
+{
+    // The best lag is rarely a whole sample, so fit a parabola through the neighbours
+    const int x0 = (tauEstimate < 1) ? tauEstimate : tauEstimate - 1;
+    const int x2 = (tauEstimate + 1 < halfLength) ? tauEstimate + 1 : tauEstimate;
+    if (x0 == tauEstimate)
+        return (difference[static_cast<size_t>(tauEstimate)] <= difference[static_cast<size_t>(x2)]) ? static_cast<float>(tauEstimate) : static_cast<float>(x2);
+
+    if (x2 == tauEstimate)
+        return (difference[static_cast<size_t>(tauEstimate)] <= difference[static_cast<size_t>(x0)]) ? static_cast<float>(tauEstimate) : static_cast<float>(x0);
+
+    const float s0 = difference[static_cast<size_t>(x0)];
+    const float s1 = difference[static_cast<size_t>(tauEstimate)];
+    const float s2 = difference[static_cast<size_t>(x2)];
+
+    // Fixed AUBIO implementation (thanks to Karl Helgason)
+    const float denominator = 2.0f * (2.0f * s1 - s2 - s0);
+
+    return (std::abs(denominator) > 1e-10f) ? static_cast<float>(tauEstimate) + (s2 - s0) / denominator : static_cast<float>(tauEstimate);
+}
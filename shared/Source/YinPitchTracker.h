@@ -0,0 +1,122 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "RingBuffer.h"
+#include <memory>
+#include <vector>
+
+/**
+    YIN fundamental frequency estimator shared by the plugins.
+    Based on: http://audition.ens.fr/adc/pdf/2002_JASA_YIN.pdf
+
+    Two ways in:
+
+    - Streaming: push() samples as they arrive. They're kept in a ring of one
+      analysis window, and the latest window is analysed every hopSize samples
+      (at most once per push, however many hops it covers). analyseLatest()
+      runs one on demand.
+    - One shot: analyse() a frame the caller has already assembled.
+
+    The difference function d(tau) = sum (x[i] - x[i + tau])^2 is expanded into
+    two energy terms, taken from a running sum of squares, minus twice the
+    cross-correlation. Long windows get the correlation from an FFT in
+    O(N log N), short ones from a direct kernel with independent accumulators
+    so it vectorises.
+
+    Input can be decimated by 2 or 4 (box filtered) before analysis, which
+    quarters or sixteenths the work when only low fundamentals matter.
+
+    prepare() allocates. push(), analyse(), analyseLatest() and the setters
+    don't, so they're safe on the audio thread.
+*/
+class YinPitchTracker
+{
+public:
+    struct Settings
+    {
+        int windowSize = 2048;           // Input samples per analysis; half is integrated, half is lag range
+        int hopSize = 512;               // Input samples between analyses in push(), 0 leaves it to analyseLatest()
+        int decimation = 1;              // 1, 2 or 4
+        float minFrequency = 40.0f;
+        float maxFrequency = 1000.0f;
+        float threshold = 0.15f;         // Absolute threshold on the normalised difference
+        float fallbackThreshold = 0.0f;  // If above zero, take the overall minimum when it's below this and nothing crossed threshold
+    };
+
+    struct Estimate
+    {
+        float frequency = 0.0f;   // Hz, 0 when unvoiced
+        float confidence = 0.0f;  // Periodicity, 1 - normalised difference at the chosen lag
+    };
+
+    YinPitchTracker();
+    ~YinPitchTracker();
+
+    void prepare(double sampleRate, const Settings& newSettings);
+    void reset();
+
+    void setThreshold(float newThreshold) noexcept { settings.threshold = newThreshold; }
+
+    /** Changes the streaming hop. The next analysis comes no later than one new hop away. */
+    void setHopSize(int newHopSize) noexcept;
+
+    /** Narrows the search range. The lag range can't grow past what the window was prepared for. */
+    void setFrequencyRange(float minFrequency, float maxFrequency) noexcept;
+
+    /** Ingests samples. Returns true if an analysis ran, its result is getEstimate(). */
+    bool push(const float* samples, int numSamples) noexcept;
+
+    /** Analyses the most recent window now, regardless of the hop. */
+    Estimate analyseLatest() noexcept;
+
+    /** Analyses numSamples of caller supplied input (at the input rate). Uses up
+        to the prepared window size, taking the start of the frame. */
+    Estimate analyse(const float* frame, int numSamples) noexcept;
+
+    const Estimate& getEstimate() const noexcept { return estimate; }
+    const Settings& getSettings() const noexcept { return settings; }
+
+    /** Input samples the analysis window covers. */
+    int getWindowSize() const noexcept { return windowSize * settings.decimation; }
+
+private:
+    Settings settings;
+    double sampleRate = 44100.0;
+    double analysisRate = 44100.0;  // sampleRate / decimation
+
+    // Sizes at the analysis rate
+    int windowSize = 0;       // Samples in the ring and the longest frame analyse() takes
+    int maxHalfLength = 0;    // windowSize / 2
+    int halfLength = 0;       // Integration length and lag range for the current frequency range
+    int minTau = 2;
+    int maxTau = 2;
+
+    // Streaming input, mirrored so the latest window reads through one pointer
+    RingBuffer<float> history;
+    int historyWritePos = 0;
+    int samplesUntilAnalysis = 0;
+    float decimationSum = 0.0f;
+    int decimationCount = 0;
+
+    // Analysis scratch
+    std::vector<float> frameBuffer;       // Decimated copy for analyse()
+    std::vector<float> difference;        // d(tau), then the cumulative mean normalised difference
+    std::vector<double> energy;           // Running sum of squares over the frame
+    std::unique_ptr<juce::dsp::FFT> fft;  // Only for windows long enough to be worth it
+    std::vector<float> fftWindow;
+    std::vector<float> fftFrame;
+
+    Estimate estimate;
+
+    void updateLagRange() noexcept;
+    Estimate analyseFrame(const float* frame) noexcept;
+
+    void computeDifference(const float* frame) noexcept;
+    void correlateDirect(const float* frame) noexcept;
+    void correlateFFT(const float* frame) noexcept;
+    void cumulativeMeanNormalisedDifference() noexcept;
+    int absoluteThreshold(float& confidence) const noexcept;
+    float parabolicInterpolation(int tauEstimate) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(YinPitchTracker)
+};
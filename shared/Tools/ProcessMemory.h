@@ -0,0 +1,73 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#if JUCE_LINUX
+ #include <unistd.h>
+#elif JUCE_MAC
+ #include <mach/mach.h>
+#elif JUCE_WINDOWS
+ #include <windows.h>
+ #include <psapi.h>
+ #pragma comment(lib, "psapi.lib")
+#endif
+
+/**
+    Resident memory of the current process, for the developer tools. Both read 0
+    where the platform doesn't say.
+*/
+namespace ProcessMemory
+{
+    /** What's resident right now, in bytes. */
+    inline juce::int64 getResidentBytes()
+    {
+       #if JUCE_LINUX
+        juce::StringArray fields;
+        fields.addTokens(juce::File("/proc/self/statm").loadFileAsString(), false);
+        return fields.size() > 1 ? fields[1].getLargeIntValue() * static_cast<juce::int64>(sysconf(_SC_PAGESIZE)) : 0;
+       #elif JUCE_MAC
+        mach_task_basic_info info;
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+            return 0;
+
+        return static_cast<juce::int64>(info.resident_size);
+       #elif JUCE_WINDOWS
+        PROCESS_MEMORY_COUNTERS counters;
+        return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? static_cast<juce::int64>(counters.WorkingSetSize) : 0;
+       #else
+        return 0;
+       #endif
+    }
+
+    /** The most that has been resident at once since the process started, in bytes. */
+    inline juce::int64 getPeakResidentBytes()
+    {
+       #if JUCE_LINUX
+        for (const auto& line : juce::StringArray::fromLines(juce::File("/proc/self/status").loadFileAsString()))
+            if (line.startsWith("VmHWM:"))
+                return line.fromFirstOccurrenceOf(":", false, false).trim().getLargeIntValue() * 1024;
+
+        return 0;
+       #elif JUCE_MAC
+        mach_task_basic_info info;
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+            return 0;
+
+        return static_cast<juce::int64>(info.resident_size_max);
+       #elif JUCE_WINDOWS
+        PROCESS_MEMORY_COUNTERS counters;
+        return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? static_cast<juce::int64>(counters.PeakWorkingSetSize) : 0;
+       #else
+        return 0;
+       #endif
+    }
+
+    inline juce::String formatMegabytes(juce::int64 bytes)
+    {
+        return juce::String(static_cast<double>(bytes) / (1024.0 * 1024.0), 1) + " MB";
+    }
+}
@@ -0,0 +1,281 @@
+#include "RealtimeGuard.h"
+
+#include <atomic>
+#include <cstring>
+
+#if JUCE_LINUX
+ #include <cerrno>
+ #include <cxxabi.h>
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <time.h>
+ #include <unistd.h>
+
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void __libc_free(void*);
+}
+#endif
+
+namespace
+{
+    // Plain thread locals with no constructors, so the allocator hooks can read them
+    // on any thread at any time
+    thread_local bool checking = false;
+    thread_local bool recording = false;
+    thread_local int currentContext = 0;
+    thread_local int currentBlock = 0;
+
+    RealtimeGuard::Record records[RealtimeGuard::maxRecords];
+    std::atomic<int> numViolations { 0 };
+
+   #if JUCE_LINUX
+    // Skips the hook and report() itself
+    constexpr int numGuardFrames = 2;
+
+    __attribute__((noinline)) void report(RealtimeGuard::Violation kind) noexcept
+    {
+        if (! checking || recording)
+            return;
+
+        recording = true;
+
+        const int index = numViolations.fetch_add(1);
+
+        if (index < RealtimeGuard::maxRecords)
+        {
+            void* frames[RealtimeGuard::maxFrames + numGuardFrames];
+            const int numFrames = juce::jmax(0, backtrace(frames, RealtimeGuard::maxFrames + numGuardFrames) - numGuardFrames);
+
+            auto& record = records[index];
+            record.kind = kind;
+            record.context = currentContext;
+            record.blockIndex = currentBlock;
+            record.numFrames = numFrames;
+            std::memcpy(record.frames, frames + numGuardFrames, sizeof(void*) * static_cast<size_t>(numFrames));
+        }
+
+        recording = false;
+    }
+
+    // The next definition along, i.e. libc's or libpthread's
+    template <typename Function>
+    Function next(Function& cached, const char* name) noexcept
+    {
+        if (cached == nullptr)
+            cached = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+
+        return cached;
+    }
+   #endif
+}
+
+#if JUCE_LINUX
+extern "C"
+{
+    void* malloc(size_t size) noexcept
+    {
+        report(RealtimeGuard::Violation::Allocation);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        report(RealtimeGuard::Violation::Allocation);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        report(RealtimeGuard::Violation::Allocation);
+        return __libc_realloc(pointer, size);
+    }
+
+    void* memalign(size_t alignment, size_t size) noexcept
+    {
+        report(RealtimeGuard::Violation::Allocation);
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        report(RealtimeGuard::Violation::Allocation);
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+    {
+        report(RealtimeGuard::Violation::Allocation);
+
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        *result = __libc_memalign(alignment, size);
+        return *result != nullptr ? 0 : ENOMEM;
+    }
+
+    void free(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            report(RealtimeGuard::Violation::Deallocation);
+
+        __libc_free(pointer);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        static int (*original)(pthread_mutex_t*) = nullptr;
+        report(RealtimeGuard::Violation::MutexLock);
+        return next(original, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        static int (*original)(pthread_cond_t*, pthread_mutex_t*) = nullptr;
+        report(RealtimeGuard::Violation::Wait);
+        return next(original, "pthread_cond_wait")(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* time)
+    {
+        static int (*original)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*) = nullptr;
+        report(RealtimeGuard::Violation::Wait);
+        return next(original, "pthread_cond_timedwait")(condition, mutex, time);
+    }
+
+    int sem_wait(sem_t* semaphore)
+    {
+        static int (*original)(sem_t*) = nullptr;
+        report(RealtimeGuard::Violation::Wait);
+        return next(original, "sem_wait")(semaphore);
+    }
+
+    int nanosleep(const struct timespec* duration, struct timespec* remaining)
+    {
+        static int (*original)(const struct timespec*, struct timespec*) = nullptr;
+        report(RealtimeGuard::Violation::Sleep);
+        return next(original, "nanosleep")(duration, remaining);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        static int (*original)(useconds_t) = nullptr;
+        report(RealtimeGuard::Violation::Sleep);
+        return next(original, "usleep")(microseconds);
+    }
+
+    ssize_t read(int fd, void* data, size_t size)
+    {
+        static ssize_t (*original)(int, void*, size_t) = nullptr;
+        report(RealtimeGuard::Violation::FileIO);
+        return next(original, "read")(fd, data, size);
+    }
+
+    ssize_t write(int fd, const void* data, size_t size)
+    {
+        static ssize_t (*original)(int, const void*, size_t) = nullptr;
+        report(RealtimeGuard::Violation::FileIO);
+        return next(original, "write")(fd, data, size);
+    }
+}
+#endif
+
+bool RealtimeGuard::Record::hasSameStack(const Record& other) const noexcept
+{
+    return kind == other.kind
+        && numFrames == other.numFrames
+        && std::memcmp(frames, other.frames, sizeof(void*) * static_cast<size_t>(numFrames)) == 0;
+}
+
+RealtimeGuard::Scope::Scope(int context, int blockIndex) noexcept
+{
+    currentContext = context;
+    currentBlock = blockIndex;
+    checking = true;
+}
+
+RealtimeGuard::Scope::~Scope() noexcept
+{
+    checking = false;
+}
+
+bool RealtimeGuard::isSupported() noexcept
+{
+   #if JUCE_LINUX
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+void RealtimeGuard::initialise()
+{
+   #if JUCE_LINUX
+    // The first backtrace() loads the unwinder, which allocates
+    void* frames[maxFrames];
+    backtrace(frames, maxFrames);
+   #endif
+}
+
+int RealtimeGuard::getNumViolations() noexcept          { return numViolations.load(); }
+int RealtimeGuard::getNumRecords() noexcept             { return juce::jmin(getNumViolations(), maxRecords); }
+const RealtimeGuard::Record& RealtimeGuard::getRecord(int index) noexcept  { return records[index]; }
+void RealtimeGuard::clear() noexcept                    { numViolations.store(0); }
+
+const char* RealtimeGuard::getName(Violation kind) noexcept
+{
+    switch (kind)
+    {
+        case Violation::Allocation:   return "allocation";
+        case Violation::Deallocation: return "free";
+        case Violation::MutexLock:    return "mutex lock";
+        case Violation::Wait:         return "wait";
+        case Violation::Sleep:        return "sleep";
+        case Violation::FileIO:       return "file I/O";
+    }
+
+    return "";
+}
+
+juce::StringArray RealtimeGuard::describeStack(const Record& record)
+{
+    juce::StringArray lines;
+
+   #if JUCE_LINUX
+    for (int i = 0; i < record.numFrames; ++i)
+    {
+        Dl_info info {};
+
+        if (dladdr(record.frames[i], &info) == 0)
+        {
+            lines.add(juce::String::toHexString(reinterpret_cast<juce::pointer_sized_int>(record.frames[i])));
+            continue;
+        }
+
+        // Plugins hide most of their symbols; module and offset still go through addr2line
+        const auto offset = reinterpret_cast<juce::pointer_sized_int>(record.frames[i])
+                          - reinterpret_cast<juce::pointer_sized_int>(info.dli_fbase);
+        juce::String line = juce::File(info.dli_fname).getFileName() + "+0x" + juce::String::toHexString(offset);
+
+        if (info.dli_sname != nullptr)
+        {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            line << "  " << (status == 0 ? demangled : info.dli_sname);
+            free(demangled);
+        }
+
+        lines.add(line);
+    }
+   #else
+    juce::ignoreUnused(record);
+   #endif
+
+    return lines;
+}
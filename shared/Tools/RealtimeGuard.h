@@ -0,0 +1,74 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Catches realtime violations made by a thread while it's inside a
+    RealtimeGuard::Scope: heap allocation and freeing, mutex locks, condition
+    and semaphore waits, sleeps and file reads and writes.
+
+    The tool replaces malloc and friends and the blocking pthread and libc calls
+    with versions that record a violation, along with its call stack, before
+    passing the call on. Only the thread in a Scope is checked, so background
+    threads and everything outside the Scope run as normal. For the replacements
+    to reach calls made from shared libraries (libstdc++'s operator new, say),
+    the executable has to export them (CMake's ENABLE_EXPORTS).
+
+    Linux with glibc only: elsewhere isSupported() is false and nothing is
+    caught. One checked thread at a time.
+*/
+class RealtimeGuard
+{
+public:
+    enum class Violation
+    {
+        Allocation,
+        Deallocation,
+        MutexLock,
+        Wait,
+        Sleep,
+        FileIO
+    };
+
+    static constexpr int maxFrames = 32;
+
+    struct Record
+    {
+        Violation kind = Violation::Allocation;
+        int context = 0;        // Whatever the Scope was given, e.g. which sweep was running
+        int blockIndex = 0;
+        int numFrames = 0;
+        void* frames[maxFrames] {};
+
+        bool hasSameStack(const Record& other) const noexcept;
+    };
+
+    /** Checks the calling thread while it's in scope. */
+    class Scope
+    {
+    public:
+        Scope(int context, int blockIndex) noexcept;
+        ~Scope() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    static bool isSupported() noexcept;
+
+    /** Call early in main(), before any Scope. Loads what stack capture needs, so that
+        it doesn't allocate once checking starts. */
+    static void initialise();
+
+    /** Every violation since the last clear(). Only the first maxRecords are kept. */
+    static int getNumViolations() noexcept;
+    static int getNumRecords() noexcept;
+    static const Record& getRecord(int index) noexcept;
+    static void clear() noexcept;
+
+    static constexpr int maxRecords = 1024;
+
+    static const char* getName(Violation kind) noexcept;
+
+    /** One line per frame, from the violating call outwards. Allocates, so not in a Scope. */
+    static juce::StringArray describeStack(const Record& record);
+};
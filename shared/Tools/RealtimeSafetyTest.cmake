@@ -0,0 +1,41 @@
+# Realtime-safety test for a plugin's processor (developer tool; see RealtimeSafetyTest.cpp).
+#
+# add_realtime_safety_test(<target>) builds <target>RealtimeSafetyTest, a console app
+# that links the plugin's shared code and calls the processor's processBlock()
+# directly, the way add_render_host() does. Going through a plugin format instead
+# would put the wrapper's own locks inside every checked call. Needs glibc to
+# interpose malloc and friends, so it does nothing outside Linux.
+
+set(REALTIME_SAFETY_TEST_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+function(add_realtime_safety_test target)
+    if(NOT CMAKE_SYSTEM_NAME STREQUAL "Linux")
+        return()
+    endif()
+
+    set(safetyTest ${target}RealtimeSafetyTest)
+
+    add_executable(${safetyTest}
+        ${REALTIME_SAFETY_TEST_DIR}/RealtimeSafetyTest.cpp
+        ${REALTIME_SAFETY_TEST_DIR}/RealtimeGuard.cpp
+    )
+
+    # The shared code's JuceHeader.h and module settings are private to it
+    target_include_directories(${safetyTest}
+        PRIVATE
+            ${REALTIME_SAFETY_TEST_DIR}
+            $<TARGET_PROPERTY:${target},INCLUDE_DIRECTORIES>
+    )
+
+    target_compile_definitions(${safetyTest}
+        PRIVATE
+            $<TARGET_PROPERTY:${target},COMPILE_DEFINITIONS>
+    )
+
+    # The replacement malloc and pthread functions have to be visible to shared libraries too
+    set_target_properties(${safetyTest} PROPERTIES ENABLE_EXPORTS TRUE)
+
+    target_link_libraries(${safetyTest} PRIVATE ${target} ${CMAKE_DL_LIBS})
+
+    target_compile_features(${safetyTest} PRIVATE cxx_std_17)
+endfunction()
@@ -0,0 +1,245 @@
+// Realtime-safety test, built against one plugin's processor (see RealtimeSafetyTest.cmake).
+//
+// Creates the processor and checks every processBlock() call for heap
+// allocation and freeing, mutex locks, waits, sleeps and file I/O (see
+// RealtimeGuard). The processor is called directly, so nothing a plugin format
+// wrapper does around it gets in the way. It's driven through a series of
+// sweeps, each one run over a signal that glides, bursts, drops to silence and
+// comes back:
+//
+//   defaults       no automation
+//   <parameter>    that parameter swept up and back down, the rest at defaults
+//   all            every parameter jumping to a new value each block
+//
+// Blocks before the sweeps are processed unchecked and at realtime pace for the
+// warm-up time, so work a plugin does in the background after prepareToPlay()
+// has finished. Each distinct violation is reported once, with how many times
+// it happened, the sweep and block it first showed up in and its call stack.
+//
+//   <Plugin>RealtimeSafetyTest [--sample-rate <hz>] [--block-size <n>] [--seconds <s>] [--warmup <s>]
+//
+// --seconds is the length of each sweep (default 2). Returns non-zero if there
+// are any violations. Linux only.
+
+#include <JuceHeader.h>
+#include "RealtimeGuard.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Defined by the plugin
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    struct Settings
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        double sweepSeconds = 2.0;
+        double warmupSeconds = 2.0;
+    };
+
+    // Glide, noise, silence, then signal again so anything that idles has to wake up
+    class TestSignal
+    {
+    public:
+        TestSignal(double rate, int lengthInSamples) : sampleRate(rate), length(juce::jmax(1, lengthInSamples)) {}
+
+        void fill(juce::AudioBuffer<float>& buffer, int startSample)
+        {
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                const double position = static_cast<double>((startSample + i) % length) / length;
+                float sample = 0.0f;
+
+                if (position < 0.4 || position >= 0.8)
+                {
+                    const double frequency = 110.0 * std::pow(8.0, position);
+                    phase += juce::MathConstants<double>::twoPi * frequency / sampleRate;
+                    sample = 0.25f * static_cast<float>(std::sin(phase));
+                }
+                else if (position < 0.6)
+                {
+                    sample = (random.nextFloat() * 2.0f - 1.0f) * (((startSample + i) / 2048) % 2 == 0 ? 0.5f : 0.02f);
+                }
+
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    buffer.setSample(channel, i, sample);
+            }
+        }
+
+    private:
+        double sampleRate;
+        int length;
+        double phase = 0.0;
+        juce::Random random { 1 };
+    };
+
+    void resetParameters(juce::AudioProcessor& processor)
+    {
+        for (auto* parameter : processor.getParameters())
+            parameter->setValue(parameter->getDefaultValue());
+    }
+
+    void printViolations(const juce::StringArray& sweepNames)
+    {
+        const int numRecords = RealtimeGuard::getNumRecords();
+        std::vector<bool> reported(static_cast<size_t>(numRecords), false);
+
+        for (int i = 0; i < numRecords; ++i)
+        {
+            if (reported[static_cast<size_t>(i)])
+                continue;
+
+            const auto& first = RealtimeGuard::getRecord(i);
+            int count = 0;
+
+            for (int j = i; j < numRecords; ++j)
+            {
+                if (! reported[static_cast<size_t>(j)] && RealtimeGuard::getRecord(j).hasSameStack(first))
+                {
+                    reported[static_cast<size_t>(j)] = true;
+                    ++count;
+                }
+            }
+
+            std::cout << "  " << RealtimeGuard::getName(first.kind) << " x" << count
+                      << ", first in sweep \"" << sweepNames[first.context] << "\" block " << first.blockIndex << std::endl;
+
+            for (const auto& frame : RealtimeGuard::describeStack(first))
+                std::cout << "      " << frame << std::endl;
+        }
+
+        if (RealtimeGuard::getNumViolations() > numRecords)
+            std::cout << "  (stacks kept for the first " << numRecords << " violations only)" << std::endl;
+    }
+
+    // Returns the number of violations
+    int runProcessor(juce::AudioProcessor& processor, const Settings& settings)
+    {
+        const int blockSize = settings.blockSize;
+        const int blocksPerSweep = juce::jmax(1, juce::roundToInt(settings.sweepSeconds * settings.sampleRate / blockSize));
+        const int warmupBlocks = juce::roundToInt(settings.warmupSeconds * settings.sampleRate / blockSize);
+        const auto& parameters = processor.getParameters();
+
+        juce::StringArray sweepNames { "defaults" };
+
+        for (auto* parameter : parameters)
+            sweepNames.add(parameter->getName(64));
+
+        sweepNames.add("all");
+
+        processor.enableAllBuses();
+        processor.setNonRealtime(false);
+        processor.setRateAndBufferSizeDetails(settings.sampleRate, blockSize);
+        resetParameters(processor);
+        processor.prepareToPlay(settings.sampleRate, blockSize);
+
+        const int numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        midi.ensureSize(1024);
+
+        TestSignal signal(settings.sampleRate, blocksPerSweep * blockSize);
+        juce::Random random { 2 };
+        int position = 0;
+
+        for (int block = 0; block < warmupBlocks; ++block)
+        {
+            signal.fill(buffer, position);
+            position += blockSize;
+            processor.processBlock(buffer, midi);
+            juce::Thread::sleep(juce::roundToInt(1000.0 * blockSize / settings.sampleRate));
+        }
+
+        RealtimeGuard::clear();
+
+        for (int sweep = 0; sweep < sweepNames.size(); ++sweep)
+        {
+            const bool sweepsOne = sweep > 0 && sweep <= parameters.size();
+            const bool sweepsAll = sweep == sweepNames.size() - 1;
+
+            resetParameters(processor);
+
+            for (int block = 0; block < blocksPerSweep; ++block)
+            {
+                // Triangle from 0 up to 1 and back
+                const float progress = static_cast<float>(block) / static_cast<float>(blocksPerSweep);
+                const float value = 1.0f - std::abs(2.0f * progress - 1.0f);
+
+                if (sweepsOne)
+                    parameters[sweep - 1]->setValue(value);
+                else if (sweepsAll)
+                    for (auto* parameter : parameters)
+                        parameter->setValue(random.nextFloat());
+
+                signal.fill(buffer, position);
+                position += blockSize;
+                midi.clear();
+
+                RealtimeGuard::Scope scope(sweep, block);
+                processor.processBlock(buffer, midi);
+            }
+        }
+
+        processor.releaseResources();
+
+        const int numViolations = RealtimeGuard::getNumViolations();
+
+        if (numViolations == 0)
+            std::cout << "  ok   no violations in " << sweepNames.size() * blocksPerSweep << " blocks" << std::endl;
+        else
+            std::cout << "  FAIL " << numViolations << " violations" << std::endl;
+
+        printViolations(sweepNames);
+        return numViolations;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (! RealtimeGuard::isSupported())
+    {
+        std::cout << "The realtime safety test needs Linux with glibc" << std::endl;
+        return 1;
+    }
+
+    RealtimeGuard::initialise();
+
+    Settings settings;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+
+        if (arg == "--sample-rate" && hasValue)
+            settings.sampleRate = juce::jmax(1.0, args[++i].text.getDoubleValue());
+        else if (arg == "--block-size" && hasValue)
+            settings.blockSize = juce::jmax(1, args[++i].text.getIntValue());
+        else if (arg == "--seconds" && hasValue)
+            settings.sweepSeconds = args[++i].text.getDoubleValue();
+        else if (arg == "--warmup" && hasValue)
+            settings.warmupSeconds = args[++i].text.getDoubleValue();
+        else
+        {
+            std::cout << "Usage: " << juce::File(argv[0]).getFileName()
+                      << " [--sample-rate <hz>] [--block-size <n>] [--seconds <s>] [--warmup <s>]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Processors expect a message manager, though nothing here dispatches its messages
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    std::unique_ptr<juce::AudioProcessor> processor(createPluginFilter());
+
+    std::cout << "Realtime safety of " << processor->getName() << " (" << settings.sampleRate << " Hz, "
+              << settings.blockSize << " sample blocks, " << settings.sweepSeconds << " s sweeps)" << std::endl << std::endl;
+
+    return runProcessor(*processor, settings) == 0 ? 0 : 1;
+}
@@ -0,0 +1,31 @@
+# Headless render host for a plugin's processor (developer tool; see RenderHost.cpp).
+#
+# add_render_host(<target>) builds <target>Render, a console app that links the
+# plugin's shared code and creates the processor through createPluginFilter(),
+# the way JUCE's Standalone wrapper does. Each plugin gets its own executable,
+# since every plugin defines createPluginFilter() and compiles its own JUCE
+# modules.
+
+set(RENDER_HOST_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+function(add_render_host target)
+    set(host ${target}Render)
+
+    add_executable(${host} ${RENDER_HOST_DIR}/RenderHost.cpp)
+
+    # The shared code's JuceHeader.h and module settings are private to it
+    target_include_directories(${host}
+        PRIVATE
+            ${RENDER_HOST_DIR}
+            $<TARGET_PROPERTY:${target},INCLUDE_DIRECTORIES>
+    )
+
+    target_compile_definitions(${host}
+        PRIVATE
+            $<TARGET_PROPERTY:${target},COMPILE_DEFINITIONS>
+    )
+
+    target_link_libraries(${host} PRIVATE ${target})
+
+    target_compile_features(${host} PRIVATE cxx_std_17)
+endfunction()
@@ -0,0 +1,300 @@
+// Headless render host, built against one plugin's processor (see RenderHost.cmake).
+//
+// Streams WAV files through the processor a block at a time, as an offline bounce
+// would, and writes what comes out, followed by the processor's tail. For each
+// file it reports the realtime factor (seconds of audio per second spent in
+// processBlock) and the slowest block against its realtime budget, and at the
+// end the process's peak resident memory. Files are shared out over a pool of
+// threads, each render with its own processor.
+//
+//   <Plugin>Render [--block-size <n>] [--threads <n>] [--output-dir <dir>] [--no-output]
+//                  [--set <parameter>=<value> ...] <input.wav> [<input.wav> ...]
+//
+// --set takes a parameter ID and a value in the parameter's own units, e.g.
+// --set mix=50, and can be repeated. Outputs are named after their input with the
+// plugin's name on the end, next to the input unless --output-dir says otherwise;
+// --no-output only measures. Returns non-zero if any file fails.
+
+#include <JuceHeader.h>
+#include "ProcessMemory.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// Defined by the plugin
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Tails longer than this (a frozen spectrum, say) are cut off
+    constexpr double maxTailSeconds = 30.0;
+
+    struct Settings
+    {
+        int blockSize = 512;
+        juce::File outputDirectory;
+        bool writeOutput = true;
+        juce::StringPairArray parameterValues;
+    };
+
+    struct RenderResult
+    {
+        juce::File input;
+        juce::String error;
+        double audioSeconds = 0.0;
+        double processSeconds = 0.0;
+        double worstBlockMs = 0.0;
+        double blockBudgetMs = 0.0;
+
+        double getRealtimeFactor() const  { return processSeconds > 0.0 ? audioSeconds / processSeconds : 0.0; }
+    };
+
+    // Processor constructors aren't written to run side by side
+    juce::CriticalSection constructionLock;
+
+    std::unique_ptr<juce::AudioProcessor> createProcessor()
+    {
+        const juce::ScopedLock lock(constructionLock);
+        return std::unique_ptr<juce::AudioProcessor>(createPluginFilter());
+    }
+
+    // Returns the IDs it couldn't find
+    juce::StringArray applyParameterValues(juce::AudioProcessor& processor, const juce::StringPairArray& values)
+    {
+        juce::StringArray unknown;
+
+        for (const auto& id : values.getAllKeys())
+        {
+            bool found = false;
+
+            for (auto* parameter : processor.getParameters())
+            {
+                auto* withId = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter);
+
+                if (withId == nullptr || withId->paramID != id)
+                    continue;
+
+                const float value = values[id].getFloatValue();
+
+                if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+                    ranged->setValueNotifyingHost(ranged->convertTo0to1(value));
+                else
+                    parameter->setValueNotifyingHost(value);
+
+                found = true;
+            }
+
+            if (! found)
+                unknown.add(id);
+        }
+
+        return unknown;
+    }
+
+    RenderResult render(const juce::File& input, const Settings& settings)
+    {
+        RenderResult result;
+        result.input = input;
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+
+        if (reader == nullptr)
+        {
+            result.error = "can't read it as audio";
+            return result;
+        }
+
+        auto processor = createProcessor();
+        applyParameterValues(*processor, settings.parameterValues);
+
+        const double sampleRate = reader->sampleRate;
+        const int blockSize = settings.blockSize;
+
+        processor->enableAllBuses();
+        processor->setNonRealtime(true);
+        processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor->prepareToPlay(sampleRate, blockSize);
+
+        const int numOutputChannels = processor->getTotalNumOutputChannels();
+        const int numChannels = juce::jmax(processor->getTotalNumInputChannels(), numOutputChannels);
+        const auto tailSamples = static_cast<juce::int64>(juce::jmin(processor->getTailLengthSeconds(), maxTailSeconds) * sampleRate);
+        const juce::int64 totalSamples = reader->lengthInSamples + tailSamples;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+
+        if (settings.writeOutput)
+        {
+            const auto directory = settings.outputDirectory == juce::File() ? input.getParentDirectory() : settings.outputDirectory;
+            const auto output = directory.getChildFile(input.getFileNameWithoutExtension() + "_"
+                                                       + processor->getName().removeCharacters(" ") + ".wav");
+            output.deleteFile();
+
+            std::unique_ptr<juce::OutputStream> stream = output.createOutputStream();
+
+            if (stream != nullptr)
+                writer.reset(wav.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numOutputChannels),
+                                                 32, {}, 0));
+
+            if (writer == nullptr)
+            {
+                result.error = "can't write " + output.getFullPathName();
+                return result;
+            }
+
+            stream.release(); // owned by the writer now
+        }
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        for (juce::int64 position = 0; position < totalSamples; position += blockSize)
+        {
+            const int numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), totalSamples - position));
+
+            // Past the end of the file the reader pads with silence; a mono file feeds both channels
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            buffer.clear();
+            reader->read(&buffer, 0, numSamples, position, true, true);
+
+            const auto start = Clock::now();
+            processor->processBlock(buffer, midi);
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+            result.processSeconds += seconds;
+            result.worstBlockMs = juce::jmax(result.worstBlockMs, 1000.0 * seconds);
+            midi.clear();
+
+            if (writer != nullptr)
+                writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+        }
+
+        processor->releaseResources();
+
+        result.audioSeconds = static_cast<double>(totalSamples) / sampleRate;
+        result.blockBudgetMs = 1000.0 * blockSize / sampleRate;
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    Settings settings;
+    int numThreads = juce::SystemStats::getNumCpus();
+
+    juce::Array<juce::File> inputs;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+
+        if (arg == "--block-size" && hasValue)
+            settings.blockSize = juce::jmax(1, args[++i].text.getIntValue());
+        else if (arg == "--threads" && hasValue)
+            numThreads = juce::jmax(1, args[++i].text.getIntValue());
+        else if (arg == "--output-dir" && hasValue)
+            settings.outputDirectory = args[++i].resolveAsFile();
+        else if (arg == "--no-output")
+            settings.writeOutput = false;
+        else if (arg == "--set" && hasValue)
+        {
+            const auto assignment = args[++i].text;
+            settings.parameterValues.set(assignment.upToFirstOccurrenceOf("=", false, false).trim(),
+                                         assignment.fromFirstOccurrenceOf("=", false, false).trim());
+        }
+        else if (! arg.isOption())
+            inputs.add(arg.resolveAsFile());
+    }
+
+    if (inputs.isEmpty())
+    {
+        std::cout << "Usage: " << juce::File(argv[0]).getFileName()
+                  << " [--block-size <n>] [--threads <n>] [--output-dir <dir>] [--no-output]"
+                     " [--set <parameter>=<value> ...] <input.wav> [<input.wav> ...]" << std::endl;
+        return 1;
+    }
+
+    // Processors expect a message manager, though nothing here dispatches its messages
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::String processorName;
+
+    {
+        auto probe = createProcessor();
+        processorName = probe->getName();
+
+        const auto unknown = applyParameterValues(*probe, settings.parameterValues);
+
+        if (! unknown.isEmpty())
+        {
+            std::cout << processorName << " has no parameter " << unknown.joinIntoString(", ") << std::endl;
+            return 1;
+        }
+    }
+
+    if (settings.outputDirectory != juce::File() && settings.outputDirectory.createDirectory().failed())
+    {
+        std::cout << "Can't create " << settings.outputDirectory.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    numThreads = juce::jmin(numThreads, inputs.size());
+
+    std::cout << "Rendering " << inputs.size() << " file" << (inputs.size() == 1 ? "" : "s") << " through " << processorName
+              << " (" << settings.blockSize << " sample blocks, " << numThreads << " thread" << (numThreads == 1 ? "" : "s") << ")"
+              << std::endl << std::endl;
+
+    std::vector<RenderResult> results(static_cast<size_t>(inputs.size()));
+    const auto batchStart = Clock::now();
+
+    {
+        juce::ThreadPool pool(numThreads);
+
+        for (int i = 0; i < inputs.size(); ++i)
+            pool.addJob([&results, &settings, input = inputs[i], i] { results[static_cast<size_t>(i)] = render(input, settings); });
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(10);
+    }
+
+    const double wallSeconds = std::chrono::duration<double>(Clock::now() - batchStart).count();
+    double totalAudioSeconds = 0.0;
+    int numFailures = 0;
+
+    for (const auto& result : results)
+    {
+        std::cout << (result.error.isEmpty() ? "ok   " : "FAIL ") << result.input.getFileName().paddedRight(' ', 32);
+
+        if (result.error.isNotEmpty())
+        {
+            std::cout << result.error << std::endl;
+            ++numFailures;
+            continue;
+        }
+
+        totalAudioSeconds += result.audioSeconds;
+
+        std::cout << juce::String(result.audioSeconds, 2).paddedLeft(' ', 8) << " s"
+                  << "  " << juce::String(result.getRealtimeFactor(), 1).paddedLeft(' ', 8) << "x realtime"
+                  << "  worst block " << juce::String(result.worstBlockMs, 3).paddedLeft(' ', 8) << " ms"
+                  << " (" << juce::String(100.0 * result.worstBlockMs / result.blockBudgetMs, 0) << "% of budget)"
+                  << std::endl;
+    }
+
+    std::cout << std::endl
+              << juce::String(totalAudioSeconds, 2) << " s of audio in " << juce::String(wallSeconds, 2) << " s"
+              << " (" << juce::String(wallSeconds > 0.0 ? totalAudioSeconds / wallSeconds : 0.0, 1) << "x realtime over the batch)"
+              << std::endl
+              << "peak resident memory " << ProcessMemory::formatMegabytes(ProcessMemory::getPeakResidentBytes()) << std::endl;
+
+    return numFailures == 0 ? 0 : 1;
+}
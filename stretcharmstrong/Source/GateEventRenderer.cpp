@@ -0,0 +1,570 @@
+#include "GateEventRenderer.h"
+#include <cmath>
+#include <algorithm>
+#include <map>
+
+GateEventRenderer::GateEventRenderer()
+{
+}
+
+GateEventRenderer::~GateEventRenderer()
+{
+    worker.stopThread(4000);
+}
+
+void GateEventRenderer::prepare(double newSampleRate)
+{
+    worker.stopThread(4000);
+
+    // Nothing is mid-event any more. Captures already waiting are still valid at the
+    // same sample rate, as is the cache, so a host re-preparing before a bounce keeps it.
+    recording = nullptr;
+    playing = nullptr;
+
+    for (auto& capture : captures)
+    {
+        int expected = captureRecording;
+        capture.state.compare_exchange_strong(expected, captureFree);
+    }
+
+    for (auto& entry : cache)
+    {
+        int expected = entryPlaying;
+        entry.state.compare_exchange_strong(expected, entryReady);
+    }
+
+    if (newSampleRate != sampleRate)
+    {
+        sampleRate = newSampleRate;
+
+        if (buffersReady.load())
+            allocateBuffers();
+    }
+
+    updateWorker();
+}
+
+void GateEventRenderer::updateWorker()
+{
+    if (needsWorker())
+        worker.startThread();
+    else
+        worker.stopThread(4000);
+}
+
+//==============================================================================
+void GateEventRenderer::beginEvent(juce::int64 timelinePosition, double startRatio, const RingBuffer<float>& history, int historyEnd,
+                                   int historyValidSamples, int preRoll, const juce::AudioBuffer<float>& onsetBlock)
+{
+    endEvent();
+
+    if (!enabled.load(std::memory_order_relaxed)
+        || !buffersReady.load(std::memory_order_acquire)
+        || releaseRequested.load(std::memory_order_acquire))
+        return;
+
+    // Without a timeline position there's nothing to find the render by next time
+    if (timelinePosition < 0)
+        return;
+
+    const double fingerprint = computeFingerprint(onsetBlock);
+
+    // A render of this event from an earlier pass? Claim each entry before looking at it,
+    // so the worker can't be rewriting it in the meantime.
+    for (auto& entry : cache)
+    {
+        int expected = entryReady;
+
+        if (!entry.state.compare_exchange_strong(expected, entryPlaying, std::memory_order_acq_rel))
+            continue;
+
+        if (entry.timelineStart == timelinePosition && entry.fingerprint == fingerprint
+            && std::abs(entry.startRatio - startRatio) < 1.0e-4)
+        {
+            playing = &entry;
+            playbackPos = 0;
+            playbackKeyFrame = 0;
+            liveInputPosition = 0.0;
+            return;
+        }
+
+        entry.state.store(entryReady, std::memory_order_release);
+    }
+
+    for (auto& capture : captures)
+    {
+        int expected = captureFree;
+
+        if (capture.state.compare_exchange_strong(expected, captureRecording, std::memory_order_acq_rel))
+        {
+            recording = &capture;
+            break;
+        }
+    }
+
+    // Both captures still waiting on the worker: this event stays live-only
+    if (recording == nullptr)
+        return;
+
+    auto& capture = *recording;
+    const int numSamples = onsetBlock.getNumSamples();
+    preRoll = juce::jlimit(0, maxPreRollSamples, preRoll);
+
+    // The live stretch's first output sample is the input preRoll samples before this
+    // block. Anything older than the history holds comes out of Rubber Band as silence.
+    const int missing = juce::jlimit(0, preRoll, preRoll - (historyValidSamples - numSamples));
+    const int start = historyEnd - numSamples - preRoll;
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        float* dest = capture.audio.getWritePointer(ch);
+        std::fill(dest, dest + missing, 0.0f);
+        history.read(ch, start + missing, dest + missing, preRoll - missing);
+    }
+
+    capture.numInputSamples = preRoll;
+    capture.numOutputSamples = 0;
+    capture.inputPosition = 0.0;
+    capture.timelineStart = timelinePosition;
+    capture.startRatio = startRatio;
+    capture.fingerprint = fingerprint;
+    capture.overflowed = false;
+    capture.keyFrames.clear();
+    capture.keyFrames.push_back({ 0.0, 0 });
+}
+
+void GateEventRenderer::recordBlock(const juce::AudioBuffer<float>& input, int numChannels, int numSamples, double timeRatio)
+{
+    const double inputAdvance = numSamples / timeRatio;
+
+    if (playing != nullptr)
+    {
+        liveInputPosition += inputAdvance;
+        return;
+    }
+
+    if (recording == nullptr || recording->overflowed)
+        return;
+
+    auto& capture = *recording;
+
+    if (capture.numInputSamples + numSamples > captureCapacity
+        || static_cast<int>(capture.keyFrames.size()) >= maxKeyFrames)
+    {
+        // Too long to keep; the rest of the event plays live only
+        capture.overflowed = true;
+        return;
+    }
+
+    // Mono input is duplicated, as it is for the live stretch
+    capture.audio.copyFrom(0, capture.numInputSamples, input, 0, 0, numSamples);
+    capture.audio.copyFrom(1, capture.numInputSamples, input, numChannels > 1 ? 1 : 0, 0, numSamples);
+
+    capture.numInputSamples += numSamples;
+    capture.numOutputSamples += numSamples;
+    capture.inputPosition += inputAdvance;
+
+    if (capture.numOutputSamples - capture.keyFrames.back().output >= keyFrameSpacing)
+        capture.keyFrames.push_back({ capture.inputPosition, capture.numOutputSamples });
+}
+
+void GateEventRenderer::replaceOutput(juce::AudioBuffer<float>& buffer, int numChannels, int numSamples)
+{
+    if (playing == nullptr)
+        return;
+
+    auto& entry = *playing;
+    const int available = std::min(numSamples, entry.length - playbackPos);
+
+    // recordBlock() has already advanced the live position over this block
+    const double renderedInput = interpolateInput(entry.keyFrames, playbackKeyFrame, playbackPos + numSamples);
+    const bool diverged = std::abs(liveInputPosition - renderedInput) > maxPositionError;
+
+    if (!diverged && available == numSamples)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.copyFrom(ch, 0, arena, ch, entry.arenaOffset + playbackPos, numSamples);
+
+        playbackPos += numSamples;
+        return;
+    }
+
+    // The live stretch no longer follows the render (a setting changed), or the event is
+    // running longer this time. Hand back to the live output across this block.
+    if (available > 0)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* dest = buffer.getWritePointer(ch);
+            const float* render = arena.getReadPointer(ch, entry.arenaOffset + playbackPos);
+
+            for (int i = 0; i < available; ++i)
+            {
+                const float t = static_cast<float>(i) / static_cast<float>(available);
+                dest[i] = render[i] * (1.0f - t) + dest[i] * t;
+            }
+        }
+    }
+
+    if (diverged)
+    {
+        // Stale; the next pass records the event afresh
+        entry.state.store(entryEmpty, std::memory_order_release);
+        numRenderedEvents.fetch_sub(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        entry.state.store(entryReady, std::memory_order_release);
+    }
+
+    playing = nullptr;
+}
+
+void GateEventRenderer::endEvent()
+{
+    if (playing != nullptr)
+    {
+        playing->state.store(entryReady, std::memory_order_release);
+        playing = nullptr;
+    }
+
+    if (recording != nullptr)
+    {
+        auto& capture = *recording;
+        recording = nullptr;
+
+        if (!capture.overflowed && capture.numOutputSamples >= minEventSamples)
+        {
+            if (capture.keyFrames.back().output != capture.numOutputSamples)
+                capture.keyFrames.push_back({ capture.inputPosition, capture.numOutputSamples });
+
+            capture.state.store(capturePending, std::memory_order_release);
+        }
+        else
+        {
+            capture.state.store(captureFree, std::memory_order_release);
+        }
+    }
+
+    // Between events is the only time the buffers can be let go
+    if (releaseRequested.load(std::memory_order_acquire))
+        releaseAcknowledged.store(true, std::memory_order_release);
+}
+
+double GateEventRenderer::computeFingerprint(const juce::AudioBuffer<float>& block)
+{
+    // Position-weighted sum: bit-identical input gives a bit-identical result, and a
+    // shifted or different onset almost never does
+    double sum = block.getNumSamples();
+
+    for (int ch = 0; ch < block.getNumChannels(); ++ch)
+    {
+        const float* data = block.getReadPointer(ch);
+
+        for (int i = 0; i < block.getNumSamples(); ++i)
+            sum += static_cast<double>(data[i]) * (1 + (i + ch * 17) % 61);
+    }
+
+    return sum;
+}
+
+double GateEventRenderer::interpolateInput(const std::vector<KeyFrame>& keyFrames, int& index, int output)
+{
+    const int last = static_cast<int>(keyFrames.size()) - 1;
+
+    while (index < last && keyFrames[static_cast<size_t>(index + 1)].output <= output)
+        ++index;
+
+    if (index >= last)
+        return keyFrames[static_cast<size_t>(last)].input;
+
+    const auto& a = keyFrames[static_cast<size_t>(index)];
+    const auto& b = keyFrames[static_cast<size_t>(index + 1)];
+    const double t = static_cast<double>(output - a.output) / static_cast<double>(b.output - a.output);
+
+    return a.input + (b.input - a.input) * t;
+}
+
+//==============================================================================
+void GateEventRenderer::Worker::run()
+{
+    // Polled rather than notified so the audio thread never touches a lock. Only runs
+    // while needsWorker() says so.
+    while (!threadShouldExit())
+    {
+        renderer.serviceWorker();
+        wait(50);
+    }
+}
+
+void GateEventRenderer::serviceWorker()
+{
+    const bool wanted = enabled.load(std::memory_order_relaxed);
+
+    if (wanted)
+    {
+        // Switched back on before the audio thread let go: carry on as before
+        releaseRequested.store(false, std::memory_order_release);
+        releaseAcknowledged.store(false, std::memory_order_relaxed);
+
+        if (!buffersReady.load(std::memory_order_relaxed))
+        {
+            allocateBuffers();
+            buffersReady.store(true, std::memory_order_release);
+        }
+    }
+    else
+    {
+        if (buffersReady.load(std::memory_order_relaxed))
+        {
+            if (!releaseRequested.load(std::memory_order_relaxed))
+            {
+                releaseRequested.store(true, std::memory_order_release);
+            }
+            else if (releaseAcknowledged.load(std::memory_order_acquire))
+            {
+                buffersReady.store(false, std::memory_order_release);
+                releaseBuffers();
+                releaseRequested.store(false, std::memory_order_release);
+                releaseAcknowledged.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        return;
+    }
+
+    for (auto& capture : captures)
+    {
+        if (worker.threadShouldExit())
+            return;
+
+        if (capture.state.load(std::memory_order_acquire) == capturePending)
+        {
+            renderCapture(capture);
+            capture.state.store(captureFree, std::memory_order_release);
+        }
+    }
+}
+
+void GateEventRenderer::allocateBuffers()
+{
+    captureCapacity = juce::roundToInt(sampleRate * maxEventSeconds) + maxPreRollSamples;
+    arenaCapacity = juce::roundToInt(sampleRate * arenaSeconds);
+    keyFrameSpacing = std::max(minKeyFrameSpacing, captureCapacity / (maxKeyFrames - 1) + 1);
+
+    for (auto& capture : captures)
+    {
+        capture.audio.setSize(2, captureCapacity);
+        capture.keyFrames.clear();
+        capture.keyFrames.reserve(static_cast<size_t>(maxKeyFrames) + 1);
+        capture.state.store(captureFree);
+    }
+
+    for (auto& entry : cache)
+    {
+        entry.keyFrames.clear();
+        entry.keyFrames.reserve(static_cast<size_t>(maxKeyFrames) + 1);
+        entry.state.store(entryEmpty);
+    }
+
+    arena.setSize(2, arenaCapacity);
+    arenaWritePos = 0;
+    numRenderedEvents.store(0);
+}
+
+void GateEventRenderer::releaseBuffers()
+{
+    for (auto& capture : captures)
+    {
+        capture.audio.setSize(0, 0);
+        std::vector<KeyFrame>().swap(capture.keyFrames);
+        capture.state.store(captureFree);
+    }
+
+    for (auto& entry : cache)
+    {
+        std::vector<KeyFrame>().swap(entry.keyFrames);
+        entry.state.store(entryEmpty);
+    }
+
+    arena.setSize(0, 0);
+    captureCapacity = 0;
+    arenaCapacity = 0;
+    arenaWritePos = 0;
+    numRenderedEvents.store(0);
+}
+
+void GateEventRenderer::renderCapture(Capture& capture)
+{
+    using Stretcher = RubberBand::RubberBandStretcher;
+
+    // Compressing can run ahead of the captured input (the live stretch rewinds through
+    // its history then), so the map is clamped to what was captured
+    const int outputLength = capture.numOutputSamples;
+    const int inputLength = juce::jlimit(1, capture.numInputSamples, static_cast<int>(std::ceil(capture.inputPosition)));
+
+    Stretcher stretcher(static_cast<size_t>(sampleRate), 2,
+                        Stretcher::OptionProcessOffline |
+                        Stretcher::OptionEngineFiner |
+                        Stretcher::OptionFormantPreserved,
+                        static_cast<double>(outputLength) / inputLength, 1.0);
+
+    constexpr int chunkSize = 4096;
+    stretcher.setExpectedInputDuration(static_cast<size_t>(inputLength));
+    stretcher.setMaxProcessSize(chunkSize);
+
+    const float* input[2];
+
+    for (int pos = 0; pos < inputLength; pos += chunkSize)
+    {
+        if (worker.threadShouldExit())
+            return;
+
+        const int n = std::min(chunkSize, inputLength - pos);
+        input[0] = capture.audio.getReadPointer(0, pos);
+        input[1] = capture.audio.getReadPointer(1, pos);
+        stretcher.study(input, static_cast<size_t>(n), pos + n >= inputLength);
+    }
+
+    // The live stretch's own input-to-output map, so the render lines up with it sample
+    // for sample wherever the ratio moved
+    std::map<size_t, size_t> keyFrameMap;
+    int lastInput = 0;
+
+    for (const auto& keyFrame : capture.keyFrames)
+    {
+        const int in = juce::jlimit(0, inputLength - 1, juce::roundToInt(keyFrame.input));
+
+        if (in > lastInput && keyFrame.output > 0 && keyFrame.output < outputLength)
+        {
+            keyFrameMap[static_cast<size_t>(in)] = static_cast<size_t>(keyFrame.output);
+            lastInput = in;
+        }
+    }
+
+    stretcher.setKeyFrameMap(keyFrameMap);
+
+    juce::AudioBuffer<float> render(2, outputLength);
+    juce::AudioBuffer<float> retrieved(2, chunkSize);
+    render.clear();
+    int written = 0;
+
+    auto drain = [&]
+    {
+        for (int available = stretcher.available(); available > 0; available = stretcher.available())
+        {
+            const int n = std::min(available, chunkSize);
+            stretcher.retrieve(retrieved.getArrayOfWritePointers(), static_cast<size_t>(n));
+
+            const int toCopy = std::min(n, outputLength - written);
+
+            for (int ch = 0; ch < 2 && toCopy > 0; ++ch)
+                render.copyFrom(ch, written, retrieved, ch, 0, toCopy);
+
+            written += std::max(0, toCopy);
+        }
+    };
+
+    for (int pos = 0; pos < inputLength; pos += chunkSize)
+    {
+        if (worker.threadShouldExit())
+            return;
+
+        const int n = std::min(chunkSize, inputLength - pos);
+        input[0] = capture.audio.getReadPointer(0, pos);
+        input[1] = capture.audio.getReadPointer(1, pos);
+        stretcher.process(input, static_cast<size_t>(n), pos + n >= inputLength);
+        drain();
+    }
+
+    drain();
+
+    // Anything Rubber Band came up short by stays silent, as an underrun would live
+    storeRender(capture, render, outputLength);
+}
+
+void GateEventRenderer::storeRender(const Capture& capture, const juce::AudioBuffer<float>& render, int length)
+{
+    if (length > arenaCapacity)
+        return;
+
+    auto evict = [this](CachedEvent& entry)
+    {
+        int expected = entryReady;
+
+        if (entry.state.compare_exchange_strong(expected, entryEmpty, std::memory_order_acq_rel))
+        {
+            numRenderedEvents.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return expected == entryEmpty;
+    };
+
+    // An earlier render of the same event is superseded
+    for (auto& entry : cache)
+        if (entry.state.load(std::memory_order_acquire) != entryEmpty && entry.timelineStart == capture.timelineStart)
+            evict(entry);
+
+    if (arenaWritePos + length > arenaCapacity)
+        arenaWritePos = 0;
+
+    const int start = arenaWritePos;
+    const int end = start + length;
+
+    // Oldest renders are overwritten first. One that's playing right now can't be,
+    // so this render is dropped instead.
+    for (auto& entry : cache)
+    {
+        if (entry.state.load(std::memory_order_acquire) == entryEmpty)
+            continue;
+
+        const bool overlaps = entry.arenaOffset < end && start < entry.arenaOffset + entry.length;
+
+        if (overlaps && !evict(entry))
+            return;
+    }
+
+    CachedEvent* target = nullptr;
+
+    for (auto& entry : cache)
+    {
+        if (entry.state.load(std::memory_order_acquire) == entryEmpty)
+        {
+            target = &entry;
+            break;
+        }
+    }
+
+    // Every entry is in use: take the one furthest behind the write position, which is
+    // the next to be overwritten anyway
+    if (target == nullptr)
+    {
+        for (auto& entry : cache)
+        {
+            if (entry.state.load(std::memory_order_acquire) != entryReady)
+                continue;
+
+            if (target == nullptr || (entry.arenaOffset - end + arenaCapacity) % arenaCapacity
+                                         < (target->arenaOffset - end + arenaCapacity) % arenaCapacity)
+                target = &entry;
+        }
+
+        if (target == nullptr || !evict(*target))
+            return;
+    }
+
+    for (int ch = 0; ch < 2; ++ch)
+        arena.copyFrom(ch, start, render, ch, 0, length);
+
+    target->timelineStart = capture.timelineStart;
+    target->startRatio = capture.startRatio;
+    target->fingerprint = capture.fingerprint;
+    target->arenaOffset = start;
+    target->length = length;
+    target->keyFrames = capture.keyFrames;
+    target->state.store(entryReady, std::memory_order_release);
+
+    numRenderedEvents.fetch_add(1, std::memory_order_relaxed);
+    arenaWritePos = end;
+}
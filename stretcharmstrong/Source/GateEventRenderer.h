@@ -0,0 +1,163 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <rubberband/RubberBandStretcher.h>
+#include "RingBuffer.h"
+#include <atomic>
+#include <vector>
+
+/**
+    Retrospective high-quality re-render of time-stretch gate events.
+
+    While enabled, every time-stretch event (envelope opening from standby until it
+    goes idle again) is captured along with the live stretch's input/output position
+    map. When the event ends a worker thread re-renders it with Rubber Band's offline
+    engine, following that map with key frames, and caches the result against the
+    host timeline position of the event's first block.
+
+    On a later pass (playback or offline bounce) an event starting at the same
+    timeline position with the same input plays the cached render in place of the
+    live stretch. Playback is checked against the live position map every block
+    and hands back to the live stretch with a short crossfade if they part, e.g.
+    because a setting changed. A pass at a different block size starts events at
+    different positions and simply uses the live stretch.
+
+    All buffers are allocated and freed on the worker thread. The audio thread only
+    copies samples and flips atomics.
+*/
+class GateEventRenderer
+{
+public:
+    GateEventRenderer();
+    ~GateEventRenderer();
+
+    /** Audio stopped, from whichever thread prepares the engine. Renders cached at another sample rate are dropped. */
+    void prepare(double sampleRate);
+
+    void setEnabled(bool shouldBeEnabled) { enabled.store(shouldBeEnabled, std::memory_order_relaxed); }
+
+    /** The worker only runs while enabled, or until it has freed the buffers after being
+        disabled. Safe to read from any thread; when it changes, call updateWorker() from
+        the message thread to start or stop it.
+    */
+    bool needsWorker() const { return enabled.load(std::memory_order_relaxed) || buffersReady.load(std::memory_order_relaxed); }
+    void updateWorker();
+
+    /** Number of events with a render ready to play, safe to read from any thread. */
+    int getNumRenderedEvents() const { return numRenderedEvents.load(std::memory_order_relaxed); }
+
+    // Audio thread --------------------------------------------------------------------
+
+    /** Starts an event whose first block ends at historyEnd in history. The live output's
+        first sample is the input preRoll samples before that block. The live stretch's
+        time ratio carries over from the previous event, so it's part of what has to match.
+    */
+    void beginEvent(juce::int64 timelinePosition, double startRatio, const RingBuffer<float>& history, int historyEnd,
+                    int historyValidSamples, int preRoll, const juce::AudioBuffer<float>& onsetBlock);
+
+    /** Call once per time-stretch block of the event with the input (before it's
+        overwritten) and the time ratio the live stretch used for it.
+    */
+    void recordBlock(const juce::AudioBuffer<float>& input, int numChannels, int numSamples, double timeRatio);
+
+    /** Swaps the live output for the cached render while one is playing. */
+    void replaceOutput(juce::AudioBuffer<float>& buffer, int numChannels, int numSamples);
+
+    /** Idempotent; call on every idle block so a disable request can be acknowledged. */
+    void endEvent();
+
+private:
+    struct KeyFrame
+    {
+        double input = 0.0;  // capture sample position
+        int output = 0;      // output samples since the event started
+    };
+
+    enum CaptureState { captureFree, captureRecording, capturePending };
+    enum EntryState { entryEmpty, entryReady, entryPlaying };
+
+    struct Capture
+    {
+        juce::AudioBuffer<float> audio;
+        std::vector<KeyFrame> keyFrames;
+        int numInputSamples = 0;
+        int numOutputSamples = 0;
+        double inputPosition = 0.0;
+        juce::int64 timelineStart = 0;
+        double startRatio = 1.0;
+        double fingerprint = 0.0;
+        bool overflowed = false;
+        std::atomic<int> state { captureFree };
+    };
+
+    struct CachedEvent
+    {
+        juce::int64 timelineStart = 0;
+        double startRatio = 1.0;
+        double fingerprint = 0.0;
+        int arenaOffset = 0;
+        int length = 0;
+        std::vector<KeyFrame> keyFrames;
+        std::atomic<int> state { entryEmpty };
+    };
+
+    class Worker : public juce::Thread
+    {
+    public:
+        explicit Worker(GateEventRenderer& r) : juce::Thread("StretchArmstrong Event Renderer"), renderer(r) {}
+        void run() override;
+
+    private:
+        GateEventRenderer& renderer;
+    };
+
+    static constexpr int numCaptures = 2;
+    static constexpr int numCachedEvents = 32;
+    static constexpr int maxKeyFrames = 4096;
+    static constexpr int minKeyFrameSpacing = 256;  // output samples between key frames
+    static constexpr int minEventSamples = 2048;    // shorter events aren't worth re-rendering
+    static constexpr int maxPreRollSamples = 16384;
+    static constexpr double maxEventSeconds = 20.0;
+    static constexpr double arenaSeconds = 45.0;
+    static constexpr double maxPositionError = 32.0; // input samples live and render may differ by
+
+    double sampleRate = 44100.0;
+    int captureCapacity = 0;
+    int arenaCapacity = 0;
+    int keyFrameSpacing = minKeyFrameSpacing;  // widened at high sample rates so a full-length event fits
+
+    Capture captures[numCaptures];
+    CachedEvent cache[numCachedEvents];
+    juce::AudioBuffer<float> arena;
+    int arenaWritePos = 0;
+
+    // Worker-side allocation handshake: buffers are only touched by the audio thread
+    // between buffersReady and its acknowledgement of releaseRequested
+    std::atomic<bool> enabled { false };
+    std::atomic<bool> buffersReady { false };
+    std::atomic<bool> releaseRequested { false };
+    std::atomic<bool> releaseAcknowledged { false };
+    std::atomic<int> numRenderedEvents { 0 };
+
+    // Audio thread state
+    Capture* recording = nullptr;
+    CachedEvent* playing = nullptr;
+    int playbackPos = 0;
+    int playbackKeyFrame = 0;
+    double liveInputPosition = 0.0;
+    bool playbackFading = false;
+
+    Worker worker { *this };
+
+    static double computeFingerprint(const juce::AudioBuffer<float>& block);
+    static double interpolateInput(const std::vector<KeyFrame>& keyFrames, int& index, int output);
+
+    // Worker thread
+    void serviceWorker();
+    void allocateBuffers();
+    void releaseBuffers();
+    void renderCapture(Capture& capture);
+    void storeRender(const Capture& capture, const juce::AudioBuffer<float>& render, int length);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GateEventRenderer)
+};
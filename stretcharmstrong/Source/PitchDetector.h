@@ -1,12 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include <vector>
+#include "YinPitchTracker.h"
 
 /**
- * YIN Pitch Detection Algorithm
- * Based on: http://audition.ens.fr/adc/pdf/2002_JASA_YIN.pdf
- * Adapted from: https://github.com/ashokfernandez/Yin-Pitch-Tracking
+ * Pitch follower for the stretch modulation. Input streams into the shared YIN
+ * tracker, which analyses at a fixed hop however small the host blocks are, so
+ * the cost per second is constant. Each hop is gated on its level and the
+ * estimate is smoothed into a steady control value.
  */
 class PitchDetector
 {
@@ -17,17 +18,20 @@ public:
     void prepare(double sampleRate, int maxBlockSize);
     float detectPitch(const float* inputBuffer, int numSamples, float threshold = 0.1f);
 
+    // Time between analyses (clamped to 1-100 ms)
+    void setHopTime(double seconds);
+
     // Get the probability/confidence of the last detected pitch (0.0 - 1.0)
     float getProbability() const { return probability; }
 
 private:
+    YinPitchTracker tracker;
     double sampleRate = 44100.0;
-    int bufferSize = 2048;
-    int halfBufferSize = 1024;
+    double hopSeconds = 0.01;
 
-    // YIN algorithm buffers
-    std::vector<float> yinBuffer;      // Stores intermediate YIN processing results
-    std::vector<float> inputAccumulator; // Accumulates input samples
+    // Level of the input since the last analysis
+    float hopSumOfSquares = 0.0f;
+    int hopSampleCount = 0;
 
     float probability = 0.0f;          // Confidence of detected pitch (0.0 - 1.0)
     float yinThreshold = 0.15f;        // YIN threshold (lower = stricter detection)
@@ -40,13 +44,4 @@ private:
     // Detection parameters
     static constexpr float minFrequency = 40.0f;   // 40 Hz minimum (bass range)
     static constexpr float maxFrequency = 1000.0f; // 1000 Hz maximum
-
-    // YIN algorithm steps
-    void yinDifference(const float* buffer);
-    void yinCumulativeMeanNormalizedDifference();
-    int yinAbsoluteThreshold();
-    float yinParabolicInterpolation(int tauEstimate);
-
-    // Core detection
-    float detectPitchYIN(const float* buffer, int bufferLength);
 };
@@ -18,6 +18,7 @@ StretchArmstrongAudioProcessorEditor::StretchArmstrongAudioProcessorEditor(Stret
     setupSlider(sustainSlider, sustainLabel, " ms");
     setupSlider(releaseSlider, releaseLabel, " ms");
     setupSlider(stretchRatioSlider, stretchRatioLabel, "x");
+    setupSlider(spectralRatioSlider, spectralRatioLabel, "x");
     setupSlider(mixSlider, mixLabel, "%");
     setupSlider(outputGainSlider, outputGainLabel, " dB");
 
@@ -32,6 +33,7 @@ StretchArmstrongAudioProcessorEditor::StretchArmstrongAudioProcessorEditor(Stret
     sustainSlider.setColour(juce::Slider::rotarySliderFillColourId, fleshTone);
     releaseSlider.setColour(juce::Slider::rotarySliderFillColourId, fleshTone);
     stretchRatioSlider.setColour(juce::Slider::rotarySliderFillColourId, stretchyPink);
+    spectralRatioSlider.setColour(juce::Slider::rotarySliderFillColourId, stretchyPink);
     mixSlider.setColour(juce::Slider::rotarySliderFillColourId, heroBlue);
     outputGainSlider.setColour(juce::Slider::rotarySliderFillColourId, heroBlue);
 
@@ -66,6 +68,7 @@ StretchArmstrongAudioProcessorEditor::StretchArmstrongAudioProcessorEditor(Stret
     // Stretch type combo box
     stretchTypeCombo.addItem("Varispeed", 1);
     stretchTypeCombo.addItem("Time Stretch", 2);
+    stretchTypeCombo.addItem("Spectral", 3);
     stretchTypeCombo.setSelectedId(2);
     stretchTypeCombo.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff2a2a2a));
     stretchTypeCombo.setColour(juce::ComboBox::textColourId, juce::Colours::white);
@@ -74,6 +77,55 @@ StretchArmstrongAudioProcessorEditor::StretchArmstrongAudioProcessorEditor(Stret
     stretchTypeLabel.setColour(juce::Label::textColourId, juce::Colour(0xffffffff));
     addAndMakeVisible(stretchTypeLabel);
 
+    // Varispeed quality combo box (only relevant in Varispeed mode)
+    varispeedQualityCombo.addItem("Cubic", 1);
+    varispeedQualityCombo.addItem("Sinc 8", 2);
+    varispeedQualityCombo.addItem("Sinc 16", 3);
+    varispeedQualityCombo.addItem("Sinc 32", 4);
+    varispeedQualityCombo.setSelectedId(3);
+    varispeedQualityCombo.setTooltip("Varispeed interpolation quality");
+    varispeedQualityCombo.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff2a2a2a));
+    varispeedQualityCombo.setColour(juce::ComboBox::textColourId, juce::Colours::white);
+    addAndMakeVisible(varispeedQualityCombo);
+
+    // Time-stretch quality combo box (shares the slot above, only relevant in Time Stretch mode)
+    stretchQualityCombo.addItem("Auto", 1);
+    stretchQualityCombo.addItem("Fast", 2);
+    stretchQualityCombo.addItem("Balanced", 3);
+    stretchQualityCombo.addItem("Finest", 4);
+    stretchQualityCombo.setSelectedId(1);
+    stretchQualityCombo.setTooltip("Time-stretch engine quality. Auto steps down while the stretcher is using too much CPU.");
+    stretchQualityCombo.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff2a2a2a));
+    stretchQualityCombo.setColour(juce::ComboBox::textColourId, juce::Colours::white);
+    addAndMakeVisible(stretchQualityCombo);
+
+    // Engine actually in use, and its share of each audio block
+    stretchStatusLabel.setJustificationType(juce::Justification::centred);
+    stretchStatusLabel.setColour(juce::Label::textColourId, juce::Colour(0xffaaaaaa));
+    stretchStatusLabel.setTooltip("Time-stretch engine in use and its CPU load per block, and with HQ Render on the number of events rendered");
+    addAndMakeVisible(stretchStatusLabel);
+
+    // Whole-plugin load, and whether silence is being skipped
+    loadLabel.setJustificationType(juce::Justification::centredRight);
+    loadLabel.setColour(juce::Label::textColourId, juce::Colour(0xffaaaaaa));
+    loadLabel.setTooltip("Processing time as a share of each block. Idle means the input is silent and processing is skipped.");
+    addAndMakeVisible(loadLabel);
+
+    // Spectral freeze toggle (shares the quality slot, only relevant in Spectral mode)
+    spectralFreezeButton.setColour(juce::ToggleButton::textColourId, juce::Colour(0xff88ddff));
+    spectralFreezeButton.setColour(juce::ToggleButton::tickColourId, juce::Colour(0xff88ddff));
+    spectralFreezeButton.setTooltip("Hold the spectrum at the trigger point for as long as the envelope is open");
+    addAndMakeVisible(spectralFreezeButton);
+
+    // Offline re-render of time-stretch events for the next pass or bounce
+    hqRenderButton.setColour(juce::ToggleButton::textColourId, juce::Colour(0xffe8c4a0));
+    hqRenderButton.setColour(juce::ToggleButton::tickColourId, juce::Colour(0xffff6b9d));
+    hqRenderButton.setTooltip("Re-render each time-stretch event at offline quality once it ends. "
+                              "Later passes over the same spot, including bounces, play the render.");
+    addAndMakeVisible(hqRenderButton);
+
+    stretchTypeCombo.onChange = [this] { updateStretchTypeControls(); };
+
     // Create attachments
     thresholdAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.parameters, "threshold", thresholdSlider);
@@ -85,8 +137,18 @@ StretchArmstrongAudioProcessorEditor::StretchArmstrongAudioProcessorEditor(Stret
         audioProcessor.parameters, "release", releaseSlider);
     stretchRatioAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.parameters, "stretchRatio", stretchRatioSlider);
+    spectralRatioAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.parameters, "spectralRatio", spectralRatioSlider);
+    spectralFreezeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.parameters, "spectralFreeze", spectralFreezeButton);
+    hqRenderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.parameters, "hqRender", hqRenderButton);
     stretchTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         audioProcessor.parameters, "stretchType", stretchTypeCombo);
+    varispeedQualityAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.parameters, "varispeedQuality", varispeedQualityCombo);
+    stretchQualityAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.parameters, "stretchQuality", stretchQualityCombo);
     mixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.parameters, "mix", mixSlider);
     outputGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
@@ -122,10 +184,59 @@ StretchArmstrongAudioProcessorEditor::StretchArmstrongAudioProcessorEditor(Stret
     setSize(950, 580);
     setResizable(true, true);
     setResizeLimits(800, 480, 1600, 1000);
+
+    updateStretchTypeControls();
+    startTimerHz(4);
 }
 
 StretchArmstrongAudioProcessorEditor::~StretchArmstrongAudioProcessorEditor()
 {
+    stopTimer();
+}
+
+void StretchArmstrongAudioProcessorEditor::updateStretchTypeControls()
+{
+    const bool varispeed = stretchTypeCombo.getSelectedId() == 1;
+    const bool timeStretch = stretchTypeCombo.getSelectedId() == 2;
+    const bool spectral = stretchTypeCombo.getSelectedId() == 3;
+
+    stretchRatioSlider.setVisible(!spectral);
+    stretchRatioLabel.setVisible(!spectral);
+    spectralRatioSlider.setVisible(spectral);
+    spectralRatioLabel.setVisible(spectral);
+
+    varispeedQualityCombo.setVisible(varispeed);
+    stretchQualityCombo.setVisible(timeStretch);
+    stretchStatusLabel.setVisible(timeStretch);
+    spectralFreezeButton.setVisible(spectral);
+}
+
+void StretchArmstrongAudioProcessorEditor::timerCallback()
+{
+    static const char* const qualityNames[] = { "Fast", "Balanced", "Finest" };
+
+    const auto status = audioProcessor.getStretchQualityStatus();
+    const int loadPercent = juce::roundToInt(status.load * 100.0f);
+
+    juce::String text = qualityNames[static_cast<int>(status.activeQuality)];
+    text << (status.switching ? " ..." : "") << " " << loadPercent << "%";
+
+    if (hqRenderButton.getToggleState())
+        text << " HQ " << audioProcessor.getNumRenderedEvents();
+
+    // Highlight when Auto has had to drop below Finest
+    const bool steppedDown = stretchQualityCombo.getSelectedId() == 1
+                          && status.activeQuality != StretchEngine::StretchQuality::Finest;
+
+    stretchStatusLabel.setColour(juce::Label::textColourId, steppedDown ? juce::Colour(0xffffaa00) : juce::Colour(0xffaaaaaa));
+    stretchStatusLabel.setText(text, juce::dontSendNotification);
+
+    juce::String loadText = "CPU " + juce::String(audioProcessor.getProcessLoad(), 1) + "%";
+
+    if (audioProcessor.isIdle())
+        loadText << " (idle)";
+
+    loadLabel.setText(loadText, juce::dontSendNotification);
 }
 
 void StretchArmstrongAudioProcessorEditor::setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& suffix)
@@ -234,6 +345,8 @@ void StretchArmstrongAudioProcessorEditor::resized()
     auto topBar = bounds.removeFromTop(static_cast<int>(topBarHeight));
     aboutButton.setBounds(topBar.removeFromRight(35).reduced(5));
     presetManager->setBounds(topBar.removeFromRight(static_cast<int>(w * 0.35f)).reduced(5));
+    hqRenderButton.setBounds(topBar.removeFromRight(110).reduced(5, 12));
+    loadLabel.setBounds(topBar.removeFromRight(110).reduced(5, 12));
 
     // Calculate control area proportions
     float controlsHeightRatio = 0.42f;
@@ -275,11 +388,17 @@ void StretchArmstrongAudioProcessorEditor::resized()
     // Stretch section
     stretchRatioLabel.setBounds(static_cast<int>(x), static_cast<int>(row1Y), static_cast<int>(knobSize), static_cast<int>(labelHeight));
     stretchRatioSlider.setBounds(static_cast<int>(x), static_cast<int>(row1Y + labelHeight), static_cast<int>(knobSize), static_cast<int>(knobSize));
+    spectralRatioLabel.setBounds(stretchRatioLabel.getBounds());
+    spectralRatioSlider.setBounds(stretchRatioSlider.getBounds());
     x += knobSize + spacing;
 
     float comboWidth = knobSize * 1.3f;
     stretchTypeLabel.setBounds(static_cast<int>(x), static_cast<int>(row1Y), static_cast<int>(comboWidth), static_cast<int>(labelHeight));
     stretchTypeCombo.setBounds(static_cast<int>(x), static_cast<int>(row1Y + labelHeight + knobSize * 0.3f), static_cast<int>(comboWidth), static_cast<int>(knobSize * 0.35f));
+    varispeedQualityCombo.setBounds(static_cast<int>(x), static_cast<int>(row1Y + labelHeight + knobSize * 0.7f), static_cast<int>(comboWidth), static_cast<int>(knobSize * 0.3f));
+    stretchQualityCombo.setBounds(static_cast<int>(x), static_cast<int>(row1Y + labelHeight + knobSize * 0.7f), static_cast<int>(comboWidth), static_cast<int>(knobSize * 0.3f));
+    spectralFreezeButton.setBounds(static_cast<int>(x), static_cast<int>(row1Y + labelHeight + knobSize * 0.7f), static_cast<int>(comboWidth), static_cast<int>(knobSize * 0.3f));
+    stretchStatusLabel.setBounds(static_cast<int>(x), static_cast<int>(row1Y + labelHeight + knobSize), static_cast<int>(comboWidth), static_cast<int>(labelHeight));
     x += comboWidth + spacing * 2;
 
     // Output section
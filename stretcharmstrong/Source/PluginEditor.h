@@ -5,7 +5,7 @@
 #include "WaveformVisualizer.h"
 #include "PresetManager.h"
 
-class StretchArmstrongAudioProcessorEditor : public juce::AudioProcessorEditor
+class StretchArmstrongAudioProcessorEditor : public juce::AudioProcessorEditor, private juce::Timer
 {
 public:
     StretchArmstrongAudioProcessorEditor(StretchArmstrongAudioProcessor&);
@@ -15,6 +15,8 @@ public:
     void resized() override;
 
 private:
+    void timerCallback() override;
+
     StretchArmstrongAudioProcessor& audioProcessor;
 
     // Waveform visualizer
@@ -29,7 +31,12 @@ private:
     juce::Slider sustainSlider;
     juce::Slider releaseSlider;
     juce::Slider stretchRatioSlider;
+    juce::Slider spectralRatioSlider;
     juce::ComboBox stretchTypeCombo;
+    juce::ComboBox varispeedQualityCombo;
+    juce::ComboBox stretchQualityCombo;
+    juce::ToggleButton spectralFreezeButton{"FREEZE"};
+    juce::ToggleButton hqRenderButton{"HQ RENDER"};
     juce::Slider mixSlider;
     juce::Slider outputGainSlider;
 
@@ -52,9 +59,12 @@ private:
     juce::Label sustainLabel{"", "Sustain"};
     juce::Label releaseLabel{"", "Release"};
     juce::Label stretchRatioLabel{"", "Stretch"};
+    juce::Label spectralRatioLabel{"", "Stretch"};
     juce::Label stretchTypeLabel{"", "Type"};
     juce::Label mixLabel{"", "Mix"};
     juce::Label outputGainLabel{"", "Output"};
+    juce::Label stretchStatusLabel;
+    juce::Label loadLabel;
 
     // Envelope follower labels
     juce::Label envFollowAmountLabel{"", "Amount"};
@@ -73,7 +83,12 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> sustainAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> releaseAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> stretchRatioAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> spectralRatioAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> spectralFreezeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> hqRenderAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> stretchTypeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> varispeedQualityAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> stretchQualityAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> mixAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> outputGainAttachment;
 
@@ -95,6 +110,7 @@ private:
 
     void setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& suffix = "");
     void showAboutWindow();
+    void updateStretchTypeControls();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StretchArmstrongAudioProcessorEditor)
 };
@@ -17,12 +17,15 @@ StretchArmstrongAudioProcessor::StretchArmstrongAudioProcessor()
     stretchEngine = std::make_unique<StretchEngine>();
     pitchDetector = std::make_unique<PitchDetector>();
 
-    inputVisualBuffer.resize(visualBufferSize, 0.0f);
-    outputVisualBuffer.resize(visualBufferSize, 0.0f);
+    waveformFeed.prepare(numWaveformLanes, visualNumBuckets, visualBufferSize / visualNumBuckets);
+
+    startTimerHz(20);
 }
 
 StretchArmstrongAudioProcessor::~StretchArmstrongAudioProcessor()
 {
+    stopTimer();
+    preparer.cancel();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout StretchArmstrongAudioProcessor::createParameterLayout()
@@ -59,10 +62,36 @@ juce::AudioProcessorValueTreeState::ParameterLayout StretchArmstrongAudioProcess
         juce::NormalisableRange<float>(0.1f, 4.0f, 0.01f, 0.5f), 2.0f,
         juce::AudioParameterFloatAttributes().withLabel("x")));
 
-    // Stretch type (0 = Varispeed, 1 = Time Stretch)
+    // Stretch type (0 = Varispeed, 1 = Time Stretch, 2 = Spectral)
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         juce::ParameterID("stretchType", 1), "Stretch Type",
-        juce::StringArray{"Varispeed", "Time Stretch"}, 1));
+        juce::StringArray{"Varispeed", "Time Stretch", "Spectral"}, 1));
+
+    // Spectral stretch ratio (1x to 100x), used instead of Stretch Ratio in Spectral mode
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("spectralRatio", 2), "Spectral Ratio",
+        juce::NormalisableRange<float>(1.0f, 100.0f, 0.01f, 0.3f), 8.0f,
+        juce::AudioParameterFloatAttributes().withLabel("x")));
+
+    // Spectral freeze - holds the spectrum at the trigger point while the envelope is open
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("spectralFreeze", 2), "Spectral Freeze", false));
+
+    // Varispeed interpolation quality (0 = Cubic, 1-3 = 8/16/32-tap sinc)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("varispeedQuality", 2), "Varispeed Quality",
+        juce::StringArray{"Cubic", "Sinc 8", "Sinc 16", "Sinc 32"}, 2));
+
+    // Time-stretch engine quality (0 = Auto, 1-3 = Fast/Balanced/Finest).
+    // Auto starts at Finest and steps down while the stretcher overruns its CPU budget.
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("stretchQuality", 2), "Stretch Quality",
+        juce::StringArray{"Auto", "Fast", "Balanced", "Finest"}, 0));
+
+    // Re-render each time-stretch event offline after it ends, and play the render on
+    // later passes over the same timeline position (playback or bounce)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("hqRender", 2), "HQ Re-render", false));
 
     // Mix (dry/wet)
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
@@ -187,18 +216,20 @@ void StretchArmstrongAudioProcessor::prepareToPlay(double sampleRate, int sample
 {
     currentSampleRate = sampleRate;
 
-    int stretchType = static_cast<int>(parameters.getRawParameterValue("stretchType")->load());
-    float stretchRatio = parameters.getRawParameterValue("stretchRatio")->load();
-
-    stretchEngine->prepare(sampleRate, samplesPerBlock,
-                          static_cast<StretchEngine::StretchType>(stretchType),
-                          stretchRatio);
+    // The engine's rings and stretchers are built in the background, and audio passes
+    // through, delayed, until they're ready. The latency is settled and reported here,
+    // where hosts look for it, except at a sample rate or block size no engine has run at
+    // yet: then the background job measures the stretchers and timerCallback() reports
+    // the result.
+    preparer.cancel();
+    configureStretchEngine(sampleRate, samplesPerBlock);
+    setLatencySamples(stretchEngine->getLatencySamples());
 
-    // Prepare pitch detector
-    pitchDetector->prepare(sampleRate, samplesPerBlock);
+    passthroughLatency = getLatencySamples();
+    passthroughDelay.setSize(2, passthroughLatency + samplesPerBlock);
+    passthroughWritePos = 0;
 
-    // Report latency
-    setLatencySamples(stretchEngine->getLatencySamples());
+    preparer.start([this, sampleRate, samplesPerBlock] { prepareEngines(sampleRate, samplesPerBlock); });
 
     // Reset envelope state
     envelopeState = EnvelopeState::Idle;
@@ -213,10 +244,82 @@ void StretchArmstrongAudioProcessor::prepareToPlay(double sampleRate, int sample
     slewedEnvFollower = 0.0f;
     pitchFollowerValue = 0.0f;
     slewedPitchFollower = 0.0f;
+
+    silenceTracker.prepare();
+    loadMeasurer.reset(sampleRate, samplesPerBlock);
+    sessionRecorder.prepare(*this, sampleRate, samplesPerBlock);
+}
+
+void StretchArmstrongAudioProcessor::configureStretchEngine(double sampleRate, int samplesPerBlock)
+{
+    int stretchType = static_cast<int>(parameters.getRawParameterValue("stretchType")->load());
+    float stretchRatio = parameters.getRawParameterValue("stretchRatio")->load();
+    int stretchQuality = static_cast<int>(parameters.getRawParameterValue("stretchQuality")->load());
+
+    // Prepare at the right quality up front rather than switching on the first block
+    setStretchEngineQuality(stretchQuality);
+    stretchEngine->configure(sampleRate, samplesPerBlock,
+                             static_cast<StretchEngine::StretchType>(stretchType),
+                             stretchRatio);
+}
+
+void StretchArmstrongAudioProcessor::prepareEngines(double sampleRate, int samplesPerBlock)
+{
+    // Settings may have moved since prepareToPlay(); if that moves the latency,
+    // timerCallback() reports it once this is done
+    configureStretchEngine(sampleRate, samplesPerBlock);
+    stretchEngine->prepare();
+
+    // Prepare pitch detector
+    pitchDetector->prepare(sampleRate, samplesPerBlock);
+}
+
+void StretchArmstrongAudioProcessor::delayPassthrough(juce::AudioBuffer<float>& buffer)
+{
+    const int numChannels = std::min(buffer.getNumChannels(), passthroughDelay.getNumChannels());
+    const int numSamples = buffer.getNumSamples();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        passthroughDelay.write(ch, passthroughWritePos, buffer.getReadPointer(ch), numSamples);
+        passthroughDelay.read(ch, passthroughWritePos - passthroughLatency, buffer.getWritePointer(ch), numSamples);
+    }
+
+    passthroughWritePos = passthroughDelay.wrap(passthroughWritePos + numSamples);
 }
 
 void StretchArmstrongAudioProcessor::releaseResources()
 {
+    preparer.cancel();
+    sessionRecorder.stop();
+}
+
+void StretchArmstrongAudioProcessor::setStretchEngineQuality(int stretchQualityChoice)
+{
+    // Choice 0 is Auto, which may use anything up to Finest
+    if (stretchQualityChoice == 0)
+        stretchEngine->setStretchQuality(StretchEngine::StretchQuality::Finest, true);
+    else
+        stretchEngine->setStretchQuality(static_cast<StretchEngine::StretchQuality>(stretchQualityChoice - 1), false);
+}
+
+void StretchArmstrongAudioProcessor::timerCallback()
+{
+    // Both are left until the engine is ready if it's being rebuilt; it starts its threads itself
+    if (! preparer.isReady())
+        return;
+
+    // Stretch type and ratio range changes move the latency (between events)
+    if (stretchEngine->getLatencySamples() != getLatencySamples())
+        setLatencySamples(stretchEngine->getLatencySamples());
+
+    const int wanted = stretchEngine->getWantedThreads();
+
+    if (wanted != startedEngineThreads)
+    {
+        startedEngineThreads = wanted;
+        stretchEngine->updateThreads();
+    }
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -244,12 +347,39 @@ void StretchArmstrongAudioProcessor::processBlock(juce::AudioBuffer<float>& buff
                                                    juce::MidiBuffer&)
 {
     juce::ScopedNoDenormals noDenormals;
+    juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer(loadMeasurer, buffer.getNumSamples());
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
+    sessionRecorder.recordBlock(buffer);
+
+    // Pass through until the engine is built, except when rendering offline
+    if (isNonRealtime())
+        preparer.waitUntilReady();
+
+    if (! preparer.isReady())
+    {
+        delayPassthrough(buffer);
+        return;
+    }
+
+    // Silence in, the envelope is closed and the stretcher has played out its history:
+    // skip detection, the envelope and the engine. A frozen spectrum keeps the output
+    // going, so it never idles.
+    silenceTracker.setTailLength(static_cast<int>(getTailLengthSeconds() * currentSampleRate) + stretchEngine->getLatencySamples());
+
+    if (silenceTracker.canSkipBlock(buffer, totalNumInputChannels, buffer.getNumSamples(), envelopeState == EnvelopeState::Idle))
+    {
+        buffer.clear();
+        currentSignalLevel.store(-100.0f);
+        currentEnvelopeValue.store(0.0f);
+        stretchActive.store(false);
+        return;
+    }
+
     // Get parameters
     float thresholdDb = parameters.getRawParameterValue("threshold")->load();
     float attackMs = parameters.getRawParameterValue("attack")->load();
@@ -257,6 +387,13 @@ void StretchArmstrongAudioProcessor::processBlock(juce::AudioBuffer<float>& buff
     float releaseMs = parameters.getRawParameterValue("release")->load();
     float stretchRatio = parameters.getRawParameterValue("stretchRatio")->load();
     int stretchType = static_cast<int>(parameters.getRawParameterValue("stretchType")->load());
+    const bool spectralMode = stretchType == static_cast<int>(StretchEngine::StretchType::Spectral);
+    if (spectralMode)
+        stretchRatio = parameters.getRawParameterValue("spectralRatio")->load();
+    int varispeedQuality = static_cast<int>(parameters.getRawParameterValue("varispeedQuality")->load());
+    int stretchQuality = static_cast<int>(parameters.getRawParameterValue("stretchQuality")->load());
+    bool spectralFreeze = parameters.getRawParameterValue("spectralFreeze")->load() > 0.5f;
+    bool hqRender = parameters.getRawParameterValue("hqRender")->load() > 0.5f;
     float mix = parameters.getRawParameterValue("mix")->load() / 100.0f;
     float outputGainDb = parameters.getRawParameterValue("outputGain")->load();
     float outputGain = juce::Decibels::decibelsToGain(outputGainDb);
@@ -355,15 +492,25 @@ void StretchArmstrongAudioProcessor::processBlock(juce::AudioBuffer<float>& buff
     // Base ratio is scaled by (1 + totalModulation)
     // This means 100% env at full level doubles the stretch effect
     float modulatedStretchRatio = 1.0f + (stretchRatio - 1.0f) * (1.0f + totalModulation);
-    modulatedStretchRatio = juce::jlimit(0.1f, 8.0f, modulatedStretchRatio); // Safety clamp
+    modulatedStretchRatio = juce::jlimit(0.1f, spectralMode ? SpectralStretcher::maxRatio : 8.0f, modulatedStretchRatio); // Safety clamp
 
     // Update stretch engine parameters
     stretchEngine->setStretchType(static_cast<StretchEngine::StretchType>(stretchType));
     stretchEngine->setStretchRatio(modulatedStretchRatio);
+    stretchEngine->setVarispeedQuality(static_cast<VarispeedResampler::Quality>(varispeedQuality));
+    setStretchEngineQuality(stretchQuality);
+    stretchEngine->setSpectralFreeze(spectralFreeze);
+    stretchEngine->setEventRenderingEnabled(hqRender);
+
+    // Timeline position renders are cached against; none while stopped
+    juce::int64 timelinePosition = -1;
+    if (auto* playHead = getPlayHead())
+        if (auto position = playHead->getPosition())
+            if (position->getIsPlaying() || isNonRealtime())
+                if (auto samples = position->getTimeInSamples())
+                    timelinePosition = *samples;
 
-    // Store dry signal
-    juce::AudioBuffer<float> dryBuffer;
-    dryBuffer.makeCopyOf(buffer);
+    stretchEngine->setTimelinePosition(timelinePosition);
 
     // Process each sample for threshold detection, envelope, and envelope follower
     for (int i = 0; i < numSamples; ++i)
@@ -476,22 +623,16 @@ void StretchArmstrongAudioProcessor::processBlock(juce::AudioBuffer<float>& buff
     stretchActive.store(envelopeValue > 0.01f);
     currentStretchRatio.store(stretchRatio);
 
-    // Store input for visualization
+    // Summarise input for visualization
     if (numChannels > 0)
-    {
-        const juce::ScopedLock sl(visualBufferLock);
-        const float* inputData = buffer.getReadPointer(0);
-        for (int i = 0; i < numSamples; ++i)
-        {
-            int writePos = (visualBufferWritePos.load() + i) % visualBufferSize;
-            inputVisualBuffer[static_cast<size_t>(writePos)] = inputData[i];
-        }
-    }
+        waveformFeed.push(inputLane, buffer.getReadPointer(0), numSamples);
 
     // Process through stretch engine with envelope
     stretchEngine->process(buffer, envelopeValue);
 
-    // Mix dry/wet and apply output gain
+    // Mix dry/wet and apply output gain. The dry signal is delayed to line up with the wet.
+    const auto& dryBuffer = stretchEngine->getDelayedDry();
+
     for (int ch = 0; ch < numChannels; ++ch)
     {
         float* wetData = buffer.getWritePointer(ch);
@@ -503,44 +644,14 @@ void StretchArmstrongAudioProcessor::processBlock(juce::AudioBuffer<float>& buff
         }
     }
 
-    // Store output for visualization
+    // Summarise output for visualization and hand it to the editor
     if (numChannels > 0)
     {
-        const juce::ScopedLock sl(visualBufferLock);
-        const float* outputData = buffer.getReadPointer(0);
-        for (int i = 0; i < numSamples; ++i)
-        {
-            int writePos = (visualBufferWritePos.load() + i) % visualBufferSize;
-            outputVisualBuffer[static_cast<size_t>(writePos)] = outputData[i];
-        }
-        visualBufferWritePos = (visualBufferWritePos.load() + numSamples) % visualBufferSize;
-    }
-}
-
-std::vector<float> StretchArmstrongAudioProcessor::getInputWaveform() const
-{
-    const juce::ScopedLock sl(visualBufferLock);
-    std::vector<float> result(visualBufferSize);
-    int readPos = visualBufferWritePos.load();
-
-    for (int i = 0; i < visualBufferSize; ++i)
-    {
-        result[static_cast<size_t>(i)] = inputVisualBuffer[static_cast<size_t>((readPos + i) % visualBufferSize)];
+        waveformFeed.push(outputLane, buffer.getReadPointer(0), numSamples);
+        waveformFeed.publish();
     }
-    return result;
-}
-
-std::vector<float> StretchArmstrongAudioProcessor::getOutputWaveform() const
-{
-    const juce::ScopedLock sl(visualBufferLock);
-    std::vector<float> result(visualBufferSize);
-    int readPos = visualBufferWritePos.load();
 
-    for (int i = 0; i < visualBufferSize; ++i)
-    {
-        result[static_cast<size_t>(i)] = outputVisualBuffer[static_cast<size_t>((readPos + i) % visualBufferSize)];
-    }
-    return result;
+    silenceTracker.blockProcessed(buffer, numChannels, numSamples);
 }
 
 bool StretchArmstrongAudioProcessor::hasEditor() const
@@ -3,10 +3,16 @@
 #include <JuceHeader.h>
 #include "StretchEngine.h"
 #include "PitchDetector.h"
+#include "WaveformSummaryFeed.h"
+#include "SilenceTracker.h"
+#include "BackgroundPreparer.h"
+#include "SessionRecorder.h"
+#include "RingBuffer.h"
 #include <atomic>
 #include <vector>
 
-class StretchArmstrongAudioProcessor : public juce::AudioProcessor
+class StretchArmstrongAudioProcessor : public juce::AudioProcessor,
+                                       private juce::Timer
 {
 public:
     StretchArmstrongAudioProcessor();
@@ -50,15 +56,51 @@ public:
     bool isStretching() const { return stretchActive.load(); }
     float getCurrentStretchRatio() const { return currentStretchRatio.load(); }
 
-    // Waveform data for visualization
-    std::vector<float> getInputWaveform() const;
-    std::vector<float> getOutputWaveform() const;
+    // Waveform overview for visualization: per-pixel peaks of the input and output lanes.
+    // Lock free, for a single reader (the visualizer).
+    enum WaveformLane { inputLane = 0, outputLane = 1, numWaveformLanes };
+    static constexpr int visualBufferSize = 4096;  // The last 4096 samples...
+    static constexpr int visualNumBuckets = 512;   // ...in 512 buckets
+    const WaveformSummaryFeed::Summary& readWaveformSummary() { return waveformFeed.read(); }
 
     // Latency reporting
     int getLatencySamples() const { return stretchEngine ? stretchEngine->getLatencySamples() : 0; }
 
+    // Time-stretch feed monitoring (output ring fill, underruns, history rewinds/skips)
+    StretchEngine::FeedStats getStretchFeedStats() const { return stretchEngine ? stretchEngine->getFeedStats() : StretchEngine::FeedStats(); }
+
+    // Time-stretch engine quality actually in use (may be below the parameter in Auto)
+    StretchEngine::QualityStatus getStretchQualityStatus() const { return stretchEngine ? stretchEngine->getQualityStatus() : StretchEngine::QualityStatus(); }
+
+    // Gate events with a high-quality render cached for the next pass
+    int getNumRenderedEvents() const { return stretchEngine ? stretchEngine->getNumRenderedEvents() : 0; }
+
+    // Whole-plugin processing time as a percentage of the block's duration, and whether silence is being skipped
+    float getProcessLoad() const { return static_cast<float>(loadMeasurer.getLoadAsPercentage()); }
+    bool isIdle() const { return silenceTracker.isIdle(); }
+
 private:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    void setStretchEngineQuality(int stretchQualityChoice);
+
+    // Passes the stretch settings to the engine, settling its latency
+    void configureStretchEngine(double sampleRate, int samplesPerBlock);
+
+    // The heavy half of prepareToPlay(), run by preparer
+    void prepareEngines(double sampleRate, int samplesPerBlock);
+
+    // Carries the input through while preparer runs, delayed by the latency reported
+    // in prepareToPlay() so it lines up with everything the host compensates
+    void delayPassthrough(juce::AudioBuffer<float>& buffer);
+    RingBuffer<float> passthroughDelay;
+    int passthroughLatency = 0;
+    int passthroughWritePos = 0;
+
+    // Passes engine latency changes on to the host, and starts or stops the engine's
+    // background threads as its settings want them. Polled on the message thread, since
+    // neither is safe from the audio thread.
+    void timerCallback() override;
+    int startedEngineThreads = 0;
 
     // Stretch engine
     std::unique_ptr<StretchEngine> stretchEngine;
@@ -99,12 +141,17 @@ private:
     // Processing state
     double currentSampleRate = 44100.0;
 
-    // Visualization buffers
-    static constexpr int visualBufferSize = 4096;
-    std::vector<float> inputVisualBuffer;
-    std::vector<float> outputVisualBuffer;
-    std::atomic<int> visualBufferWritePos{0};
-    mutable juce::CriticalSection visualBufferLock;
+    WaveformSummaryFeed waveformFeed;
+
+    // Idle detection and load measurement
+    SilenceTracker silenceTracker;
+    juce::AudioProcessLoadMeasurer loadMeasurer;
+
+    // Opt-in capture of the input and automation, for replaying sessions offline
+    SessionRecorder sessionRecorder;
+
+    // Last, so it stops before anything its job touches goes
+    BackgroundPreparer preparer { "StretchArmstrong Prepare" };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StretchArmstrongAudioProcessor)
 };
@@ -0,0 +1,212 @@
+#include "SpectralStretcher.h"
+#include <cmath>
+#include <algorithm>
+
+SpectralStretcher::SpectralStretcher()
+{
+    phasorCos.resize(phasorTableSize);
+    phasorSin.resize(phasorTableSize);
+
+    for (int i = 0; i < phasorTableSize; ++i)
+    {
+        const double phase = juce::MathConstants<double>::twoPi * i / phasorTableSize;
+        phasorCos[static_cast<size_t>(i)] = static_cast<float>(std::cos(phase));
+        phasorSin[static_cast<size_t>(i)] = static_cast<float>(std::sin(phase));
+    }
+}
+
+int SpectralStretcher::getFftOrder(double sampleRate)
+{
+    // ~85 ms analysis window (4096 at 44.1/48 kHz)
+    return juce::jlimit(10, 15, static_cast<int>(std::ceil(std::log2(sampleRate * 0.085))));
+}
+
+void SpectralStretcher::prepare(double sampleRate, int maxBlockSize)
+{
+    // Four-way overlap
+    fftOrder = getFftOrder(sampleRate);
+    windowSize = 1 << fftOrder;
+    hopSize = windowSize / 4;
+
+    fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+
+    // Periodic Hann so analysis x synthesis windows overlap-add to a constant
+    window.resize(static_cast<size_t>(windowSize));
+    for (int i = 0; i < windowSize; ++i)
+        window[static_cast<size_t>(i)] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * i / windowSize);
+
+    // Random phases spread each frame's windowed energy evenly across the frame, and
+    // overlapping frames then add incoherently. Scale so broadband input keeps its level.
+    double meanSquare = 0.0;
+    for (float w : window)
+        meanSquare += static_cast<double>(w) * w;
+    meanSquare /= windowSize;
+
+    double overlapSum = 0.0;
+    for (int i = 0; i < windowSize; i += hopSize)
+        overlapSum += static_cast<double>(window[static_cast<size_t>(i)]) * window[static_cast<size_t>(i)];
+
+    outputGain = static_cast<float>(1.0 / std::sqrt(meanSquare * overlapSum));
+
+    captureBuffer.setSize(2, captureSize);
+    fftBuffer.assign(static_cast<size_t>(windowSize) * 2, 0.0f);
+
+    magnitudes.resize(2);
+    overlapAdd.resize(2);
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        magnitudes[static_cast<size_t>(ch)].assign(static_cast<size_t>(windowSize / 2 + 1), 0.0f);
+        overlapAdd[static_cast<size_t>(ch)].assign(static_cast<size_t>(windowSize), 0.0f);
+    }
+
+    // Holds at most a block short of a request plus one hop, or the overlap-add pre-roll
+    outputFifo.setSize(2, maxBlockSize + windowSize);
+
+    reset();
+}
+
+void SpectralStretcher::reset()
+{
+    captureBuffer.clear();
+    inputCount = 0;
+    analysisPosition = -static_cast<double>(windowSize);
+    clearOutput();
+    idle = true;
+}
+
+void SpectralStretcher::clearOutput()
+{
+    for (auto& channel : overlapAdd)
+        std::fill(channel.begin(), channel.end(), 0.0f);
+
+    fifoReadPos = 0;
+    fifoWritePos = 0;
+    fifoAvailable = 0;
+    lastAnalysisStart = -1;
+}
+
+void SpectralStretcher::writeInput(const juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+    const int position = static_cast<int>(inputCount & (captureSize - 1));
+
+    captureBuffer.write(0, position, buffer.getReadPointer(0), numSamples);
+    captureBuffer.write(1, position, buffer.getReadPointer(buffer.getNumChannels() > 1 ? 1 : 0), numSamples);
+
+    inputCount += numSamples;
+}
+
+void SpectralStretcher::processStandby(const juce::AudioBuffer<float>& buffer)
+{
+    writeInput(buffer);
+
+    if (!idle)
+    {
+        clearOutput();
+        idle = true;
+    }
+
+    analysisPosition = static_cast<double>(inputCount - windowSize);
+}
+
+void SpectralStretcher::process(juce::AudioBuffer<float>& buffer, double increment)
+{
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = std::min(buffer.getNumChannels(), 2);
+
+    writeInput(buffer);
+
+    if (idle)
+    {
+        // Run the overlap-add up to full depth first, so output starts at full level
+        // rather than fading in over a window
+        analysisPosition -= static_cast<double>(windowSize - hopSize);
+
+        for (int hop = hopSize; hop < windowSize; hop += hopSize)
+            renderHop(1.0);
+
+        fifoReadPos = fifoWritePos;
+        fifoAvailable = 0;
+        idle = false;
+    }
+
+    while (fifoAvailable < numSamples)
+        renderHop(increment);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        outputFifo.read(ch, fifoReadPos, buffer.getWritePointer(ch), numSamples);
+
+    fifoReadPos = outputFifo.wrap(fifoReadPos + numSamples);
+    fifoAvailable -= numSamples;
+}
+
+void SpectralStretcher::renderHop(double increment)
+{
+    // The frame has to lie within what the capture ring still holds, and at or before
+    // the newest input (only reachable if the increment goes above 1)
+    const double newest = static_cast<double>(inputCount - windowSize);
+    const double oldest = static_cast<double>(inputCount - captureSize + hopSize);
+    analysisPosition = juce::jlimit(oldest, newest, analysisPosition);
+
+    const auto start = static_cast<juce::int64>(std::floor(analysisPosition));
+    const int numBins = windowSize / 2 + 1;
+
+    // Frozen (or stretched so far the frame hasn't moved a whole sample): reuse the spectrum
+    if (start != lastAnalysisStart)
+    {
+        const int readPos = static_cast<int>(start & (captureSize - 1));
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            captureBuffer.read(ch, readPos, fftBuffer.data(), windowSize);
+            juce::FloatVectorOperations::multiply(fftBuffer.data(), window.data(), windowSize);
+            std::fill(fftBuffer.begin() + windowSize, fftBuffer.end(), 0.0f);
+
+            fft->performFrequencyOnlyForwardTransform(fftBuffer.data(), true);
+            std::copy(fftBuffer.begin(), fftBuffer.begin() + numBins, magnitudes[static_cast<size_t>(ch)].begin());
+        }
+
+        lastAnalysisStart = start;
+    }
+
+    // One set of random phases for both channels keeps the stereo image intact
+    const juce::int64 phaseSeed = random.nextInt();
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        const float* magnitude = magnitudes[static_cast<size_t>(ch)].data();
+        juce::Random phases(phaseSeed);
+
+        // DC and Nyquist stay real
+        fftBuffer[0] = magnitude[0];
+        fftBuffer[1] = 0.0f;
+
+        for (int bin = 1; bin < numBins - 1; ++bin)
+        {
+            const int phase = phases.nextInt() & (phasorTableSize - 1);
+            fftBuffer[static_cast<size_t>(bin * 2)] = magnitude[bin] * phasorCos[static_cast<size_t>(phase)];
+            fftBuffer[static_cast<size_t>(bin * 2 + 1)] = magnitude[bin] * phasorSin[static_cast<size_t>(phase)];
+        }
+
+        fftBuffer[static_cast<size_t>((numBins - 1) * 2)] = magnitude[numBins - 1];
+        fftBuffer[static_cast<size_t>((numBins - 1) * 2 + 1)] = 0.0f;
+
+        fft->performRealOnlyInverseTransform(fftBuffer.data());
+
+        // Synthesis window and overlap-add. The first hop of the accumulator is then
+        // complete: shift it out to the FIFO.
+        auto& accumulator = overlapAdd[static_cast<size_t>(ch)];
+        for (int i = 0; i < windowSize; ++i)
+            accumulator[static_cast<size_t>(i)] += fftBuffer[static_cast<size_t>(i)] * window[static_cast<size_t>(i)] * outputGain;
+
+        outputFifo.write(ch, fifoWritePos, accumulator.data(), hopSize);
+
+        std::copy(accumulator.begin() + hopSize, accumulator.end(), accumulator.begin());
+        std::fill(accumulator.end() - hopSize, accumulator.end(), 0.0f);
+    }
+
+    fifoWritePos = outputFifo.wrap(fifoWritePos + hopSize);
+    fifoAvailable += hopSize;
+
+    analysisPosition += increment * hopSize;
+}
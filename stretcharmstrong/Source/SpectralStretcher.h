@@ -0,0 +1,88 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "RingBuffer.h"
+#include <memory>
+#include <vector>
+
+/**
+    Phase-randomising FFT stretcher (PaulStretch-style) for extreme ratios and freeze.
+
+    Each output hop takes the magnitude spectrum of a Hann-windowed analysis frame,
+    gives every bin a random phase, and overlap-adds the inverse transform. The
+    analysis position advances by an arbitrary increment per output sample, so 1.0
+    plays at the original speed, 0.01 stretches 100x and 0.0 freezes.
+
+    Output runs at a fixed cost of one hop per hopSize samples whatever the
+    increment. Frozen hops reuse the cached spectrum and skip the forward FFT.
+    Input is kept in a fixed-size capture ring, so a long stretch falls at most
+    captureSize samples behind the input before the analysis position is pulled
+    forward.
+
+    Latency is one analysis window. Everything is allocated in prepare().
+*/
+class SpectralStretcher
+{
+public:
+    static constexpr float maxRatio = 100.0f;
+
+    SpectralStretcher();
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    /** Consumes numSamples of input and replaces them with stretched output.
+        Mono is processed as two identical channels.
+    */
+    void process(juce::AudioBuffer<float>& buffer, double increment);
+
+    /** Records input without rendering, keeping the analysis position exactly one
+        window behind so output resumes in sync.
+    */
+    void processStandby(const juce::AudioBuffer<float>& buffer);
+
+    int getLatencySamples() const noexcept { return windowSize; }
+
+    /** What getLatencySamples() will be once prepared at sampleRate. */
+    static int getLatencySamplesAt(double sampleRate) { return 1 << getFftOrder(sampleRate); }
+
+private:
+    static constexpr int captureSize = 262144;  // ~5.5 s at 48 kHz; 100x that is over 9 minutes of output
+    static constexpr int phasorTableSize = 1024;
+
+    static int getFftOrder(double sampleRate);
+
+    int fftOrder = 12;
+    int windowSize = 4096;
+    int hopSize = 1024;
+    float outputGain = 1.0f;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> window;
+    std::vector<float> phasorCos, phasorSin;
+    juce::Random random { 0x5eed };
+
+    // Input capture. Positions are absolute sample counts.
+    RingBuffer<float> captureBuffer;
+    juce::int64 inputCount = 0;
+    double analysisPosition = 0.0;
+    juce::int64 lastAnalysisStart = -1;
+
+    // Spectral frame work space and the magnitude cache reused while frozen
+    std::vector<float> fftBuffer;
+    std::vector<std::vector<float>> magnitudes;
+
+    // Overlap-add accumulator, and the output FIFO completed hops drain into
+    std::vector<std::vector<float>> overlapAdd;
+    RingBuffer<float> outputFifo;
+    int fifoReadPos = 0;
+    int fifoWritePos = 0;
+    int fifoAvailable = 0;
+    bool idle = false;
+
+    void writeInput(const juce::AudioBuffer<float>& buffer);
+    void renderHop(double increment);
+    void clearOutput();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectralStretcher)
+};
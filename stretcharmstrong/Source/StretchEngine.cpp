@@ -8,28 +8,41 @@ StretchEngine::StretchEngine()
 
 StretchEngine::~StretchEngine()
 {
+    builderThread.stopThread(1000);
+
+    delete builtStretcher.exchange(nullptr);
+    delete retiredStretcher.exchange(nullptr);
 }
 
-void StretchEngine::prepare(double newSampleRate, int newMaxBlockSize, StretchType type, float ratio)
+std::unique_ptr<RubberBand::RubberBandStretcher> StretchEngine::createStretcher(StretchQuality quality) const
 {
-    sampleRate = newSampleRate;
-    maxBlockSize = newMaxBlockSize;
-    stretchType = type;
-    stretchRatio = ratio;
-    targetStretchRatio = ratio;
-    smoothedStretchRatio = 1.0f;
-
-    // Initialize Rubber Band for time-stretching
-    // Using OptionEngineFiner for better quality (R3 engine)
     RubberBand::RubberBandStretcher::Options options =
         RubberBand::RubberBandStretcher::OptionProcessRealTime |
-        RubberBand::RubberBandStretcher::OptionEngineFiner |
-        RubberBand::RubberBandStretcher::OptionWindowLong |
-        RubberBand::RubberBandStretcher::OptionSmoothingOn |
         RubberBand::RubberBandStretcher::OptionFormantPreserved |
         RubberBand::RubberBandStretcher::OptionPitchHighConsistency;
 
-    rubberBand = std::make_unique<RubberBand::RubberBandStretcher>(
+    switch (quality)
+    {
+        case StretchQuality::Fast:
+            // R2 engine: a fraction of the CPU, softer transients
+            options |= RubberBand::RubberBandStretcher::OptionEngineFaster |
+                       RubberBand::RubberBandStretcher::OptionWindowStandard |
+                       RubberBand::RubberBandStretcher::OptionSmoothingOn;
+            break;
+
+        case StretchQuality::Balanced:
+            options |= RubberBand::RubberBandStretcher::OptionEngineFiner |
+                       RubberBand::RubberBandStretcher::OptionWindowShort;
+            break;
+
+        case StretchQuality::Finest:
+            options |= RubberBand::RubberBandStretcher::OptionEngineFiner |
+                       RubberBand::RubberBandStretcher::OptionWindowLong |
+                       RubberBand::RubberBandStretcher::OptionSmoothingOn;
+            break;
+    }
+
+    auto stretcher = std::make_unique<RubberBand::RubberBandStretcher>(
         static_cast<size_t>(sampleRate),
         2, // stereo
         options,
@@ -37,38 +50,110 @@ void StretchEngine::prepare(double newSampleRate, int newMaxBlockSize, StretchTy
         1.0  // initial pitch scale
     );
 
-    rubberBand->setMaxProcessSize(static_cast<size_t>(maxBlockSize));
-    rubberBandPrimed = false;
-    primingSamplesNeeded = static_cast<int>(rubberBand->getLatency()) + maxBlockSize * 2;
-    primingSamplesFed = 0;
+    stretcher->setMaxProcessSize(static_cast<size_t>(maxBlockSize));
+    return stretcher;
+}
+
+void StretchEngine::resetSlot(StretcherSlot& slot)
+{
+    slot.primed = false;
+    slot.primingSamplesNeeded = slot.rubberBand ? static_cast<int>(slot.rubberBand->getLatency()) + maxBlockSize * 2 : 0;
+    slot.primingSamplesFed = 0;
+    slot.primingFillNeeded = targetRingFill;
+    slot.ringWritePos = 0;
+    slot.ringReadPos = 0;
+    slot.ringBufferAvailable = 0;
+    slot.historyBacklog = 0;
+    slot.outputToDiscard = 0;
+}
+
+void StretchEngine::configure(double newSampleRate, int newMaxBlockSize, StretchType type, float ratio)
+{
+    // Any switch in flight was for the old sample rate or block size
+    builderThread.stopThread(1000);
+    delete builtStretcher.exchange(nullptr);
+    delete retiredStretcher.exchange(nullptr);
+    requestedQuality.store(-1);
 
-    // Initialize output ring buffer for time stretching (per-channel positions)
-    outputRingBuffer.resize(2);
-    for (auto& channelBuffer : outputRingBuffer)
+    sampleRate = newSampleRate;
+    maxBlockSize = newMaxBlockSize;
+    stretchType = type;
+    stretchRatio = ratio;
+    targetStretchRatio = ratio;
+
+    // The output target keeps a spare block queued and never drops below Rubber Band's
+    // output granularity at small block sizes. It's also how far the output has to run
+    // behind Rubber Band's own latency.
+    targetRingFill = std::max(maxBlockSize * 2, 1024);
+
+    // Every tier's latency is needed up front so the reported latency can cover whichever
+    // one Auto ends up on. If these settings haven't been measured yet, prepare() does it.
+    lookUpStretcherLatencies();
+
+    // Automatic mode starts at its ceiling and steps down only if that proves too heavy
+    activeSlot = 0;
+    slots[0].quality = selectedQuality;
+
+    latencySamples = computeLatency();
+    statLatency.store(latencySamples, std::memory_order_relaxed);
+}
+
+void StretchEngine::prepare()
+{
+    // configure() may have had to go on other settings' stretcher latencies
+    measureStretcherLatencies();
+    latencySamples = computeLatency();
+    statLatency.store(latencySamples, std::memory_order_relaxed);
+
+    smoothedStretchRatio = 1.0f;
+
+    // Initialize Rubber Band for time-stretching at the selected quality
+    slots[0].rubberBand = createStretcher(selectedQuality);
+    slots[1].rubberBand.reset();
+
+    // Output ring buffers for time stretching, one per slot
+    for (auto& slot : slots)
     {
-        channelBuffer.resize(ringBufferSize, 0.0f);
+        slot.outputRingBuffer.setSize(2, ringBufferSize);
+        resetSlot(slot);
     }
-    ringWritePos.fill(0);
-    ringReadPos.fill(0);
-    ringBufferAvailable = 0;
+
+    switchState = SwitchState::Idle;
+    smoothedLoad = 0.0f;
+    overloadSeconds = 0.0;
+    underloadSeconds = 0.0;
+    secondsSinceSwitch = 0.0;
+
+    statActiveQuality.store(static_cast<int>(selectedQuality), std::memory_order_relaxed);
+    statSwitching.store(false, std::memory_order_relaxed);
+    statLoad.store(0.0f, std::memory_order_relaxed);
+
+    // Input history for the demand-driven feed
+    inputHistory.setSize(2, inputHistorySize);
+    historyWritePos = 0;
+    historyValidSamples = 0;
+    inStandby = true;
 
     // Initialize varispeed circular buffer
-    varispeedBuffer.resize(2);
-    for (auto& channelBuffer : varispeedBuffer)
-    {
-        channelBuffer.resize(varispeedBufferSize, 0.0f);
-    }
+    varispeedBuffer.setSize(2, varispeedBufferSize, true);
     varispeedReadPos = 0.0;
     varispeedWritePos = 0;
 
+    // Spectral stretcher for extreme ratios and freeze
+    spectralStretcher.prepare(sampleRate, maxBlockSize);
+
+    eventRenderer.prepare(sampleRate);
+
     // Initialize working buffers
     inputBuffers.resize(2);
     retrieveBuffers.resize(2);
+    switchBuffers.resize(2);
 
     for (int ch = 0; ch < 2; ++ch)
     {
         inputBuffers[ch].resize(static_cast<size_t>(maxBlockSize));
         retrieveBuffers[ch].resize(static_cast<size_t>(maxBlockSize * 8));
+        switchBuffers[ch].resize(static_cast<size_t>(maxBlockSize));
     }
 
     // Initialize crossfade buffer
@@ -82,32 +167,111 @@ void StretchEngine::prepare(double newSampleRate, int newMaxBlockSize, StretchTy
 
     currentEnvelope = 0.0f;
     previousEnvelope = 0.0f;
+
+    // The dry delay has to hold the longest latency any stretch type can ask for
+    const int maxTimeStretchLatency = *std::max_element(std::begin(stretcherLatencies), std::end(stretcherLatencies)) + targetRingFill;
+    const int maxVarispeedLatency = varispeedResampler.getMaxLatencySamples() + juce::roundToInt(sampleRate * varispeedLookaheadSeconds);
+    const int maxLatency = std::max({ maxTimeStretchLatency, maxVarispeedLatency, spectralStretcher.getLatencySamples() });
+
+    dryDelay.setSize(2, maxLatency + maxBlockSize);
+    dryDelayWritePos = 0;
+    delayedDry.setSize(2, maxBlockSize);
+    delayedDry.clear();
+
+    previousDryLatency = -1;
+    varispeedReadPos = varispeedBuffer.wrap(-latencySamples + varispeedResampler.getLatencySamples());
+
+    std::fill(std::begin(lastOutputSample), std::end(lastOutputSample), 0.0f);
+    underrunFallback = false;
+
+    updateWantedThreads();
+    updateThreads();
 }
 
-void StretchEngine::reset()
+bool StretchEngine::lookUpStretcherLatencies()
 {
-    if (rubberBand)
+    const juce::ScopedLock sl(latencyCache->lock);
+
+    for (const auto& entry : latencyCache->entries)
     {
-        rubberBand->reset();
+        if (entry.sampleRate == sampleRate && entry.maxBlockSize == maxBlockSize)
+        {
+            std::copy(std::begin(entry.latencies), std::end(entry.latencies), std::begin(stretcherLatencies));
+            return true;
+        }
     }
-    rubberBandPrimed = false;
-    primingSamplesFed = 0;
 
-    ringWritePos.fill(0);
-    ringReadPos.fill(0);
-    ringBufferAvailable = 0;
+    return false;
+}
+
+void StretchEngine::measureStretcherLatencies()
+{
+    if (lookUpStretcherLatencies())
+        return;
+
+    // The only way to ask Rubber Band for a tier's latency is to build a stretcher. That's
+    // done outside the lock so a configure() on the message thread never waits for it.
+    StretcherLatencyCache::Entry entry { sampleRate, maxBlockSize, {} };
+
+    for (int quality = 0; quality < 3; ++quality)
+        entry.latencies[quality] = static_cast<int>(createStretcher(static_cast<StretchQuality>(quality))->getLatency());
+
+    std::copy(std::begin(entry.latencies), std::end(entry.latencies), std::begin(stretcherLatencies));
+
+    // Another engine may have measured the same settings meanwhile
+    const juce::ScopedLock sl(latencyCache->lock);
+
+    const bool alreadyMeasured = std::any_of(latencyCache->entries.begin(), latencyCache->entries.end(), [&entry](const StretcherLatencyCache::Entry& other)
+    {
+        return other.sampleRate == entry.sampleRate && other.maxBlockSize == entry.maxBlockSize;
+    });
+
+    if (! alreadyMeasured)
+        latencyCache->entries.push_back(entry);
+}
+
+void StretchEngine::reset()
+{
+    // Output restarts from silence anyway, so a replacement that's already
+    // built takes over straight away instead of crossfading
+    if (switchState == SwitchState::Priming || switchState == SwitchState::Crossfading)
+        finishSwitch();
 
-    for (auto& channelBuffer : outputRingBuffer)
+    auto& slot = slots[activeSlot];
+
+    if (slot.rubberBand)
     {
-        std::fill(channelBuffer.begin(), channelBuffer.end(), 0.0f);
+        slot.rubberBand->reset();
     }
+    resetSlot(slot);
 
-    varispeedReadPos = 0.0;
+    slot.outputRingBuffer.clear();
+
+    historyWritePos = 0;
+    historyValidSamples = 0;
+    inputHistory.clear();
+    inStandby = true;
+    eventRenderer.endEvent();
+
+    statOutputFill.store(0, std::memory_order_relaxed);
+    statInputBacklog.store(0, std::memory_order_relaxed);
+
+    varispeedBuffer.clear();
     varispeedWritePos = 0;
 
+    spectralStretcher.reset();
+
     currentEnvelope = 0.0f;
     previousEnvelope = 0.0f;
     smoothedStretchRatio = 1.0f;
+    std::fill(std::begin(lastOutputSample), std::end(lastOutputSample), 0.0f);
+    underrunFallback = false;
+
+    // The dry path keeps running, only its delay moves to suit the new type
+    applyLatency(computeLatency());
+
+    // Varispeed may open on the very first block, so start the read head where standby would park it
+    varispeedReadPos = varispeedBuffer.wrap(varispeedWritePos - latencySamples + varispeedResampler.getLatencySamples());
 }
 
 void StretchEngine::setStretchType(StretchType type)
@@ -121,16 +285,115 @@ void StretchEngine::setStretchType(StretchType type)
 
 void StretchEngine::setStretchRatio(float ratio)
 {
-    targetStretchRatio = juce::jlimit(0.25f, 4.0f, ratio);
+    // The spectral stretcher only slows down, but goes far beyond what Rubber Band handles
+    if (stretchType == StretchType::Spectral)
+        targetStretchRatio = juce::jlimit(1.0f, SpectralStretcher::maxRatio, ratio);
+    else
+        targetStretchRatio = juce::jlimit(0.25f, 4.0f, ratio);
+}
+
+void StretchEngine::setStretchQuality(StretchQuality quality, bool automatic)
+{
+    if (selectedQuality == quality && automaticQuality == automatic)
+        return;
+
+    selectedQuality = quality;
+    automaticQuality = automatic;
+
+    // A deliberate choice starts the automatic backoff from scratch
+    overloadSeconds = 0.0;
+    underloadSeconds = 0.0;
+    upgradeHoldSeconds = minUpgradeHoldSeconds;
 }
 
-int StretchEngine::getLatencySamples() const
+int StretchEngine::computeLatency() const
 {
-    if (rubberBand && stretchType == StretchType::TimeStretch)
+    switch (stretchType)
+    {
+        case StretchType::TimeStretch:
+        {
+            // Rubber Band's latency plus the output ring target, for the worst tier this
+            // setting can run (Auto ranges from Fast up to the ceiling) or is still running,
+            // so switching tiers never needs more delay than is reported
+            const int lowest = automaticQuality ? 0 : static_cast<int>(selectedQuality);
+            int worst = stretcherLatencies[static_cast<int>(slots[activeSlot].quality)];
+
+            for (int quality = lowest; quality <= static_cast<int>(selectedQuality); ++quality)
+                worst = std::max(worst, stretcherLatencies[quality]);
+
+            return worst + targetRingFill;
+        }
+
+        case StretchType::Varispeed:
+        {
+            // The longest kernel's group delay, and lookahead to speed up into when the
+            // ratio is below 1 (the read head can't overtake the input)
+            const int lookahead = targetStretchRatio < 1.0f ? juce::roundToInt(sampleRate * varispeedLookaheadSeconds) : 0;
+            return varispeedResampler.getMaxLatencySamples() + lookahead;
+        }
+
+        case StretchType::Spectral:
+            return SpectralStretcher::getLatencySamplesAt(sampleRate);
+    }
+
+    return 0;
+}
+
+void StretchEngine::applyLatency(int newLatency)
+{
+    if (newLatency == latencySamples)
+        return;
+
+    previousDryLatency = latencySamples;
+    latencySamples = newLatency;
+    statLatency.store(latencySamples, std::memory_order_relaxed);
+}
+
+void StretchEngine::delayDry(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples)
+{
+    for (int ch = 0; ch < 2; ++ch)
+        dryDelay.write(ch, dryDelayWritePos, buffer.getReadPointer(numChannels > 1 ? ch : 0), numSamples);
+
+    for (int ch = 0; ch < numChannels; ++ch)
     {
-        return static_cast<int>(rubberBand->getLatency()) + 1024;
+        float* dest = delayedDry.getWritePointer(ch);
+        dryDelay.read(ch, dryDelayWritePos - latencySamples, dest, numSamples);
+
+        // The delay just changed: fade across from the old one over this block
+        if (previousDryLatency >= 0)
+        {
+            const int oldStart = dryDelayWritePos - previousDryLatency;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float t = static_cast<float>(i + 1) / static_cast<float>(numSamples);
+                dest[i] = dryDelay.getSample(ch, oldStart + i) * (1.0f - t) + dest[i] * t;
+            }
+        }
     }
-    return 256;
+
+    previousDryLatency = -1;
+    dryDelayWritePos = dryDelay.wrap(dryDelayWritePos + numSamples);
+}
+
+StretchEngine::FeedStats StretchEngine::getFeedStats() const
+{
+    FeedStats stats;
+    stats.outputFill = statOutputFill.load(std::memory_order_relaxed);
+    stats.inputBacklog = statInputBacklog.load(std::memory_order_relaxed);
+    stats.underruns = statUnderruns.load(std::memory_order_relaxed);
+    stats.inputRewinds = statInputRewinds.load(std::memory_order_relaxed);
+    stats.inputSkips = statInputSkips.load(std::memory_order_relaxed);
+    return stats;
+}
+
+StretchEngine::QualityStatus StretchEngine::getQualityStatus() const
+{
+    QualityStatus status;
+    status.activeQuality = static_cast<StretchQuality>(statActiveQuality.load(std::memory_order_relaxed));
+    status.switching = statSwitching.load(std::memory_order_relaxed);
+    status.load = statLoad.load(std::memory_order_relaxed);
+    return status;
 }
 
 void StretchEngine::process(juce::AudioBuffer<float>& buffer, float envelopeValue)
@@ -138,6 +401,18 @@ void StretchEngine::process(juce::AudioBuffer<float>& buffer, float envelopeValu
     previousEnvelope = currentEnvelope;
     currentEnvelope = currentEnvelope * envelopeSmoothingCoeff + envelopeValue * (1.0f - envelopeSmoothingCoeff);
 
+    const int blockChannels = std::min(buffer.getNumChannels(), 2);
+    const bool idle = currentEnvelope < 0.001f && previousEnvelope < 0.001f;
+
+    updateWantedThreads();
+
+    // Settings that move the latency (stretch type aside, which resets) only take effect
+    // between events, where nothing is in flight but the dry signal
+    if (idle)
+        applyLatency(computeLatency());
+
+    delayDry(buffer, blockChannels, buffer.getNumSamples());
+
     // Detect transitions for crossfade
     bool wasActive = previousEnvelope > 0.01f;
     bool isActive = currentEnvelope > 0.01f;
@@ -147,11 +422,10 @@ void StretchEngine::process(juce::AudioBuffer<float>& buffer, float envelopeValu
         needsCrossfade = true;
         crossfadeSamples = 0;
 
-        int numChannels = std::min(buffer.getNumChannels(), 2);
         int samplesToStore = std::min(buffer.getNumSamples(), crossfadeLength);
-        for (int ch = 0; ch < numChannels; ++ch)
+        for (int ch = 0; ch < blockChannels; ++ch)
         {
-            const float* src = buffer.getReadPointer(ch);
+            const float* src = delayedDry.getReadPointer(ch);
             for (int i = 0; i < samplesToStore; ++i)
             {
                 crossfadeBuffer[ch][i] = src[i];
@@ -160,8 +434,9 @@ void StretchEngine::process(juce::AudioBuffer<float>& buffer, float envelopeValu
     }
 
     // If envelope is essentially zero, pass through dry signal
-    if (currentEnvelope < 0.001f && previousEnvelope < 0.001f)
+    if (idle)
     {
+        processStandby(buffer);
         return;
     }
 
@@ -174,6 +449,10 @@ void StretchEngine::process(juce::AudioBuffer<float>& buffer, float envelopeValu
         case StretchType::TimeStretch:
             processTimeStretch(buffer, currentEnvelope);
             break;
+
+        case StretchType::Spectral:
+            processSpectral(buffer, currentEnvelope);
+            break;
     }
 
     // Apply crossfade if needed
@@ -218,49 +497,28 @@ void StretchEngine::processVarispeed(juce::AudioBuffer<float>& buffer, float env
 
     // Write input to circular buffer
     for (int ch = 0; ch < numChannels; ++ch)
-    {
-        const float* inputData = buffer.getReadPointer(ch);
-        auto& channelBuffer = varispeedBuffer[static_cast<size_t>(ch)];
+        varispeedBuffer.write(ch, varispeedWritePos, buffer.getReadPointer(ch), numSamples);
 
-        for (int i = 0; i < numSamples; ++i)
-        {
-            int writeIdx = (varispeedWritePos + i) % varispeedBufferSize;
-            channelBuffer[writeIdx] = inputData[i];
-        }
-    }
+    varispeedWritePos = varispeedBuffer.wrap(varispeedWritePos + numSamples);
 
-    // Read from circular buffer with interpolation
-    for (int ch = 0; ch < numChannels; ++ch)
-    {
-        float* outputData = buffer.getWritePointer(ch);
-        const auto& channelBuffer = varispeedBuffer[static_cast<size_t>(ch)];
+    // Speeding up eats into the lookahead. Once the read head reaches the newest input it
+    // can only keep pace with it.
+    const double headroom = varispeedBuffer.wrap(varispeedWritePos - static_cast<int>(std::floor(varispeedReadPos)));
+    playbackRate = std::min(playbackRate, headroom / numSamples);
 
-        double readPos = varispeedReadPos;
+    // Resample both channels in one pass, then fold the read position back into the buffer
+    double readPos = varispeedResampler.process(varispeedBuffer, varispeedReadPos, playbackRate,
+                                                buffer.getArrayOfWritePointers(), numChannels, numSamples);
 
-        for (int i = 0; i < numSamples; ++i)
-        {
-            while (readPos >= varispeedBufferSize)
-                readPos -= varispeedBufferSize;
-            while (readPos < 0)
-                readPos += varispeedBufferSize;
-
-            outputData[i] = hermiteInterpolate(channelBuffer.data(), varispeedBufferSize, readPos);
-            readPos += playbackRate;
-        }
-    }
-
-    varispeedWritePos = (varispeedWritePos + numSamples) % varispeedBufferSize;
-    varispeedReadPos += static_cast<double>(numSamples) * playbackRate;
-
-    while (varispeedReadPos >= varispeedBufferSize)
-        varispeedReadPos -= varispeedBufferSize;
-    while (varispeedReadPos < 0)
-        varispeedReadPos += varispeedBufferSize;
+    const double wholeSamples = std::floor(readPos);
+    varispeedReadPos = varispeedBuffer.wrap(static_cast<int>(wholeSamples)) + (readPos - wholeSamples);
 }
 
 void StretchEngine::processTimeStretch(juce::AudioBuffer<float>& buffer, float envelope)
 {
-    if (!rubberBand)
+    auto& slot = slots[activeSlot];
+
+    if (!slot.rubberBand)
         return;
 
     int numSamples = buffer.getNumSamples();
@@ -271,48 +529,47 @@ void StretchEngine::processTimeStretch(juce::AudioBuffer<float>& buffer, float e
     smoothedStretchRatio = smoothedStretchRatio * 0.998f + targetRatio * 0.002f;
 
     // Update Rubber Band time ratio
-    rubberBand->setTimeRatio(static_cast<double>(smoothedStretchRatio));
+    slot.rubberBand->setTimeRatio(static_cast<double>(smoothedStretchRatio));
 
-    // Copy input to working buffers
-    for (int ch = 0; ch < numChannels; ++ch)
-    {
-        const float* src = buffer.getReadPointer(ch);
-        std::copy(src, src + numSamples, inputBuffers[ch].begin());
-    }
+    // Queue the input, then feed Rubber Band as much as it asks for to keep the output ring topped up.
+    // Only the active stretcher's share of the block counts towards the automatic quality load.
+    writeToInputHistory(buffer, numChannels, numSamples);
 
-    // If mono, duplicate to stereo for Rubber Band
-    if (numChannels == 1)
+    if (inStandby)
     {
-        std::copy(inputBuffers[0].begin(), inputBuffers[0].begin() + numSamples, inputBuffers[1].begin());
+        restartFromHistory(numSamples);
+        eventRenderer.beginEvent(timelinePosition, static_cast<double>(smoothedStretchRatio), inputHistory, historyWritePos,
+                                 historyValidSamples, latencySamples, buffer);
     }
 
-    // Feed input to Rubber Band
-    const float* ptrs[2] = { inputBuffers[0].data(), inputBuffers[1].data() };
-    rubberBand->process(ptrs, static_cast<size_t>(numSamples), false);
+    eventRenderer.recordBlock(buffer, numChannels, numSamples, static_cast<double>(smoothedStretchRatio));
 
-    primingSamplesFed += numSamples;
+    const auto feedStart = juce::Time::getHighResolutionTicks();
+    feedRubberBand(slot, numSamples);
+    const double feedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - feedStart);
 
-    // Retrieve all available output
-    while (rubberBand->available() > 0)
+    if (switchState == SwitchState::Priming || switchState == SwitchState::Crossfading)
     {
-        int available = static_cast<int>(rubberBand->available());
-        int toRetrieve = std::min(available, static_cast<int>(retrieveBuffers[0].size()));
-
-        float* rptrs[2] = { retrieveBuffers[0].data(), retrieveBuffers[1].data() };
-        size_t retrieved = rubberBand->retrieve(rptrs, static_cast<size_t>(toRetrieve));
+        auto& pending = slots[1 - activeSlot];
+        pending.rubberBand->setTimeRatio(static_cast<double>(smoothedStretchRatio));
+        feedRubberBand(pending, numSamples);
 
-        if (retrieved > 0)
+        if (switchState == SwitchState::Priming && isPrimingComplete(pending, numSamples))
         {
-            writeToRingBuffer(retrieveBuffers[0].data(), retrieveBuffers[1].data(), static_cast<int>(retrieved));
+            pending.primed = true;
+            switchState = SwitchState::Crossfading;
+            switchCrossfadePos = 0;
         }
     }
 
+    updateQualitySwitch(numSamples, feedSeconds);
+
     // Check if we're still priming
-    if (!rubberBandPrimed)
+    if (!slot.primed)
     {
-        if (primingSamplesFed >= primingSamplesNeeded && ringBufferAvailable >= numSamples)
+        if (isPrimingComplete(slot, numSamples))
         {
-            rubberBandPrimed = true;
+            slot.primed = true;
         }
         else
         {
@@ -325,119 +582,494 @@ void StretchEngine::processTimeStretch(juce::AudioBuffer<float>& buffer, float e
                     dest[i] *= 0.0f; // Silence during priming
                 }
             }
+            std::fill(std::begin(lastOutputSample), std::end(lastOutputSample), 0.0f);
+            underrunFallback = false;
+            statOutputFill.store(slot.ringBufferAvailable, std::memory_order_relaxed);
+            eventRenderer.replaceOutput(buffer, numChannels, numSamples);
             return;
         }
     }
 
     // Read from ring buffer
-    if (ringBufferAvailable >= numSamples)
+    if (slot.ringBufferAvailable >= numSamples)
     {
-        readFromRingBuffer(buffer.getWritePointer(0),
+        readFromRingBuffer(slot, buffer.getWritePointer(0),
                           numChannels > 1 ? buffer.getWritePointer(1) : nullptr,
                           numSamples, numChannels);
-    }
-    else
-    {
-        // Buffer underrun - blend with dry signal
-        int available = ringBufferAvailable;
 
-        if (available > 0)
+        // Recovering from an underrun: fade back in from the dry signal
+        if (underrunFallback)
         {
-            // Temp buffers for what we have
-            std::vector<float> tempL(available), tempR(available);
-            readFromRingBuffer(tempL.data(), tempR.data(), available, 2);
-
+            const int fadeLen = std::min(128, numSamples);
             for (int ch = 0; ch < numChannels; ++ch)
             {
                 float* dest = buffer.getWritePointer(ch);
-                const float* temp = (ch == 0) ? tempL.data() : tempR.data();
-                const float* dry = buffer.getReadPointer(ch);
-
-                // Output what we have
-                for (int i = 0; i < available; ++i)
-                {
-                    dest[i] = temp[i];
-                }
-
-                // Crossfade to dry for the rest
-                int fadeLen = std::min(128, numSamples - available);
+                const float* dry = delayedDry.getReadPointer(ch);
                 for (int i = 0; i < fadeLen; ++i)
                 {
-                    float t = static_cast<float>(i) / static_cast<float>(fadeLen);
-                    int idx = available + i;
-                    dest[idx] = dry[idx] * t;
+                    const float t = static_cast<float>(i + 1) / static_cast<float>(fadeLen);
+                    dest[i] = dry[i] + (dest[i] - dry[i]) * t;
                 }
+            }
+            underrunFallback = false;
+        }
+    }
+    else
+    {
+        // Buffer underrun - play what's left, then fall back to the delayed dry signal
+        statUnderruns.fetch_add(1, std::memory_order_relaxed);
+        const int available = slot.ringBufferAvailable;
 
-                // Dry signal for remainder
-                for (int i = available + fadeLen; i < numSamples; ++i)
-                {
-                    dest[i] = dry[i];
-                }
+        readFromRingBuffer(slot, buffer.getWritePointer(0),
+                          numChannels > 1 ? buffer.getWritePointer(1) : nullptr,
+                          available, numChannels);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* dest = buffer.getWritePointer(ch);
+            const float* dry = delayedDry.getReadPointer(ch);
+
+            // Crossfade from the last wet sample (this block's or the previous one's) to dry
+            const float from = available > 0 ? dest[available - 1] : lastOutputSample[ch];
+            const int fadeLen = std::min(128, numSamples - available);
+            for (int i = 0; i < fadeLen; ++i)
+            {
+                const float t = static_cast<float>(i + 1) / static_cast<float>(fadeLen);
+                const int idx = available + i;
+                dest[idx] = from + (dry[idx] - from) * t;
+            }
+
+            // Dry signal for remainder
+            for (int i = available + fadeLen; i < numSamples; ++i)
+            {
+                dest[i] = dry[i];
             }
         }
+
+        underrunFallback = true;
     }
+
+    if (numSamples > 0)
+        for (int ch = 0; ch < numChannels; ++ch)
+            lastOutputSample[ch] = buffer.getSample(ch, numSamples - 1);
+
+    statOutputFill.store(slot.ringBufferAvailable, std::memory_order_relaxed);
+
+    if (switchState == SwitchState::Crossfading)
+        mixSwitchCrossfade(buffer, numChannels, numSamples);
+
+    eventRenderer.replaceOutput(buffer, numChannels, numSamples);
 }
 
-void StretchEngine::writeToRingBuffer(const float* dataL, const float* dataR, int numSamples)
+void StretchEngine::processSpectral(juce::AudioBuffer<float>& buffer, float envelope)
 {
-    if (numSamples <= 0)
-        return;
+    // Smoothly interpolate stretch ratio
+    float targetRatio = 1.0f + (targetStretchRatio - 1.0f) * envelope;
+    smoothedStretchRatio = smoothedStretchRatio * 0.995f + targetRatio * 0.005f;
 
-    for (int i = 0; i < numSamples; ++i)
+    double increment = 1.0 / static_cast<double>(smoothedStretchRatio);
+
+    // Freeze brings the analysis position to a stop as the envelope opens
+    if (spectralFreeze)
+        increment *= 1.0 - static_cast<double>(envelope);
+
+    spectralStretcher.process(buffer, increment);
+}
+
+void StretchEngine::processStandby(juce::AudioBuffer<float>& buffer)
+{
+    int numSamples = buffer.getNumSamples();
+    int numChannels = std::min(buffer.getNumChannels(), 2);
+
+    if (stretchType == StretchType::Varispeed)
     {
-        int writePos = (ringWritePos[0] + i) % ringBufferSize;
-        outputRingBuffer[0][writePos] = dataL[i];
-        outputRingBuffer[1][writePos] = dataR[i];
+        // Keep writing, and park the read head so playback at 1x from it comes out exactly
+        // latencySamples late when the envelope opens, whatever the last event left it at
+        for (int ch = 0; ch < numChannels; ++ch)
+            varispeedBuffer.write(ch, varispeedWritePos, buffer.getReadPointer(ch), numSamples);
+
+        varispeedWritePos = varispeedBuffer.wrap(varispeedWritePos + numSamples);
+        varispeedReadPos = varispeedBuffer.wrap(varispeedWritePos - latencySamples + varispeedResampler.getLatencySamples());
+    }
+    else if (stretchType == StretchType::Spectral)
+    {
+        spectralStretcher.processStandby(buffer);
+    }
+    else
+    {
+        // Rubber Band isn't touched while idle. Whatever it and the output ring still hold
+        // is stale by the time the envelope opens, so the next active block restarts it.
+        writeToInputHistory(buffer, numChannels, numSamples);
+        inStandby = true;
+        eventRenderer.endEvent();
     }
 
-    ringWritePos[0] = (ringWritePos[0] + numSamples) % ringBufferSize;
-    ringWritePos[1] = ringWritePos[0]; // Keep in sync
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        buffer.copyFrom(ch, 0, delayedDry, ch, 0, numSamples);
+        if (numSamples > 0)
+            lastOutputSample[ch] = delayedDry.getSample(ch, numSamples - 1);
+    }
+}
 
-    ringBufferAvailable = std::min(ringBufferAvailable + numSamples, ringBufferSize);
+void StretchEngine::restartFromHistory(int numSamples)
+{
+    inStandby = false;
+
+    if (switchState == SwitchState::Priming || switchState == SwitchState::Crossfading)
+        finishSwitch();
+
+    auto& slot = slots[activeSlot];
+    slot.rubberBand->reset();
+    resetSlot(slot);
+
+    // Burst-feed the reported latency's worth of pre-roll plus this block and drop Rubber
+    // Band's start delay, so the first output sample is the input from exactly the reported
+    // latency ago. That also bounds the burst. Covering this block is enough to start.
+    // History not written yet since a reset reads as silence.
+    slot.historyBacklog = std::min(inputHistorySize, latencySamples + numSamples);
+    slot.outputToDiscard = static_cast<int>(slot.rubberBand->getLatency());
+    slot.primingSamplesNeeded = 0;
+    slot.primingFillNeeded = numSamples;
 }
 
-void StretchEngine::readFromRingBuffer(float* dataL, float* dataR, int numSamples, int numChannels)
+bool StretchEngine::isPrimingComplete(const StretcherSlot& slot, int numSamples) const
 {
-    if (numSamples <= 0)
+    // Fed past the start delay, or the ring is already full and feeding has stopped
+    // (waiting on the sample count then would never end)
+    return slot.ringBufferAvailable >= std::max(numSamples, slot.primingFillNeeded)
+        && (slot.primingSamplesFed >= slot.primingSamplesNeeded || slot.ringBufferAvailable >= targetRingFill);
+}
+
+void StretchEngine::updateThreads()
+{
+    if ((wantedThreads.load(std::memory_order_relaxed) & builderThreadWanted) != 0)
+        builderThread.startThread();
+    else
+        builderThread.stopThread(1000);
+
+    eventRenderer.updateWorker();
+}
+
+void StretchEngine::updateWantedThreads()
+{
+    // A manual change of tier is a switch about to start. The builder also frees the
+    // stretcher a switch retires, so it stays up until that's done.
+    int wanted = 0;
+
+    if (automaticQuality || selectedQuality != slots[activeSlot].quality
+        || switchState != SwitchState::Idle || retiredStretcher.load() != nullptr)
+        wanted |= builderThreadWanted;
+
+    if (eventRenderer.needsWorker())
+        wanted |= rendererThreadWanted;
+
+    wantedThreads.store(wanted, std::memory_order_relaxed);
+}
+
+void StretchEngine::StretcherBuilder::run()
+{
+    // Polled rather than notified so the audio thread never touches a lock. Only runs
+    // while Auto is selected or a switch is in flight; see updateThreads().
+    while (!threadShouldExit())
+    {
+        engine.serviceBuilder();
+        wait(20);
+    }
+}
+
+void StretchEngine::serviceBuilder()
+{
+    delete retiredStretcher.exchange(nullptr);
+
+    const int quality = requestedQuality.exchange(-1);
+
+    if (quality >= 0)
+    {
+        jassert(builtStretcher.load() == nullptr);
+        builtStretcher.store(createStretcher(static_cast<StretchQuality>(quality)).release());
+    }
+}
+
+void StretchEngine::updateQualitySwitch(int numSamples, double elapsedSeconds)
+{
+    const double blockSeconds = numSamples / sampleRate;
+    secondsSinceSwitch += blockSeconds;
+
+    if (switchState == SwitchState::Building)
+    {
+        if (auto* built = builtStretcher.exchange(nullptr))
+            beginPriming(built);
+    }
+
+    // Two stretchers run during a switch, so its blocks say nothing about either one
+    if (switchState != SwitchState::Idle)
+        return;
+
+    const float blockLoad = static_cast<float>(elapsedSeconds / blockSeconds);
+    const float smoothing = static_cast<float>(1.0 - std::exp(-blockSeconds / 0.3));
+    smoothedLoad += (blockLoad - smoothedLoad) * smoothing;
+    statLoad.store(smoothedLoad, std::memory_order_relaxed);
+
+    const StretchQuality current = slots[activeSlot].quality;
+    StretchQuality target = selectedQuality;
+
+    if (automaticQuality)
+    {
+        overloadSeconds = smoothedLoad > stretchLoadBudget ? overloadSeconds + blockSeconds : 0.0;
+        underloadSeconds = smoothedLoad < upgradeLoadThreshold ? underloadSeconds + blockSeconds : 0.0;
+
+        target = std::min(current, selectedQuality);
+
+        if (target == current && current != StretchQuality::Fast && overloadSeconds >= overloadHoldSeconds)
+        {
+            target = static_cast<StretchQuality>(static_cast<int>(current) - 1);
+
+            // Falling straight back from an upgrade means that tier can't be held here
+            if (lastSwitchWasUpgrade && secondsSinceSwitch < upgradeHoldSeconds)
+                upgradeHoldSeconds = std::min(upgradeHoldSeconds * 2.0, maxUpgradeHoldSeconds);
+        }
+        else if (target == current && current < selectedQuality && underloadSeconds >= upgradeHoldSeconds)
+        {
+            target = static_cast<StretchQuality>(static_cast<int>(current) + 1);
+        }
+    }
+
+    // The retired instance has to be collected before there's room for another
+    if (target == current || retiredStretcher.load() != nullptr)
         return;
 
-    int toRead = std::min(numSamples, ringBufferAvailable);
+    lastSwitchWasUpgrade = target > current;
+    pendingQuality = target;
+    requestedQuality.store(static_cast<int>(target));
+    switchState = SwitchState::Building;
+    statSwitching.store(true, std::memory_order_relaxed);
+}
 
-    for (int i = 0; i < toRead; ++i)
+void StretchEngine::beginPriming(RubberBand::RubberBandStretcher* stretcher)
+{
+    const auto& active = slots[activeSlot];
+    auto& pending = slots[1 - activeSlot];
+
+    pending.rubberBand.reset(stretcher);
+    pending.quality = pendingQuality;
+    resetSlot(pending);
+
+    // Start far enough back in the input history that, with the replacement's own start
+    // delay dropped, its first output is roughly what the active slot is about to play
+    // That's normally within the reported latency. A manual step up mid-event can need
+    // more to keep the ring filled; the reported latency catches up at the next idle block.
+    const int activeDelay = static_cast<int>(active.rubberBand->getLatency()) + active.ringBufferAvailable;
+    const int requiredDelay = stretcherLatencies[static_cast<int>(pendingQuality)] + targetRingFill;
+    pending.historyBacklog = std::min(std::max(active.historyBacklog + activeDelay, requiredDelay), inputHistorySize);
+    pending.outputToDiscard = static_cast<int>(pending.rubberBand->getLatency());
+
+    switchState = SwitchState::Priming;
+}
+
+void StretchEngine::finishSwitch()
+{
+    auto& old = slots[activeSlot];
+
+    // Freed on the builder thread. Nothing else can be waiting in the mailbox,
+    // since a build is only requested once the previous retiree was collected.
+    jassert(retiredStretcher.load() == nullptr);
+    retiredStretcher.store(old.rubberBand.release());
+    resetSlot(old);
+
+    activeSlot = 1 - activeSlot;
+    auto& slot = slots[activeSlot];
+    slot.primed = true;
+
+    switchState = SwitchState::Idle;
+    smoothedLoad = 0.0f;
+    overloadSeconds = 0.0;
+    underloadSeconds = 0.0;
+    secondsSinceSwitch = 0.0;
+
+    statActiveQuality.store(static_cast<int>(slot.quality), std::memory_order_relaxed);
+    statSwitching.store(false, std::memory_order_relaxed);
+}
+
+void StretchEngine::mixSwitchCrossfade(juce::AudioBuffer<float>& buffer, int numChannels, int numSamples)
+{
+    auto& pending = slots[1 - activeSlot];
+
+    std::fill(switchBuffers[0].begin(), switchBuffers[0].begin() + numSamples, 0.0f);
+    std::fill(switchBuffers[1].begin(), switchBuffers[1].begin() + numSamples, 0.0f);
+    readFromRingBuffer(pending, switchBuffers[0].data(), switchBuffers[1].data(), numSamples, 2);
+
+    const int startPos = switchCrossfadePos;
+
+    for (int ch = 0; ch < numChannels; ++ch)
     {
-        int readPos = (ringReadPos[0] + i) % ringBufferSize;
-        dataL[i] = outputRingBuffer[0][readPos];
-        if (dataR && numChannels > 1)
+        float* output = buffer.getWritePointer(ch);
+        const float* incoming = switchBuffers[static_cast<size_t>(ch)].data();
+
+        for (int i = 0; i < numSamples; ++i)
         {
-            dataR[i] = outputRingBuffer[1][readPos];
+            const int pos = startPos + i;
+
+            if (pos >= switchCrossfadeLength)
+            {
+                output[i] = incoming[i];
+                continue;
+            }
+
+            // Equal power crossfade
+            const float t = static_cast<float>(pos) / static_cast<float>(switchCrossfadeLength);
+            output[i] = output[i] * std::cos(t * juce::MathConstants<float>::halfPi)
+                      + incoming[i] * std::sin(t * juce::MathConstants<float>::halfPi);
         }
     }
 
-    ringReadPos[0] = (ringReadPos[0] + toRead) % ringBufferSize;
-    ringReadPos[1] = ringReadPos[0]; // Keep in sync
+    switchCrossfadePos += numSamples;
 
-    ringBufferAvailable -= toRead;
+    if (switchCrossfadePos >= switchCrossfadeLength)
+        finishSwitch();
 }
 
-float StretchEngine::hermiteInterpolate(const float* buffer, int bufferSize, double position)
+void StretchEngine::writeToInputHistory(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples)
 {
-    int idx0 = static_cast<int>(position);
-    float frac = static_cast<float>(position - idx0);
+    // Mono input is duplicated so Rubber Band always sees two channels
+    inputHistory.write(0, historyWritePos, buffer.getReadPointer(0), numSamples);
+    inputHistory.write(1, historyWritePos, buffer.getReadPointer(numChannels > 1 ? 1 : 0), numSamples);
 
-    int idxM1 = (idx0 - 1 + bufferSize) % bufferSize;
-    int idx1 = (idx0 + 1) % bufferSize;
-    int idx2 = (idx0 + 2) % bufferSize;
-    idx0 = idx0 % bufferSize;
+    historyWritePos = inputHistory.wrap(historyWritePos + numSamples);
+    historyValidSamples = std::min(historyValidSamples + numSamples, inputHistorySize);
 
-    float xm1 = buffer[idxM1];
-    float x0 = buffer[idx0];
-    float x1 = buffer[idx1];
-    float x2 = buffer[idx2];
+    for (auto& slot : slots)
+        slot.historyBacklog = std::min(slot.historyBacklog + numSamples, inputHistorySize);
+}
+
+void StretchEngine::feedRubberBand(StretcherSlot& slot, int numSamples)
+{
+    auto& rubberBand = slot.rubberBand;
+
+    // Expanding consumes input slower than it arrives. Jump forward rather than
+    // let the backlog (and so the effective latency) grow without bound. A replacement
+    // still priming starts deliberately far back and is left alone.
+    const int maxBacklog = targetRingFill * 4;
+
+    if (slot.primed && slot.historyBacklog > maxBacklog)
+    {
+        slot.historyBacklog = targetRingFill;
+        statInputSkips.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // At the 0.25x minimum ratio Rubber Band needs four input samples per output sample,
+    // plus room for a whole analysis hop landing in this block
+    const int maxFeed = (numSamples + targetRingFill) * 4;
+    int fed = 0;
+
+    while (slot.ringBufferAvailable < targetRingFill && fed < maxFeed)
+    {
+        int required = static_cast<int>(rubberBand->getSamplesRequired());
+
+        if (required <= 0)
+        {
+            // Rubber Band has enough input; collect what it made
+            const int before = slot.ringBufferAvailable;
+            retrieveFromRubberBand(slot);
+
+            if (slot.ringBufferAvailable != before)
+                continue;
+
+            // Nothing came out (e.g. the ratio just changed), so give it one more block to run on
+            required = maxBlockSize;
+        }
+
+        int toFeed = std::min({ required, maxBlockSize, maxFeed - fed });
+
+        if (slot.historyBacklog < toFeed)
+        {
+            // Compressing faster than input arrives: if this block would otherwise underrun,
+            // replay the most recent history. Not while priming, where repeating the first
+            // block would only smear the onset.
+            const int replayable = std::min(historyValidSamples - slot.historyBacklog, targetRingFill);
+            const bool wouldUnderrun = slot.ringBufferAvailable < numSamples;
+
+            if (!slot.primed || !wouldUnderrun || slot.historyBacklog + replayable < toFeed)
+            {
+                toFeed = slot.historyBacklog;
+            }
+            else
+            {
+                slot.historyBacklog += replayable;
+                statInputRewinds.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        if (toFeed <= 0)
+            break;
+
+        const int readPos = historyWritePos - slot.historyBacklog;
+        inputHistory.read(0, readPos, inputBuffers[0].data(), toFeed);
+        inputHistory.read(1, readPos, inputBuffers[1].data(), toFeed);
+
+        const float* ptrs[2] = { inputBuffers[0].data(), inputBuffers[1].data() };
+        rubberBand->process(ptrs, static_cast<size_t>(toFeed), false);
+
+        slot.historyBacklog -= toFeed;
+        slot.primingSamplesFed += toFeed;
+        fed += toFeed;
+
+        retrieveFromRubberBand(slot);
+    }
+
+    if (&slot == &slots[activeSlot])
+        statInputBacklog.store(slot.historyBacklog, std::memory_order_relaxed);
+}
+
+void StretchEngine::retrieveFromRubberBand(StretcherSlot& slot)
+{
+    // Retrieve all available output
+    while (slot.rubberBand->available() > 0)
+    {
+        int available = static_cast<int>(slot.rubberBand->available());
+        int toRetrieve = std::min(available, static_cast<int>(retrieveBuffers[0].size()));
+
+        float* rptrs[2] = { retrieveBuffers[0].data(), retrieveBuffers[1].data() };
+        size_t retrieved = slot.rubberBand->retrieve(rptrs, static_cast<size_t>(toRetrieve));
+
+        if (retrieved == 0)
+            break;
+
+        int numRetrieved = static_cast<int>(retrieved);
+        int discard = std::min(slot.outputToDiscard, numRetrieved);
+        slot.outputToDiscard -= discard;
+
+        writeToRingBuffer(slot, retrieveBuffers[0].data() + discard, retrieveBuffers[1].data() + discard, numRetrieved - discard);
+    }
+}
+
+void StretchEngine::writeToRingBuffer(StretcherSlot& slot, const float* dataL, const float* dataR, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    slot.outputRingBuffer.write(0, slot.ringWritePos, dataL, numSamples);
+    slot.outputRingBuffer.write(1, slot.ringWritePos, dataR, numSamples);
+
+    slot.ringWritePos = slot.outputRingBuffer.wrap(slot.ringWritePos + numSamples);
+
+    slot.ringBufferAvailable = std::min(slot.ringBufferAvailable + numSamples, ringBufferSize);
+}
+
+void StretchEngine::readFromRingBuffer(StretcherSlot& slot, float* dataL, float* dataR, int numSamples, int numChannels)
+{
+    if (numSamples <= 0)
+        return;
+
+    int toRead = std::min(numSamples, slot.ringBufferAvailable);
+
+    slot.outputRingBuffer.read(0, slot.ringReadPos, dataL, toRead);
+    if (dataR && numChannels > 1)
+    {
+        slot.outputRingBuffer.read(1, slot.ringReadPos, dataR, toRead);
+    }
 
-    float c0 = x0;
-    float c1 = 0.5f * (x1 - xm1);
-    float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
-    float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+    slot.ringReadPos = slot.outputRingBuffer.wrap(slot.ringReadPos + toRead);
 
-    return ((c3 * frac + c2) * frac + c1) * frac + c0;
+    slot.ringBufferAvailable -= toRead;
 }
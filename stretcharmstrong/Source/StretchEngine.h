@@ -2,9 +2,13 @@
 
 #include <JuceHeader.h>
 #include <rubberband/RubberBandStretcher.h>
+#include "RingBuffer.h"
+#include "VarispeedResampler.h"
+#include "SpectralStretcher.h"
+#include "GateEventRenderer.h"
 #include <vector>
 #include <memory>
-#include <array>
+#include <atomic>
 
 class StretchEngine
 {
@@ -12,20 +16,84 @@ public:
     enum class StretchType
     {
         Varispeed = 0,  // Changes pitch with speed (like tape)
-        TimeStretch = 1  // Maintains pitch while changing speed
+        TimeStretch = 1, // Maintains pitch while changing speed
+        Spectral = 2     // Phase-randomised smear for extreme ratios and freeze
+    };
+
+    // Rubber Band configurations, cheapest first
+    enum class StretchQuality
+    {
+        Fast = 0,      // R2 engine
+        Balanced = 1,  // R3 engine, short window
+        Finest = 2     // R3 engine, long window
     };
 
     StretchEngine();
     ~StretchEngine();
 
-    void prepare(double sampleRate, int maxBlockSize, StretchType type, float ratio);
+    // Preparation comes in two halves. configure() settles the settings, and with them
+    // getLatencySamples(), without allocating anything, so the latency is known straight
+    // away. prepare() then allocates and builds everything for those settings, and may run
+    // on a background thread. Rubber Band's latencies are only known by building a stretcher
+    // per tier, which prepare() does the first time a sample rate and block size come up;
+    // until it has, configure() goes on the last ones measured, and the latency can move.
+    void configure(double sampleRate, int maxBlockSize, StretchType type, float ratio);
+    void prepare();
     void process(juce::AudioBuffer<float>& buffer, float envelopeValue);
     void reset();
 
     void setStretchType(StretchType type);
     void setStretchRatio(float ratio);
+    void setVarispeedQuality(VarispeedResampler::Quality quality) { varispeedResampler.setQuality(quality); }
+    void setSpectralFreeze(bool shouldFreeze) { spectralFreeze = shouldFreeze; }
+
+    // Host timeline position of the next block in samples, or -1 when not playing.
+    // Gate event renders are cached against it.
+    void setTimelinePosition(juce::int64 position) { timelinePosition = position; }
+    void setEventRenderingEnabled(bool shouldRender) { eventRenderer.setEnabled(shouldRender); }
+    int getNumRenderedEvents() const { return eventRenderer.getNumRenderedEvents(); }
+
+    // In automatic mode quality is the ceiling; the engine steps down from it
+    // while the stretcher's share of each block exceeds stretchLoadBudget.
+    void setStretchQuality(StretchQuality quality, bool automatic);
+
+    // The stretcher builder only runs while Auto is selected or a switch is in flight, and
+    // the event renderer's worker while event rendering is on. Threads can't be started from
+    // the audio thread, so when the flags returned here change, call updateThreads() from
+    // the message thread to catch up.
+    int getWantedThreads() const { return wantedThreads.load(std::memory_order_relaxed); }
+    void updateThreads();
 
-    int getLatencySamples() const;
+    // Delay of everything the engine outputs, stretched or not, for the current stretch
+    // type and settings. Safe to read from any thread. A change made while the envelope
+    // is open takes effect (and shows here) at the next idle block.
+    int getLatencySamples() const { return statLatency.load(std::memory_order_relaxed); }
+
+    // The input delayed by getLatencySamples(), valid for the block just processed.
+    // Mix dry against this so it lines up with the stretched output.
+    const juce::AudioBuffer<float>& getDelayedDry() const { return delayedDry; }
+
+    // Time-stretch feed scheduler counters, safe to read from any thread
+    struct FeedStats
+    {
+        int outputFill = 0;             // samples left in the output ring after the last block
+        int inputBacklog = 0;           // input history samples not yet fed to Rubber Band
+        juce::uint32 underruns = 0;     // blocks the output ring couldn't fully cover
+        juce::uint32 inputRewinds = 0;  // history replays while compressing faster than input arrives
+        juce::uint32 inputSkips = 0;    // forward jumps that keep the backlog bounded while expanding
+    };
+
+    FeedStats getFeedStats() const;
+
+    // Time-stretch engine state for the editor, safe to read from any thread
+    struct QualityStatus
+    {
+        StretchQuality activeQuality = StretchQuality::Finest;
+        bool switching = false;  // a replacement stretcher is being built or crossfaded in
+        float load = 0.0f;       // smoothed stretcher time as a fraction of the block duration
+    };
+
+    QualityStatus getQualityStatus() const;
 
 private:
     double sampleRate = 44100.0;
@@ -35,28 +103,148 @@ private:
     float targetStretchRatio = 1.0f;
     float smoothedStretchRatio = 1.0f;
 
-    // Rubber Band for time-stretching (pitch-preserving)
-    std::unique_ptr<RubberBand::RubberBandStretcher> rubberBand;
-    bool rubberBandPrimed = false;
-    int primingSamplesNeeded = 0;
-    int primingSamplesFed = 0;
-
-    // Output ring buffer for Rubber Band (per-channel positions for stereo)
-    std::vector<std::vector<float>> outputRingBuffer;
-    std::array<int, 2> ringWritePos = {0, 0};
-    std::array<int, 2> ringReadPos = {0, 0};
-    int ringBufferAvailable = 0;
+    // One Rubber Band instance with its own output ring and input read position.
+    // Two exist so a replacement can prime and crossfade in while the old one plays.
+    struct StretcherSlot
+    {
+        std::unique_ptr<RubberBand::RubberBandStretcher> rubberBand;
+        StretchQuality quality = StretchQuality::Finest;
+        bool primed = false;
+        int primingSamplesNeeded = 0;
+        int primingSamplesFed = 0;
+        int primingFillNeeded = 0;
+
+        // Output ring buffer (both channels share positions)
+        RingBuffer<float> outputRingBuffer;
+        int ringWritePos = 0;
+        int ringReadPos = 0;
+        int ringBufferAvailable = 0;
+
+        // Input history samples not yet fed to this stretcher
+        int historyBacklog = 0;
+
+        // Leading output dropped from a replacement so it lines up with the active slot
+        int outputToDiscard = 0;
+    };
+
+    StretcherSlot slots[2];
+    int activeSlot = 0;
     static constexpr int ringBufferSize = 65536;
 
-    // Circular buffer for varispeed
-    std::vector<std::vector<float>> varispeedBuffer;
+    // Input history the time-stretch feed draws from on demand. Each slot reads
+    // historyBacklog samples behind the write position.
+    RingBuffer<float> inputHistory;
+    int historyWritePos = 0;
+    int historyValidSamples = 0;
+    int targetRingFill = 0;
+    static constexpr int inputHistorySize = 32768;
+
+    // Quality switching. Stretchers are constructed and destroyed on builderThread
+    // and passed across through single-pointer mailboxes; at most one build is in
+    // flight, so each mailbox only ever holds one instance.
+    enum class SwitchState { Idle, Building, Priming, Crossfading };
+
+    class StretcherBuilder : public juce::Thread
+    {
+    public:
+        explicit StretcherBuilder(StretchEngine& e) : juce::Thread("StretchArmstrong Builder"), engine(e) {}
+        void run() override;
+
+    private:
+        StretchEngine& engine;
+    };
+
+    StretcherBuilder builderThread { *this };
+    std::atomic<int> requestedQuality { -1 };
+    std::atomic<RubberBand::RubberBandStretcher*> builtStretcher { nullptr };
+    std::atomic<RubberBand::RubberBandStretcher*> retiredStretcher { nullptr };
+
+    enum WantedThread { builderThreadWanted = 1, rendererThreadWanted = 2 };
+    std::atomic<int> wantedThreads { 0 };
+
+    SwitchState switchState = SwitchState::Idle;
+    StretchQuality selectedQuality = StretchQuality::Finest;
+    StretchQuality pendingQuality = StretchQuality::Finest;
+    bool automaticQuality = false;
+    int switchCrossfadePos = 0;
+    static constexpr int switchCrossfadeLength = 2048;
+
+    // Automatic mode: the smoothed load has to stay over budget for overloadHoldSeconds
+    // before stepping down, and well under it for upgradeHoldSeconds before stepping up.
+    // Each step down soon after a step up doubles the upgrade hold, so a tier that can't
+    // be sustained isn't retried every few seconds.
+    float smoothedLoad = 0.0f;
+    double overloadSeconds = 0.0;
+    double underloadSeconds = 0.0;
+    double secondsSinceSwitch = 0.0;
+    double upgradeHoldSeconds = 8.0;
+    bool lastSwitchWasUpgrade = false;
+    static constexpr float stretchLoadBudget = 0.25f;
+    static constexpr float upgradeLoadThreshold = 0.08f;
+    static constexpr double overloadHoldSeconds = 0.5;
+    static constexpr double minUpgradeHoldSeconds = 8.0;
+    static constexpr double maxUpgradeHoldSeconds = 120.0;
+
+    std::atomic<int> statActiveQuality { static_cast<int>(StretchQuality::Finest) };
+    std::atomic<bool> statSwitching { false };
+    std::atomic<float> statLoad { 0.0f };
+    std::atomic<int> statLatency { 0 };
+
+    // Latency in effect. Time-stretch (re)starts line their first output up with it, the
+    // varispeed read head sits that far back while idle, and the dry path is delayed by it.
+    int latencySamples = 0;
+    int stretcherLatencies[3] = {};  // Rubber Band latency per StretchQuality, see measureStretcherLatencies()
+    static constexpr double varispeedLookaheadSeconds = 0.1;
+
+    // Measured stretcher latencies for each sample rate and block size seen so far, shared
+    // by every engine in the process
+    struct StretcherLatencyCache
+    {
+        struct Entry
+        {
+            double sampleRate;
+            int maxBlockSize;
+            int latencies[3];
+        };
+
+        juce::CriticalSection lock;
+        std::vector<Entry> entries;
+    };
+
+    juce::SharedResourcePointer<StretcherLatencyCache> latencyCache;
+
+    // Dry path delay line, and the delayed copy of the current block
+    RingBuffer<float> dryDelay;
+    int dryDelayWritePos = 0;
+    int previousDryLatency = -1;  // fade from this delay over the next block, if >= 0
+    juce::AudioBuffer<float> delayedDry;
+
+    // Last sample the time stretch path output, so an underrun can fade from it,
+    // and whether the last block fell back to dry, so the next can fade back
+    float lastOutputSample[2] = {};
+    bool underrunFallback = false;
+
+    std::atomic<int> statOutputFill { 0 };
+    std::atomic<int> statInputBacklog { 0 };
+    std::atomic<juce::uint32> statUnderruns { 0 };
+    std::atomic<juce::uint32> statInputRewinds { 0 };
+    std::atomic<juce::uint32> statInputSkips { 0 };
+
+    // Circular buffer for varispeed (mirrored so interpolation taps are contiguous)
+    RingBuffer<float> varispeedBuffer;
+    VarispeedResampler varispeedResampler;
     double varispeedReadPos = 0.0;
     int varispeedWritePos = 0;
     static constexpr int varispeedBufferSize = 131072;
 
+    // Spectral stretch (ratios up to SpectralStretcher::maxRatio, or frozen)
+    SpectralStretcher spectralStretcher;
+    bool spectralFreeze = false;
+
     // Working buffers
     std::vector<std::vector<float>> inputBuffers;
     std::vector<std::vector<float>> retrieveBuffers;
+    std::vector<std::vector<float>> switchBuffers;
 
     // Crossfade for smooth transitions
     float currentEnvelope = 0.0f;
@@ -69,16 +257,47 @@ private:
     int crossfadeSamples = 0;
     static constexpr int crossfadeLength = 256;
 
+    // Hot standby while the envelope is idle: input keeps flowing into the history
+    // buffers (a copy, no stretcher calls) so a trigger can start without priming
+    bool inStandby = false;
+
+    // Offline re-renders of time-stretch events, played back on later passes
+    GateEventRenderer eventRenderer;
+    juce::int64 timelinePosition = -1;
+
     // Process methods for each stretch type
     void processVarispeed(juce::AudioBuffer<float>& buffer, float envelope);
     void processTimeStretch(juce::AudioBuffer<float>& buffer, float envelope);
+    void processSpectral(juce::AudioBuffer<float>& buffer, float envelope);
+    void processStandby(juce::AudioBuffer<float>& buffer);
+    void restartFromHistory(int numSamples);
+    bool isPrimingComplete(const StretcherSlot& slot, int numSamples) const;
+
+    // Latency
+    int computeLatency() const;
+    void applyLatency(int newLatency);
+    void delayDry(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples);
 
     // Ring buffer operations (writes both channels together)
-    void writeToRingBuffer(const float* dataL, const float* dataR, int numSamples);
-    void readFromRingBuffer(float* dataL, float* dataR, int numSamples, int numChannels);
+    static void writeToRingBuffer(StretcherSlot& slot, const float* dataL, const float* dataR, int numSamples);
+    static void readFromRingBuffer(StretcherSlot& slot, float* dataL, float* dataR, int numSamples, int numChannels);
+
+    // Demand-driven feeding: tops a slot's output ring up to targetRingFill from the input history
+    void writeToInputHistory(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples);
+    void feedRubberBand(StretcherSlot& slot, int numSamples);
+    void retrieveFromRubberBand(StretcherSlot& slot);
 
-    // Hermite interpolation for high-quality varispeed
-    float hermiteInterpolate(const float* buffer, int bufferSize, double position);
+    // Quality switching
+    std::unique_ptr<RubberBand::RubberBandStretcher> createStretcher(StretchQuality quality) const;
+    void resetSlot(StretcherSlot& slot);
+    void serviceBuilder();
+    void updateWantedThreads();
+    bool lookUpStretcherLatencies();
+    void measureStretcherLatencies();
+    void updateQualitySwitch(int numSamples, double elapsedSeconds);
+    void beginPriming(RubberBand::RubberBandStretcher* stretcher);
+    void finishSwitch();
+    void mixSwitchCrossfade(juce::AudioBuffer<float>& buffer, int numChannels, int numSamples);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StretchEngine)
 };
@@ -0,0 +1,262 @@
+#include "VarispeedResampler.h"
+#include <cmath>
+#include <algorithm>
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <xmmintrin.h>
+#elif JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
+namespace
+{
+    // Zeroth-order modified Bessel function of the first kind (power series)
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        const double halfX = x * 0.5;
+
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+
+            if (term < sum * 1.0e-12)
+                break;
+        }
+
+        return sum;
+    }
+
+    // Interpolates a kernel between two adjacent phases and applies it to both
+    // channels in one pass. numTaps is always a multiple of 4.
+    inline void interpolatedDotProduct(const float* phaseA, const float* phaseB, float alpha,
+                                       const float* left, const float* right, int numTaps,
+                                       float& outLeft, float& outRight) noexcept
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        const __m128 a = _mm_set1_ps(alpha);
+        __m128 accLeft = _mm_setzero_ps();
+        __m128 accRight = _mm_setzero_ps();
+
+        for (int k = 0; k < numTaps; k += 4)
+        {
+            const __m128 c0 = _mm_loadu_ps(phaseA + k);
+            const __m128 c = _mm_add_ps(c0, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(phaseB + k), c0), a));
+
+            accLeft = _mm_add_ps(accLeft, _mm_mul_ps(c, _mm_loadu_ps(left + k)));
+            accRight = _mm_add_ps(accRight, _mm_mul_ps(c, _mm_loadu_ps(right + k)));
+        }
+
+        alignas(16) float sums[8];
+        _mm_store_ps(sums, accLeft);
+        _mm_store_ps(sums + 4, accRight);
+
+        outLeft = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        outRight = (sums[4] + sums[5]) + (sums[6] + sums[7]);
+       #elif JUCE_USE_ARM_NEON
+        float32x4_t accLeft = vdupq_n_f32(0.0f);
+        float32x4_t accRight = vdupq_n_f32(0.0f);
+
+        for (int k = 0; k < numTaps; k += 4)
+        {
+            const float32x4_t c0 = vld1q_f32(phaseA + k);
+            const float32x4_t c = vmlaq_n_f32(c0, vsubq_f32(vld1q_f32(phaseB + k), c0), alpha);
+
+            accLeft = vmlaq_f32(accLeft, c, vld1q_f32(left + k));
+            accRight = vmlaq_f32(accRight, c, vld1q_f32(right + k));
+        }
+
+        const float32x2_t sumLeft = vadd_f32(vget_low_f32(accLeft), vget_high_f32(accLeft));
+        const float32x2_t sumRight = vadd_f32(vget_low_f32(accRight), vget_high_f32(accRight));
+
+        outLeft = vget_lane_f32(vpadd_f32(sumLeft, sumLeft), 0);
+        outRight = vget_lane_f32(vpadd_f32(sumRight, sumRight), 0);
+       #else
+        float sumLeft = 0.0f;
+        float sumRight = 0.0f;
+
+        for (int k = 0; k < numTaps; ++k)
+        {
+            const float c = phaseA[k] + (phaseB[k] - phaseA[k]) * alpha;
+            sumLeft += c * left[k];
+            sumRight += c * right[k];
+        }
+
+        outLeft = sumLeft;
+        outRight = sumRight;
+       #endif
+    }
+
+    inline float hermiteInterpolate(const float* samples, float frac) noexcept
+    {
+        // samples points at x[-1]
+        float xm1 = samples[0];
+        float x0 = samples[1];
+        float x1 = samples[2];
+        float x2 = samples[3];
+
+        float c0 = x0;
+        float c1 = 0.5f * (x1 - xm1);
+        float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+        float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+
+        return ((c3 * frac + c2) * frac + c1) * frac + c0;
+    }
+}
+
+VarispeedResampler::VarispeedResampler()
+{
+    // Passband edges are set so the Kaiser transition band ends close to Nyquist
+    buildTable(sinc8, 8, 0.72, 4.5);
+    buildTable(sinc16, 16, 0.82, 6.0);
+    buildTable(sinc32, 32, 0.90, 7.5);
+}
+
+int VarispeedResampler::getNumTaps() const noexcept
+{
+    switch (quality)
+    {
+        case Quality::Cubic:  return 4;
+        case Quality::Sinc8:  return sinc8.numTaps;
+        case Quality::Sinc16: return sinc16.numTaps;
+        case Quality::Sinc32: return sinc32.numTaps;
+    }
+
+    return 4;
+}
+
+void VarispeedResampler::buildTable(SincTable& table, int numTaps, double passband, double kaiserBeta)
+{
+    table.numTaps = numTaps;
+    table.coefficients.assign(static_cast<size_t>(numCutoffBands) * (numPhases + 1) * static_cast<size_t>(numTaps), 0.0f);
+
+    const double halfTaps = numTaps * 0.5;
+    const double windowNorm = 1.0 / besselI0(kaiserBeta);
+
+    for (int band = 0; band < numCutoffBands; ++band)
+    {
+        const double cutoff = passband * std::pow(2.0, -band / 4.0);
+
+        for (int phase = 0; phase <= numPhases; ++phase)
+        {
+            const double frac = static_cast<double>(phase) / numPhases;
+            float* row = table.getPhase(band, phase);
+            double sum = 0.0;
+
+            // Tap k sits at (readIndex - numTaps + 1 + k); output is at (readIndex - numTaps / 2 + frac)
+            for (int k = 0; k < numTaps; ++k)
+            {
+                const double t = k - halfTaps + 1.0 - frac;
+                const double x = t / halfTaps;
+                const double window = std::abs(x) < 1.0 ? besselI0(kaiserBeta * std::sqrt(1.0 - x * x)) * windowNorm : 0.0;
+                const double arg = juce::MathConstants<double>::pi * cutoff * t;
+                const double sinc = std::abs(arg) < 1.0e-9 ? 1.0 : std::sin(arg) / arg;
+                const double h = cutoff * sinc * window;
+
+                row[k] = static_cast<float>(h);
+                sum += h;
+            }
+
+            // Unity DC gain at every phase
+            for (int k = 0; k < numTaps; ++k)
+                row[k] = static_cast<float>(row[k] / sum);
+        }
+    }
+}
+
+int VarispeedResampler::getCutoffBand(double increment) noexcept
+{
+    if (increment <= 1.0)
+        return 0;
+
+    // Lowest band whose cutoff scale 2^(-band/4) is at or below 1 / increment
+    const int band = static_cast<int>(std::ceil(4.0 * std::log2(increment) - 1.0e-9));
+    return juce::jlimit(0, numCutoffBands - 1, band);
+}
+
+double VarispeedResampler::process(const RingBuffer<float>& source, double readPosition, double increment,
+                                   float* const* dest, int numChannels, int numSamples) noexcept
+{
+    jassert(source.isMirrored());
+    jassert(increment > 0.0);
+
+    numChannels = std::min(numChannels, std::min(source.getNumChannels(), 2));
+
+    if (numChannels <= 0 || numSamples <= 0)
+        return readPosition;
+
+    switch (quality)
+    {
+        case Quality::Cubic:  return processCubic(source, readPosition, increment, dest, numChannels, numSamples);
+        case Quality::Sinc8:  return processSinc(sinc8, source, readPosition, increment, dest, numChannels, numSamples);
+        case Quality::Sinc16: return processSinc(sinc16, source, readPosition, increment, dest, numChannels, numSamples);
+        case Quality::Sinc32: return processSinc(sinc32, source, readPosition, increment, dest, numChannels, numSamples);
+    }
+
+    return readPosition;
+}
+
+double VarispeedResampler::processCubic(const RingBuffer<float>& source, double readPosition, double increment,
+                                        float* const* dest, int numChannels, int numSamples) const noexcept
+{
+    FixedPosition position(readPosition);
+    const FixedPosition step(increment);
+
+    const float* left = source.getReadPointer(0);
+    const float* right = numChannels > 1 ? source.getReadPointer(1) : nullptr;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const int start = source.wrap(position.index - 3);
+        const float frac = position.getFraction();
+
+        dest[0][i] = hermiteInterpolate(left + start, frac);
+
+        if (right != nullptr)
+            dest[1][i] = hermiteInterpolate(right + start, frac);
+
+        position.advance(step);
+    }
+
+    return position.toDouble();
+}
+
+double VarispeedResampler::processSinc(const SincTable& table, const RingBuffer<float>& source, double readPosition, double increment,
+                                       float* const* dest, int numChannels, int numSamples) const noexcept
+{
+    const int numTaps = table.numTaps;
+    const float* bandTable = table.getPhase(getCutoffBand(increment), 0);
+
+    FixedPosition position(readPosition);
+    const FixedPosition step(increment);
+
+    const float* left = source.getReadPointer(0);
+    const float* right = numChannels > 1 ? source.getReadPointer(1) : left;
+    float* destLeft = dest[0];
+    float* destRight = numChannels > 1 ? dest[1] : nullptr;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Top bits of the fraction pick the phase, the rest interpolate towards the next one
+        const int phase = static_cast<int>(position.frac >> (32 - phaseBits));
+        const float alpha = static_cast<float>(position.frac & phaseFractionMask) * (1.0f / (phaseFractionMask + 1.0f));
+
+        const float* phaseA = bandTable + phase * numTaps;
+        const float* phaseB = phaseA + numTaps;
+        const int start = source.wrap(position.index - numTaps + 1);
+
+        float outLeft, outRight;
+        interpolatedDotProduct(phaseA, phaseB, alpha, left + start, right + start, numTaps, outLeft, outRight);
+
+        destLeft[i] = outLeft;
+
+        if (destRight != nullptr)
+            destRight[i] = outRight;
+
+        position.advance(step);
+    }
+
+    return position.toDouble();
+}
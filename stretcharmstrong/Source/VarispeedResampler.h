@@ -0,0 +1,110 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "RingBuffer.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+    Block-based fractional resampler for tape-style varispeed.
+
+    Reads up to two channels from a mirrored RingBuffer at a fractional position
+    that advances by a fixed increment per output sample. The sinc tiers use
+    precomputed Kaiser-windowed polyphase tables, linearly interpolated between
+    adjacent phases. When the increment is above 1 the kernel cutoff is lowered
+    in quarter-octave steps so speeding up doesn't alias.
+
+    The kernel never reads past the integer read position, so output is delayed
+    by getLatencySamples() relative to the read position.
+
+    All tables are built in the constructor. process() and setQuality() don't
+    allocate.
+*/
+class VarispeedResampler
+{
+public:
+    enum class Quality
+    {
+        Cubic = 0,   // 4-point Hermite
+        Sinc8 = 1,
+        Sinc16 = 2,
+        Sinc32 = 3
+    };
+
+    VarispeedResampler();
+
+    void setQuality(Quality newQuality) noexcept { quality = newQuality; }
+    Quality getQuality() const noexcept { return quality; }
+
+    int getNumTaps() const noexcept;
+    int getLatencySamples() const noexcept { return getNumTaps() / 2; }
+
+    /** Latency of the longest kernel, which every quality fits within. */
+    int getMaxLatencySamples() const noexcept { return sinc32.numTaps / 2; }
+
+    /** Renders numSamples into each dest channel, reading source from readPosition
+        onwards in steps of increment. The source must be mirrored. Returns the
+        unwrapped read position after the block.
+    */
+    double process(const RingBuffer<float>& source, double readPosition, double increment,
+                   float* const* dest, int numChannels, int numSamples) noexcept;
+
+private:
+    static constexpr int phaseBits = 8;
+    static constexpr int numPhases = 1 << phaseBits;
+    static constexpr juce::uint32 phaseFractionMask = (1u << (32 - phaseBits)) - 1;
+    static constexpr int numCutoffBands = 9;  // quarter-octave steps from 1x down to 0.25x
+
+    struct SincTable
+    {
+        int numTaps = 0;
+        std::vector<float> coefficients;  // [band][phase 0..numPhases][tap]
+
+        size_t getOffset(int band, int phase) const noexcept
+        {
+            return (static_cast<size_t>(band) * (numPhases + 1) + static_cast<size_t>(phase)) * static_cast<size_t>(numTaps);
+        }
+
+        const float* getPhase(int band, int phase) const noexcept { return coefficients.data() + getOffset(band, phase); }
+        float* getPhase(int band, int phase) noexcept { return coefficients.data() + getOffset(band, phase); }
+    };
+
+    // 32.32 fixed-point read position. Stepping is integer-only, and the carry
+    // out of the fraction is branchless however irregularly it wraps.
+    struct FixedPosition
+    {
+        int index = 0;
+        juce::uint32 frac = 0;
+
+        explicit FixedPosition(double position) noexcept
+        {
+            const double whole = std::floor(position);
+            index = static_cast<int>(whole);
+            frac = static_cast<juce::uint32>(std::min(4294967295.0, (position - whole) * 4294967296.0));
+        }
+
+        void advance(const FixedPosition& step) noexcept
+        {
+            const juce::uint32 previous = frac;
+            frac += step.frac;
+            index += step.index + (frac < previous ? 1 : 0);
+        }
+
+        float getFraction() const noexcept { return static_cast<float>(frac * (1.0 / 4294967296.0)); }
+        double toDouble() const noexcept { return index + frac * (1.0 / 4294967296.0); }
+    };
+
+    Quality quality = Quality::Sinc16;
+    SincTable sinc8, sinc16, sinc32;
+
+    static void buildTable(SincTable& table, int numTaps, double passband, double kaiserBeta);
+    static int getCutoffBand(double increment) noexcept;
+
+    double processCubic(const RingBuffer<float>& source, double readPosition, double increment,
+                        float* const* dest, int numChannels, int numSamples) const noexcept;
+    double processSinc(const SincTable& table, const RingBuffer<float>& source, double readPosition, double increment,
+                       float* const* dest, int numChannels, int numSamples) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VarispeedResampler)
+};
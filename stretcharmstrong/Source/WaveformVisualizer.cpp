@@ -7,9 +7,16 @@ using namespace juce::gl;
 WaveformVisualizer::WaveformVisualizer(StretchArmstrongAudioProcessor& processor)
     : audioProcessor(processor)
 {
+    // Vertex storage is sized up front so frames only overwrite it
+    inputVertices.reserve(StretchArmstrongAudioProcessor::visualNumBuckets * 2);
+    outputVertices.reserve(StretchArmstrongAudioProcessor::visualNumBuckets * 2);
+    thresholdVertices.reserve(4);
+    envelopeVertices.reserve(8);
+
+    // Frames are driven by the timer rather than the display's refresh rate
     openGLContext.setRenderer(this);
     openGLContext.attachTo(*this);
-    openGLContext.setContinuousRepainting(true);
+    openGLContext.setContinuousRepainting(false);
 
     startTimerHz(30);
 }
@@ -27,10 +34,36 @@ void WaveformVisualizer::timerCallback()
     isStretching = audioProcessor.isStretching();
     currentSignalLevel = audioProcessor.getCurrentSignalLevel();
 
-    inputWaveform = audioProcessor.getInputWaveform();
-    outputWaveform = audioProcessor.getOutputWaveform();
+    openGLContext.triggerRepaint();
 
-    repaint();
+    // Only repaint the overlay text that actually changed
+    const int levelTenths = juce::roundToInt(currentSignalLevel * 10.0f);
+    const int envelopePercent = juce::roundToInt(envelopeValue * 100.0f);
+    const int thresholdTenths = juce::roundToInt(thresholdDb * 10.0f);
+
+    if (isStretching != shownStretching)
+    {
+        shownStretching = isStretching;
+        repaint(getStatusArea());
+    }
+
+    if (levelTenths != shownLevelTenths)
+    {
+        shownLevelTenths = levelTenths;
+        repaint(getLevelArea());
+    }
+
+    if (envelopePercent != shownEnvelopePercent)
+    {
+        shownEnvelopePercent = envelopePercent;
+        repaint(getEnvelopeArea());
+    }
+
+    if (thresholdTenths != shownThresholdTenths)
+    {
+        shownThresholdTenths = thresholdTenths;
+        repaint(getThresholdArea());
+    }
 }
 
 void WaveformVisualizer::paint(juce::Graphics& g)
@@ -43,23 +76,25 @@ void WaveformVisualizer::paint(juce::Graphics& g)
     juce::String status = isStretching ? "STRETCHING" : "IDLE";
     juce::Colour statusColor = isStretching ? juce::Colour(0xff00ff00) : juce::Colour(0xff888888);
     g.setColour(statusColor);
-    g.drawText(status, 10, 10, 100, 20, juce::Justification::left);
+    g.drawText(status, getStatusArea(), juce::Justification::left);
 
     // Draw signal level
     g.setColour(juce::Colour(0xffffffff));
-    g.drawText(juce::String(currentSignalLevel, 1) + " dB", getWidth() - 80, 10, 70, 20, juce::Justification::right);
+    g.drawText(juce::String(currentSignalLevel, 1) + " dB", getLevelArea(), juce::Justification::right);
 
     // Draw envelope value
     g.setColour(juce::Colour(0xffff00ff));
-    g.drawText("ENV: " + juce::String(envelopeValue * 100.0f, 0) + "%", 10, getHeight() - 25, 100, 20, juce::Justification::left);
+    g.drawText("ENV: " + juce::String(envelopeValue * 100.0f, 0) + "%", getEnvelopeArea(), juce::Justification::left);
 
     // Draw threshold indicator
     g.setColour(juce::Colour(0xffff6600));
-    g.drawText("THR: " + juce::String(thresholdDb, 1) + " dB", getWidth() - 120, getHeight() - 25, 110, 20, juce::Justification::right);
+    g.drawText("THR: " + juce::String(thresholdDb, 1) + " dB", getThresholdArea(), juce::Justification::right);
 }
 
 void WaveformVisualizer::resized()
 {
+    // The edge-anchored readouts moved
+    repaint();
 }
 
 void WaveformVisualizer::newOpenGLContextCreated()
@@ -71,6 +106,8 @@ void WaveformVisualizer::newOpenGLContextCreated()
     openGLContext.extensions.glGenBuffers(1, &outputVBO);
     openGLContext.extensions.glGenBuffers(1, &thresholdVBO);
     openGLContext.extensions.glGenBuffers(1, &envelopeVBO);
+
+    thresholdUploadPending = true;
 }
 
 void WaveformVisualizer::renderOpenGL()
@@ -97,7 +134,8 @@ void WaveformVisualizer::renderOpenGL()
         if (!thresholdVertices.empty())
         {
             glLineWidth(2.0f);
-            drawWaveform(thresholdVertices, thresholdVBO);
+            drawWaveform(thresholdVertices, thresholdVBO, thresholdUploadPending);
+            thresholdUploadPending = false;
         }
 
         // Draw input waveform (cyan, semi-transparent)
@@ -180,50 +218,33 @@ void WaveformVisualizer::updateWaveformData()
     if (width <= 0 || height <= 0)
         return;
 
-    // Threshold line (horizontal, orange)
-    float thresholdLinear = juce::Decibels::decibelsToGain(thresholdDb);
-    float thresholdY = -thresholdLinear; // Convert to normalized coordinates (-1 to 1)
-
-    thresholdVertices.clear();
-    thresholdVertices.push_back({{-1.0f, thresholdY}, {1.0f, 0.4f, 0.0f, 0.8f}});
-    thresholdVertices.push_back({{1.0f, thresholdY}, {1.0f, 0.4f, 0.0f, 0.8f}});
-    // Also draw negative threshold
-    thresholdVertices.push_back({{-1.0f, -thresholdY}, {1.0f, 0.4f, 0.0f, 0.8f}});
-    thresholdVertices.push_back({{1.0f, -thresholdY}, {1.0f, 0.4f, 0.0f, 0.8f}});
-
-    // Input waveform (cyan)
-    inputVertices.clear();
-    if (!inputWaveform.empty())
+    // Threshold line (horizontal, orange), rebuilt only when the threshold moves
+    if (thresholdDb != thresholdVerticesDb)
     {
-        size_t numSamples = inputWaveform.size();
-        float xStep = 2.0f / static_cast<float>(numSamples);
-
-        for (size_t i = 0; i < numSamples; ++i)
-        {
-            float x = -1.0f + static_cast<float>(i) * xStep;
-            float y = inputWaveform[i] * 0.8f; // Scale to fit
-            inputVertices.push_back({{x, y}, {0.0f, 1.0f, 1.0f, 0.5f}});
-        }
+        thresholdVerticesDb = thresholdDb;
+        thresholdUploadPending = true;
+
+        float thresholdLinear = juce::Decibels::decibelsToGain(thresholdDb);
+        float thresholdY = -thresholdLinear; // Convert to normalized coordinates (-1 to 1)
+
+        thresholdVertices.clear();
+        thresholdVertices.push_back({{-1.0f, thresholdY}, {1.0f, 0.4f, 0.0f, 0.8f}});
+        thresholdVertices.push_back({{1.0f, thresholdY}, {1.0f, 0.4f, 0.0f, 0.8f}});
+        // Also draw negative threshold
+        thresholdVertices.push_back({{-1.0f, -thresholdY}, {1.0f, 0.4f, 0.0f, 0.8f}});
+        thresholdVertices.push_back({{1.0f, -thresholdY}, {1.0f, 0.4f, 0.0f, 0.8f}});
     }
 
-    // Output waveform (magenta when stretching, white otherwise)
-    outputVertices.clear();
-    if (!outputWaveform.empty())
-    {
-        size_t numSamples = outputWaveform.size();
-        float xStep = 2.0f / static_cast<float>(numSamples);
+    // Latest peak summary from the audio thread (lock free, we're its only reader)
+    const auto& summary = audioProcessor.readWaveformSummary();
 
-        float r = isStretching ? 1.0f : 1.0f;
-        float g = isStretching ? 0.0f : 1.0f;
-        float b = isStretching ? 1.0f : 1.0f;
+    // Input waveform (cyan)
+    writePeakStrip(inputVertices, summary.getLane(StretchArmstrongAudioProcessor::inputLane), summary.numBuckets,
+                   0.0f, 1.0f, 1.0f, 0.5f);
 
-        for (size_t i = 0; i < numSamples; ++i)
-        {
-            float x = -1.0f + static_cast<float>(i) * xStep;
-            float y = outputWaveform[i] * 0.8f;
-            outputVertices.push_back({{x, y}, {r, g, b, 0.9f}});
-        }
-    }
+    // Output waveform (magenta when stretching, white otherwise)
+    writePeakStrip(outputVertices, summary.getLane(StretchArmstrongAudioProcessor::outputLane), summary.numBuckets,
+                   1.0f, isStretching ? 0.0f : 1.0f, 1.0f, 0.9f);
 
     // Envelope bar at bottom
     envelopeVertices.clear();
@@ -248,16 +269,36 @@ void WaveformVisualizer::updateWaveformData()
     }
 }
 
-void WaveformVisualizer::drawWaveform(const std::vector<Vertex>& vertices, GLuint vbo)
+void WaveformVisualizer::writePeakStrip(std::vector<Vertex>& vertices, const WaveformSummaryFeed::Bucket* buckets, int numBuckets,
+                                        float r, float g, float b, float a)
+{
+    // Same size every frame once the summary is known, so this only overwrites in place
+    vertices.resize(static_cast<size_t>(juce::jmax(0, numBuckets)) * 2);
+
+    // Zig-zag between each bucket's max and min so the line strip fills the peak envelope
+    float xStep = 2.0f / static_cast<float>(juce::jmax(1, numBuckets));
+    auto* vertex = vertices.data();
+
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        float x = -1.0f + static_cast<float>(i) * xStep;
+        *vertex++ = {{x, buckets[i].max * 0.8f}, {r, g, b, a}}; // Scale to fit
+        *vertex++ = {{x, buckets[i].min * 0.8f}, {r, g, b, a}};
+    }
+}
+
+void WaveformVisualizer::drawWaveform(const std::vector<Vertex>& vertices, GLuint vbo, bool uploadVertices)
 {
     if (vertices.empty() || vbo == 0)
         return;
 
     openGLContext.extensions.glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    openGLContext.extensions.glBufferData(GL_ARRAY_BUFFER,
-                                          static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex)),
-                                          vertices.data(),
-                                          GL_DYNAMIC_DRAW);
+
+    if (uploadVertices)
+        openGLContext.extensions.glBufferData(GL_ARRAY_BUFFER,
+                                              static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex)),
+                                              vertices.data(),
+                                              GL_DYNAMIC_DRAW);
 
     GLint positionAttr = openGLContext.extensions.glGetAttribLocation(shader->getProgramID(), "position");
     GLint colorAttr = openGLContext.extensions.glGetAttribLocation(shader->getProgramID(), "color");
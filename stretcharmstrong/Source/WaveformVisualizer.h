@@ -1,6 +1,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "WaveformSummaryFeed.h"
+#include <limits>
 #include <vector>
 
 class StretchArmstrongAudioProcessor;
@@ -24,19 +26,27 @@ public:
 private:
     void timerCallback() override;
 
+    // Overlay text areas, repainted individually when their readout changes
+    juce::Rectangle<int> getStatusArea() const       { return { 10, 10, 100, 20 }; }
+    juce::Rectangle<int> getLevelArea() const        { return { getWidth() - 80, 10, 70, 20 }; }
+    juce::Rectangle<int> getEnvelopeArea() const     { return { 10, getHeight() - 25, 100, 20 }; }
+    juce::Rectangle<int> getThresholdArea() const    { return { getWidth() - 120, getHeight() - 25, 110, 20 }; }
+
     StretchArmstrongAudioProcessor& audioProcessor;
     juce::OpenGLContext openGLContext;
 
-    // Cached waveform data
-    std::vector<float> inputWaveform;
-    std::vector<float> outputWaveform;
-
     // Display settings
     float thresholdDb = -30.0f;
     float envelopeValue = 0.0f;
     bool isStretching = false;
     float currentSignalLevel = -100.0f;
 
+    // Overlay readouts as last painted (tenths of a dB, whole percent)
+    int shownLevelTenths = std::numeric_limits<int>::min();
+    int shownEnvelopePercent = std::numeric_limits<int>::min();
+    int shownThresholdTenths = std::numeric_limits<int>::min();
+    bool shownStretching = false;
+
     // OpenGL shader
     std::unique_ptr<juce::OpenGLShaderProgram> shader;
     juce::String vertexShader;
@@ -54,14 +64,20 @@ private:
     std::vector<Vertex> thresholdVertices;
     std::vector<Vertex> envelopeVertices;
 
+    // Threshold lines only change with the threshold, so they're built and uploaded on change
+    float thresholdVerticesDb = std::numeric_limits<float>::quiet_NaN();
+    bool thresholdUploadPending = true;
+
     GLuint inputVBO = 0;
     GLuint outputVBO = 0;
     GLuint thresholdVBO = 0;
     GLuint envelopeVBO = 0;
 
     void updateWaveformData();
+    void writePeakStrip(std::vector<Vertex>& vertices, const WaveformSummaryFeed::Bucket* buckets, int numBuckets,
+                        float r, float g, float b, float a);
     void createShaders();
-    void drawWaveform(const std::vector<Vertex>& vertices, GLuint vbo);
+    void drawWaveform(const std::vector<Vertex>& vertices, GLuint vbo, bool uploadVertices = true);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformVisualizer)
 };
@@ -0,0 +1,202 @@
+// Impulse alignment test for StretchEngine latency reporting.
+//
+// Renders an impulse train through every stretch type (and each time-stretch
+// quality) at several host block sizes, and checks where the impulses come out
+// against StretchEngine::getLatencySamples():
+//
+//   idle    envelope closed: the delayed dry pass-through must be sample exact
+//   active  envelope open at a 1x ratio: the stretched output must line up
+//           within the type's tolerance (Rubber Band smears transients a little,
+//           and the spectral stretcher spreads each one over a window)
+//
+//   StretchLatencyTest [--sample-rate <hz>]
+//
+// Returns non-zero if any case is out of tolerance.
+
+#include <JuceHeader.h>
+#include "StretchEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    constexpr int numChannels = 2;
+
+    struct TestCase
+    {
+        StretchEngine::StretchType type;
+        StretchEngine::StretchQuality quality;
+        bool automaticQuality;
+        float ratio;  // only sets the ratio range; the active pass runs at 1x
+
+        juce::String getName() const
+        {
+            static const char* const typeNames[] = { "varispeed", "timestretch", "spectral" };
+            static const char* const qualityNames[] = { "fast", "balanced", "finest" };
+
+            juce::String name = typeNames[static_cast<int>(type)];
+
+            if (type == StretchEngine::StretchType::TimeStretch)
+                name << "_" << (automaticQuality ? "auto" : qualityNames[static_cast<int>(quality)]);
+
+            if (ratio < 1.0f)
+                name << "_speedup";
+
+            return name;
+        }
+    };
+
+    struct Alignment
+    {
+        int reportedLatency = 0;
+        double worstError = 0.0;  // samples, largest deviation of any impulse
+        int numImpulses = 0;
+    };
+
+    // Energy centroid of the output around where each impulse should appear. For a clean
+    // delay that's exactly the impulse; for smeared output it's the middle of the smear.
+    Alignment render(const TestCase& testCase, double sampleRate, int blockSize, bool envelopeOpen)
+    {
+        StretchEngine engine;
+        engine.setStretchQuality(testCase.quality, testCase.automaticQuality);
+        engine.configure(sampleRate, blockSize, testCase.type, testCase.ratio);
+        engine.prepare();
+
+        const int spacing = static_cast<int>(sampleRate * 0.5);
+        const int settleSamples = static_cast<int>(sampleRate * 2.0);
+        const int numSamples = settleSamples + spacing * 8;
+
+        juce::AudioBuffer<float> input(numChannels, numSamples);
+        juce::AudioBuffer<float> output(numChannels, numSamples);
+        input.clear();
+
+        std::vector<int> impulses;
+        for (int i = settleSamples; i < numSamples - spacing / 2; i += spacing)
+        {
+            impulses.push_back(i);
+            for (int ch = 0; ch < numChannels; ++ch)
+                input.setSample(ch, i, 1.0f);
+        }
+
+        juce::AudioBuffer<float> block(numChannels, blockSize);
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const int blockLength = std::min(blockSize, numSamples - start);
+            block.setSize(numChannels, blockLength, false, false, true);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                block.copyFrom(ch, 0, input, ch, start, blockLength);
+
+            // The ratio range sets the latency; the active pass stretches at 1x
+            engine.setStretchRatio(envelopeOpen ? 1.0f : testCase.ratio);
+            engine.process(block, envelopeOpen ? 1.0f : 0.0f);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                output.copyFrom(ch, start, block, ch, 0, blockLength);
+        }
+
+        Alignment alignment;
+        alignment.reportedLatency = engine.getLatencySamples();
+
+        for (int impulse : impulses)
+        {
+            const int expected = impulse + alignment.reportedLatency;
+            const int from = std::max(0, expected - spacing / 2);
+            const int to = std::min(numSamples, expected + spacing / 2);
+
+            double energy = 0.0;
+            double moment = 0.0;
+
+            for (int i = from; i < to; ++i)
+            {
+                const double sample = output.getSample(0, i);
+                energy += sample * sample;
+                moment += sample * sample * i;
+            }
+
+            if (energy <= 0.0)
+            {
+                alignment.worstError = std::numeric_limits<double>::infinity();
+                continue;
+            }
+
+            alignment.worstError = std::max(alignment.worstError, std::abs(moment / energy - expected));
+            ++alignment.numImpulses;
+        }
+
+        return alignment;
+    }
+
+    double getActiveTolerance(StretchEngine::StretchType type, double sampleRate)
+    {
+        switch (type)
+        {
+            case StretchEngine::StretchType::Varispeed:   return 0.5;
+            case StretchEngine::StretchType::TimeStretch: return 64.0;
+            case StretchEngine::StretchType::Spectral:    return sampleRate * 0.085 / 4.0;  // a hop
+        }
+
+        return 0.0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    const double sampleRate = args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+
+    using Type = StretchEngine::StretchType;
+    using Quality = StretchEngine::StretchQuality;
+
+    const TestCase testCases[] = {
+        { Type::Varispeed,   Quality::Finest,   false, 2.0f },
+        { Type::Varispeed,   Quality::Finest,   false, 0.5f },
+        { Type::TimeStretch, Quality::Fast,     false, 2.0f },
+        { Type::TimeStretch, Quality::Balanced, false, 2.0f },
+        { Type::TimeStretch, Quality::Finest,   false, 2.0f },
+        { Type::TimeStretch, Quality::Finest,   true,  2.0f },
+        { Type::Spectral,    Quality::Finest,   false, 8.0f },
+    };
+
+    const int blockSizes[] = { 64, 256, 1024, 2048 };
+
+    int numFailures = 0;
+    int numCases = 0;
+
+    std::cout << "StretchEngine latency alignment (" << sampleRate << " Hz)" << std::endl << std::endl;
+
+    for (const auto& testCase : testCases)
+    {
+        for (int blockSize : blockSizes)
+        {
+            const auto idle = render(testCase, sampleRate, blockSize, false);
+            const auto active = render(testCase, sampleRate, blockSize, true);
+            const double activeTolerance = getActiveTolerance(testCase.type, sampleRate);
+
+            const bool idleOk = idle.numImpulses > 0 && idle.worstError < 0.5;
+            const bool activeOk = active.numImpulses > 0 && active.worstError <= activeTolerance
+                               && active.reportedLatency == idle.reportedLatency;
+
+            numCases += 2;
+            numFailures += (idleOk ? 0 : 1) + (activeOk ? 0 : 1);
+
+            std::cout << (idleOk && activeOk ? "ok   " : "FAIL ")
+                      << testCase.getName().paddedRight(' ', 22)
+                      << " block " << juce::String(blockSize).paddedLeft(' ', 5)
+                      << "  latency " << juce::String(idle.reportedLatency).paddedLeft(' ', 6)
+                      << "  idle error " << juce::String(idle.worstError, 1).paddedLeft(' ', 7)
+                      << "  active error " << juce::String(active.worstError, 1).paddedLeft(' ', 7)
+                      << " (tolerance " << juce::String(activeTolerance, 1) << ")"
+                      << std::endl;
+        }
+    }
+
+    std::cout << std::endl << (numCases - numFailures) << "/" << numCases << " alignments within tolerance" << std::endl;
+    return numFailures == 0 ? 0 : 1;
+}
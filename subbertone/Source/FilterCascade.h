@@ -0,0 +1,179 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+
+/**
+ * Normalised biquad coefficients (a0 = 1), designed with the same prewarped
+ * bilinear transform as juce::dsp::IIR::Coefficients, so swapping one for the
+ * other leaves the response unchanged.
+ */
+struct BiquadCoefficients
+{
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;
+    float a1 = 0.0f, a2 = 0.0f;
+
+    static BiquadCoefficients makeLowPass(double sampleRate, double cutoffHz, double q) noexcept
+    {
+        const double n = 1.0 / std::tan(juce::MathConstants<double>::pi * cutoffHz / sampleRate);
+        const double nSquared = n * n;
+        const double c1 = 1.0 / (1.0 + n / q + nSquared);
+
+        return { static_cast<float>(c1), static_cast<float>(2.0 * c1), static_cast<float>(c1),
+                 static_cast<float>(2.0 * c1 * (1.0 - nSquared)), static_cast<float>(c1 * (1.0 - n / q + nSquared)) };
+    }
+
+    static BiquadCoefficients makeHighPass(double sampleRate, double cutoffHz, double q) noexcept
+    {
+        const double n = std::tan(juce::MathConstants<double>::pi * cutoffHz / sampleRate);
+        const double nSquared = n * n;
+        const double c1 = 1.0 / (1.0 + n / q + nSquared);
+
+        return { static_cast<float>(c1), static_cast<float>(-2.0 * c1), static_cast<float>(c1),
+                 static_cast<float>(2.0 * c1 * (nSquared - 1.0)), static_cast<float>(c1 * (1.0 - n / q + nSquared)) };
+    }
+};
+
+/**
+ * A fixed chain of NumStages biquads in transposed direct form II, run over a
+ * block at a time. The stage loop is unrolled at compile time and all state is
+ * held in locals for the block, so stage k of one sample overlaps with stage
+ * k + 1 of the previous one instead of each filter making its own pass
+ * through memory behind a coefficients pointer.
+ */
+template <size_t NumStages>
+class BiquadCascade
+{
+public:
+    void setStage(size_t stage, const BiquadCoefficients& coefficients) noexcept { m_coefficients[stage] = coefficients; }
+
+    void reset() noexcept { m_state = {}; }
+
+    // In place
+    void process(float* data, int numSamples) noexcept
+    {
+        const auto coefficients = m_coefficients;
+        auto state = m_state;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float x = data[i];
+
+            for (size_t stage = 0; stage < NumStages; ++stage)
+            {
+                const auto& c = coefficients[stage];
+                auto& s = state[stage];
+
+                const float y = c.b0 * x + s.s1;
+                s.s1 = c.b1 * x - c.a1 * y + s.s2;
+                s.s2 = c.b2 * x - c.a2 * y;
+                x = y;
+            }
+
+            data[i] = x;
+        }
+
+        // Flush denormals once per block rather than per sample
+        for (auto& s : state)
+        {
+            juce::dsp::util::snapToZero(s.s1);
+            juce::dsp::util::snapToZero(s.s2);
+        }
+
+        m_state = state;
+    }
+
+private:
+    struct State
+    {
+        float s1 = 0.0f;
+        float s2 = 0.0f;
+    };
+
+    std::array<BiquadCoefficients, NumStages> m_coefficients {};
+    std::array<State, NumStages> m_state {};
+};
+
+/**
+ * Butterworth-response state variable lowpass for a modulated cutoff: the same
+ * trapezoidal-integrator filter as juce::dsp::StateVariableTPTFilter, in the
+ * form that keeps the per-sample feedback path short. The caller moves the
+ * cutoff once per sub-block and g is interpolated linearly across it, so sweeps
+ * are smooth without a tan() per sample.
+ */
+class ModulatedLowpass
+{
+public:
+    void prepare(double sampleRate) noexcept
+    {
+        m_sampleRate = sampleRate;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        m_ic1 = 0.0f;
+        m_ic2 = 0.0f;
+    }
+
+    // Jumps straight to a cutoff, e.g. before the first block
+    void setCutoffFrequency(float cutoffHz) noexcept { m_g = computeG(cutoffHz); }
+
+    // In place, gliding from the current cutoff to targetCutoffHz over numSamples
+    void process(float* data, int numSamples, float targetCutoffHz) noexcept
+    {
+        const float targetG = computeG(targetCutoffHz);
+        const float gStep = (targetG - m_g) / static_cast<float>(juce::jmax(1, numSamples));
+
+        // Mostly the cutoff is still, and the per-sample division can go
+        const bool gliding = gStep != 0.0f;
+
+        float g = m_g;
+        float a1 = 1.0f / (1.0f + targetG * (targetG + c_k));
+        float ic1 = m_ic1;
+        float ic2 = m_ic2;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (gliding)
+            {
+                g += gStep;
+                a1 = 1.0f / (1.0f + g * (g + c_k));
+            }
+
+            const float a2 = g * a1;
+            const float a3 = g * a2;
+
+            const float v3 = data[i] - ic2;
+            const float v1 = a1 * ic1 + a2 * v3;
+            const float v2 = ic2 + a2 * ic1 + a3 * v3;
+
+            ic1 = 2.0f * v1 - ic1;
+            ic2 = 2.0f * v2 - ic2;
+
+            data[i] = v2;
+        }
+
+        juce::dsp::util::snapToZero(ic1);
+        juce::dsp::util::snapToZero(ic2);
+
+        m_g = targetG;
+        m_ic1 = ic1;
+        m_ic2 = ic2;
+    }
+
+private:
+    float computeG(float cutoffHz) const noexcept
+    {
+        const double nyquistSafe = juce::jmin(static_cast<double>(cutoffHz), m_sampleRate * 0.49);
+        return static_cast<float>(std::tan(juce::MathConstants<double>::pi * nyquistSafe / m_sampleRate));
+    }
+
+    static constexpr float c_k = 1.41421356f;  // 1 / Q for a Q of 1/sqrt(2)
+
+    double m_sampleRate = 44100.0;
+    float m_g = 0.0f;
+    float m_ic1 = 0.0f;   // Integrator states
+    float m_ic2 = 0.0f;
+};
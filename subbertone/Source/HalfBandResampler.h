@@ -0,0 +1,162 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+
+/**
+ * Polyphase IIR half-band filter for 2x up and down sampling. The half-band is
+ * split into two chains of first-order allpasses running at the lower rate, one
+ * per output phase, so each direction costs NumCoefficients multiplies per
+ * low-rate sample, far less than an FIR of similar rejection. The phase
+ * response isn't linear, but it is close to a pure delay (getLatencyInSamples)
+ * across the sub's range.
+ *
+ * Coefficients come from the elliptic design by Valenzuela and Constantinides,
+ * given the number of coefficients and the transition bandwidth as a fraction
+ * of the higher rate.
+ */
+template <size_t NumCoefficients>
+class HalfBandResampler
+{
+public:
+    static_assert(NumCoefficients % 2 == 0, "Both allpass chains need the same length");
+
+    void design(double transitionBandwidth) noexcept
+    {
+        const double pi = juce::MathConstants<double>::pi;
+        const int order = static_cast<int>(NumCoefficients) * 2 + 1;
+
+        const double kRoot = std::tan((1.0 - 2.0 * transitionBandwidth) * pi / 4.0);
+        const double k = kRoot * kRoot;
+        const double kk = std::pow(1.0 - k * k, 0.25);
+        const double e = 0.5 * (1.0 - kk) / (1.0 + kk);
+        const double e4 = std::pow(e, 4.0);
+        const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+        double latency = 0.0;
+
+        for (size_t index = 0; index < NumCoefficients; ++index)
+        {
+            const double c = static_cast<double>(index + 1);
+
+            // Both series converge within a handful of terms for any sensible q
+            double numerator = 0.0;
+            double denominator = 0.0;
+
+            for (int i = 0; i < 10; ++i)
+                numerator += ((i % 2) == 0 ? 1.0 : -1.0) * std::pow(q, i * (i + 1)) * std::sin((2 * i + 1) * c * pi / order);
+
+            for (int i = 1; i < 10; ++i)
+                denominator += ((i % 2) == 0 ? 1.0 : -1.0) * std::pow(q, i * i) * std::cos(2 * i * c * pi / order);
+
+            const double ww = numerator * std::pow(q, 0.25) / (denominator + 0.5);
+            const double wwSquared = ww * ww;
+            const double x = std::sqrt((1.0 - wwSquared * k) * (1.0 - wwSquared / k)) / (1.0 + wwSquared);
+            const double coefficient = (1.0 - x) / (1.0 + x);
+
+            m_coefficients[index] = static_cast<float>(coefficient);
+
+            // Each allpass delays low frequencies by (1 - c) / (1 + c) low-rate samples
+            latency += (1.0 - coefficient) / (1.0 + coefficient);
+        }
+
+        // Up then down, every stage is passed once by one or other chain
+        m_latency = static_cast<float>(latency);
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        m_upState = {};
+        m_downState = {};
+    }
+
+    // Round trip delay of upsample() then downsample(), in low-rate samples
+    float getLatencyInSamples() const noexcept { return m_latency; }
+
+    // numSamples in, 2 * numSamples out
+    void upsample(const float* input, float* output, int numSamples) noexcept
+    {
+        const auto coefficients = m_coefficients;
+        auto state = m_upState;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float even = input[i];
+            float odd = input[i];
+            processChains(even, odd, coefficients, state);
+
+            output[2 * i] = even;
+            output[2 * i + 1] = odd;
+        }
+
+        flushDenormals(state);
+        m_upState = state;
+    }
+
+    // 2 * numSamples in, numSamples out
+    void downsample(const float* input, float* output, int numSamples) noexcept
+    {
+        const auto coefficients = m_coefficients;
+        auto state = m_downState;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float even = input[2 * i + 1];
+            float odd = input[2 * i];
+            processChains(even, odd, coefficients, state);
+
+            output[i] = 0.5f * (even + odd);
+        }
+
+        flushDenormals(state);
+        m_downState = state;
+    }
+
+private:
+    struct AllpassState
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+    };
+
+    using Coefficients = std::array<float, NumCoefficients>;
+    using State = std::array<AllpassState, NumCoefficients>;
+
+    // Coefficients alternate between the two chains; the stages are unrolled and the
+    // two chains are independent, so they issue side by side. Each allpass is
+    // y = c * x + x[-1] - c * y[-1], ordered so only the last multiply and subtract
+    // wait on the previous output and successive samples overlap.
+    static void processChains(float& even, float& odd, const Coefficients& coefficients, State& state) noexcept
+    {
+        for (size_t stage = 0; stage < NumCoefficients; stage += 2)
+        {
+            const float evenOut = (coefficients[stage] * even + state[stage].x) - coefficients[stage] * state[stage].y;
+            const float oddOut = (coefficients[stage + 1] * odd + state[stage + 1].x) - coefficients[stage + 1] * state[stage + 1].y;
+
+            state[stage].x = even;
+            state[stage].y = evenOut;
+            state[stage + 1].x = odd;
+            state[stage + 1].y = oddOut;
+
+            even = evenOut;
+            odd = oddOut;
+        }
+    }
+
+    static void flushDenormals(State& state) noexcept
+    {
+        for (auto& allpass : state)
+        {
+            juce::dsp::util::snapToZero(allpass.x);
+            juce::dsp::util::snapToZero(allpass.y);
+        }
+    }
+
+    Coefficients m_coefficients {};
+    State m_upState {};
+    State m_downState {};
+    float m_latency = 0.0f;
+};
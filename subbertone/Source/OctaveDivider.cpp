@@ -0,0 +1,164 @@
+#include "OctaveDivider.h"
+#include <cmath>
+
+namespace
+{
+    // Wraps a phase difference into [-0.5, 0.5) cycles
+    double wrapPhaseError(double error)
+    {
+        return error - std::floor(error + 0.5);
+    }
+}
+
+void OctaveDivider::prepare(double sampleRate, float minFrequency, float maxFrequency)
+{
+    m_sampleRate = sampleRate;
+    m_minPeriod = sampleRate / static_cast<double>(maxFrequency);
+    m_maxPeriod = sampleRate / static_cast<double>(minFrequency);
+    m_envelopeRelease = static_cast<float>(std::exp(-1000.0 / (c_envelopeReleaseMs * sampleRate)));
+
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = 1;
+    spec.numChannels = 1;
+
+    m_highpassFilter.prepare(spec);
+    m_highpassFilter.setType(juce::dsp::StateVariableTPTFilterType::highpass);
+    m_highpassFilter.setCutoffFrequency(minFrequency * 0.5f);
+
+    m_lowpassFilter1.prepare(spec);
+    m_lowpassFilter1.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
+
+    m_lowpassFilter2.prepare(spec);
+    m_lowpassFilter2.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
+
+    setBandLimit(maxFrequency);
+    reset();
+}
+
+void OctaveDivider::reset()
+{
+    m_highpassFilter.reset();
+    m_lowpassFilter1.reset();
+    m_lowpassFilter2.reset();
+
+    m_envelope = 0.0f;
+    m_previousSample = 0.0f;
+    m_triggerHigh = false;
+
+    m_samplesSinceCrossing = m_maxPeriod * 2.0;
+    m_period = 0.0;
+    m_agreeingPeriods = 0;
+    m_locked = false;
+
+    m_phase = 0.0;
+    m_phaseIncrement = 0.0;
+    m_flipFlop = false;
+}
+
+void OctaveDivider::setBandLimit(float cutoffHz)
+{
+    const float cutoff = juce::jlimit(20.0f, static_cast<float>(m_sampleRate * 0.45), cutoffHz);
+
+    m_lowpassFilter1.setCutoffFrequency(cutoff);
+    m_lowpassFilter2.setCutoffFrequency(cutoff);
+}
+
+float OctaveDivider::getInputFrequency() const noexcept
+{
+    return (m_locked && m_period > 0.0) ? static_cast<float>(m_sampleRate / m_period) : 0.0f;
+}
+
+float OctaveDivider::processSample(float input) noexcept
+{
+    // Sub oscillator runs freely between crossings
+    m_phase += m_phaseIncrement;
+    m_phase -= std::floor(m_phase);
+
+    // Band limited detector signal
+    const float highPassed = m_highpassFilter.processSample(0, input);
+    const float sample = m_lowpassFilter2.processSample(0, m_lowpassFilter1.processSample(0, highPassed));
+
+    // Peak envelope for the hysteresis
+    const float magnitude = std::abs(sample);
+    m_envelope = (magnitude > m_envelope) ? magnitude : m_envelope * m_envelopeRelease;
+
+    m_samplesSinceCrossing += 1.0;
+
+    const float hysteresis = c_hysteresis * m_envelope;
+
+    if (!m_triggerHigh && m_envelope > c_envelopeFloor && sample > hysteresis)
+    {
+        m_triggerHigh = true;
+
+        // Where between the last two samples the threshold was crossed
+        const float fraction = (hysteresis - m_previousSample) / (sample - m_previousSample);
+        onRisingCrossing(1.0 - static_cast<double>(juce::jlimit(0.0f, 1.0f, fraction)));
+    }
+    else if (m_triggerHigh && sample < -hysteresis)
+    {
+        m_triggerHigh = false;
+    }
+
+    m_previousSample = sample;
+
+    // Nothing for too long: drop the lock and resync hard on the next note
+    if (m_samplesSinceCrossing > m_maxPeriod * 2.0 && m_period > 0.0)
+    {
+        m_locked = false;
+        m_agreeingPeriods = 0;
+        m_period = 0.0;
+    }
+
+    return static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * m_phase));
+}
+
+void OctaveDivider::onRisingCrossing(double crossingOffset) noexcept
+{
+    // crossingOffset is how long ago, in samples, the crossing actually happened
+    const double period = m_samplesSinceCrossing - crossingOffset;
+    const bool resync = m_period <= 0.0;
+    m_samplesSinceCrossing = crossingOffset;
+
+    if (period < m_minPeriod || period > m_maxPeriod)
+    {
+        // Out of range, most likely noise or a harmonic getting through
+        m_agreeingPeriods = 0;
+        m_locked = false;
+        return;
+    }
+
+    if (!resync && std::abs(period - m_period) <= c_periodTolerance * m_period)
+    {
+        ++m_agreeingPeriods;
+        m_period = 0.5 * (m_period + period);
+    }
+    else
+    {
+        m_agreeingPeriods = 0;
+        m_period = period;
+    }
+
+    const bool wasLocked = m_locked;
+    m_locked = m_agreeingPeriods + 1 >= c_periodsToLock;
+    m_phaseIncrement = 0.5 / m_period;
+
+    // Locked, each crossing starts the other half of the sub's cycle. Otherwise
+    // take whichever half is nearer, so a note change doesn't jump the phase.
+    if (wasLocked)
+        m_flipFlop = !m_flipFlop;
+    else
+        m_flipFlop = std::abs(wrapPhaseError(m_phase)) <= 0.25;
+
+    const double expectedPhase = (m_flipFlop ? 0.0 : 0.5) + m_phaseIncrement * crossingOffset;
+
+    if (resync)
+    {
+        // Coming out of silence there's no running phase worth keeping
+        m_phase = expectedPhase - std::floor(expectedPhase);
+        return;
+    }
+
+    m_phase += c_phaseCorrection * wrapPhaseError(expectedPhase - m_phase);
+    m_phase -= std::floor(m_phase);
+}
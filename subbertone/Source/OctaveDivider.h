@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * Zero-latency octave divider, after the analogue subharmonic boxes: the input
+ * is band limited to its fundamental, a Schmitt trigger finds each rising
+ * crossing and every other crossing flips the sub's half cycle. Rather than
+ * output the flip-flop's square wave, a phase locked sine follows it, so the
+ * sub stays clean and band limited while tracking note changes within a
+ * couple of periods. O(1) per sample.
+ *
+ * The caller steers the band limit (ideally from a slower, more robust pitch
+ * estimate) so upper harmonics can't retrigger the detector.
+ */
+class OctaveDivider
+{
+public:
+    OctaveDivider()  = default;
+    ~OctaveDivider() = default;
+
+    void prepare(double sampleRate, float minFrequency, float maxFrequency);
+    void reset();
+
+    // Lowpass on the detector path; somewhat above the expected fundamental
+    void setBandLimit(float cutoffHz);
+
+    // Returns the sub one octave down, unit amplitude
+    float processSample(float input) noexcept;
+
+    // True while successive periods agree
+    bool isLocked() const noexcept { return m_locked; }
+
+    // Fundamental of the input (the sub is half of this), 0 when unlocked
+    float getInputFrequency() const noexcept;
+
+private:
+    void onRisingCrossing(double crossingOffset) noexcept;
+
+    double m_sampleRate = 44100.0;
+
+    // Detector path: DC block then a 4-pole lowpass
+    juce::dsp::StateVariableTPTFilter<float> m_highpassFilter;
+    juce::dsp::StateVariableTPTFilter<float> m_lowpassFilter1;
+    juce::dsp::StateVariableTPTFilter<float> m_lowpassFilter2;
+
+    // Schmitt trigger with hysteresis relative to the signal's envelope
+    float m_envelope = 0.0f;
+    float m_envelopeRelease = 0.0f;  // Computed in prepare()
+    float m_previousSample = 0.0f;
+    bool m_triggerHigh = false;
+
+    // Period measurement between rising crossings, in samples
+    double m_samplesSinceCrossing = 0.0;
+    double m_period = 0.0;
+    double m_minPeriod = 0.0;
+    double m_maxPeriod = 0.0;
+    int m_agreeingPeriods = 0;
+    bool m_locked = false;
+
+    // Sub oscillator: phase in cycles, locked to 0 and 0.5 on alternate crossings
+    double m_phase = 0.0;
+    double m_phaseIncrement = 0.0;
+    bool m_flipFlop = false;
+
+    static constexpr float c_hysteresis = 0.15f;          // Fraction of the envelope
+    static constexpr float c_envelopeReleaseMs = 50.0f;
+    static constexpr float c_envelopeFloor = 1.0e-4f;     // Ignore crossings in near silence
+    static constexpr double c_periodTolerance = 0.12;     // Successive periods must agree within this
+    static constexpr int c_periodsToLock = 2;
+    static constexpr double c_phaseCorrection = 0.5;      // Fraction of the phase error taken out per crossing
+};
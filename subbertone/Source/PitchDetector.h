@@ -1,11 +1,10 @@
 #pragma once
 
-#include <vector>
+#include "YinPitchTracker.h"
 
 /**
- * YIN Pitch Detection Algorithm
- * Based on: http://audition.ens.fr/adc/pdf/2002_JASA_YIN.pdf
- * Adapted from: https://github.com/ashokfernandez/Yin-Pitch-Tracking
+ * Fundamental tracker for the subharmonic generator: gates quiet input, analyses
+ * every half window with the shared YIN tracker and smooths the estimates.
  */
 class PitchDetector
 {
@@ -20,22 +19,9 @@ public:
     float getProbability() const { return m_probability; }
 
 private:
-    // YIN algorithm steps
-    void yinDifference(const float* buffer, int halfLength);
-    void yinCumulativeMeanNormalizedDifference(int halfLength);
-    int yinAbsoluteThreshold(int halfLength);
-    float yinParabolicInterpolation(int tauEstimate, int halfLength);
+    void updateSmoothedPitch(float detectedPitch);
 
-    // Core detection
-    float detectPitchYIN(const float* buffer, int bufferLength);
-
-    double m_sampleRate = 0.0;
-    int m_bufferSize = 0;
-    int m_halfBufferSize = 0;
-
-    // YIN algorithm buffers
-    std::vector<float> m_yinBuffer;           // Stores intermediate YIN processing results
-    std::vector<float> m_inputAccumulator;    // Accumulates input samples
+    YinPitchTracker m_tracker;
 
     float m_probability = 0.0f;   // Confidence of detected pitch (0.0 - 1.0)
     float m_yinThreshold = 0.15f; // YIN threshold (lower = stricter detection)
@@ -50,5 +36,4 @@ private:
     static constexpr float c_maxFrequency = 1000.0f; // 1000 Hz maximum
 
     bool m_isPrepared = false;
-    int m_samplesSinceLastAnalysis = 0;
 };
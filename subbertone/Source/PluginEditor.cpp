@@ -19,6 +19,9 @@ SubbertoneAudioProcessorEditor::SubbertoneAudioProcessorEditor(SubbertoneAudioPr
     , m_pitchThresholdAttachment(m_audioProcessor.m_parameters, "pitchThreshold", m_pitchThresholdSlider)
     , m_fundamentalLimitAttachment(m_audioProcessor.m_parameters, "fundamentalLimit", m_fundamentalLimitSlider)
     , m_distortionTypeAttachment(m_audioProcessor.m_parameters, "distortionType", m_distortionTypeCombo)
+    , m_subTrackingAttachment(m_audioProcessor.m_parameters, "subTracking", m_subTrackingCombo)
+    , m_subVoicesAttachment(m_audioProcessor.m_parameters, "subVoices", m_subVoicesCombo)
+    , m_driveOversamplingAttachment(m_audioProcessor.m_parameters, "driveOversampling", m_driveOversamplingCombo)
 {
     setLookAndFeel(&m_lookAndFeel);
 
@@ -59,6 +62,81 @@ SubbertoneAudioProcessorEditor::SubbertoneAudioProcessorEditor(SubbertoneAudioPr
     m_distortionTypeLabel.setJustificationType(juce::Justification::centred);
     m_distortionTypeLabel.attachToComponent(&m_distortionTypeCombo, false);
     addAndMakeVisible(m_distortionTypeLabel);
+
+    // Setup sub tracking combo
+    m_subTrackingCombo.addItem("Pitch", 1);
+    m_subTrackingCombo.addItem("Octave Divider", 2);
+    m_subTrackingCombo.setTooltip("How the sub follows the input:\n"
+                                  "- Pitch: Smooth sine retuned from the pitch detector\n"
+                                  "- Octave Divider: Analogue-style divider locked to the input, follows notes instantly");
+
+    if (const std::atomic<float>* const subTrackingParam =
+            m_audioProcessor.m_parameters.getRawParameterValue("subTracking"))
+    {
+        const int restoredIndex = juce::jlimit(0, m_subTrackingCombo.getNumItems() - 1,
+                                               static_cast<int>(subTrackingParam->load()));
+        m_subTrackingCombo.setSelectedItemIndex(restoredIndex, juce::dontSendNotification);
+    }
+
+    addAndMakeVisible(m_subTrackingCombo);
+
+    m_subTrackingLabel.setText("Sub Tracking", juce::dontSendNotification);
+    m_subTrackingLabel.setJustificationType(juce::Justification::centred);
+    m_subTrackingLabel.attachToComponent(&m_subTrackingCombo, false);
+    addAndMakeVisible(m_subTrackingLabel);
+
+    // Setup sub voices combo
+    m_subVoicesCombo.addItem("Octave", 1);
+    m_subVoicesCombo.addItem("Octave + Two Octaves", 2);
+    m_subVoicesCombo.addItem("Octave + Fifth", 3);
+    m_subVoicesCombo.addItem("All", 4);
+    m_subVoicesCombo.setTooltip("Sine voices under the input, mixed at equal power:
+"
+                                "- Octave: One octave down
+"
+                                "- Two Octaves: Adds a voice two octaves down
+"
+                                "- Fifth: Adds a voice a fifth below the input
+"
+                                "Octave Divider tracking always plays the octave alone");
+
+    if (const std::atomic<float>* const subVoicesParam =
+            m_audioProcessor.m_parameters.getRawParameterValue("subVoices"))
+    {
+        const int restoredIndex = juce::jlimit(0, m_subVoicesCombo.getNumItems() - 1,
+                                               static_cast<int>(subVoicesParam->load()));
+        m_subVoicesCombo.setSelectedItemIndex(restoredIndex, juce::dontSendNotification);
+    }
+
+    addAndMakeVisible(m_subVoicesCombo);
+
+    m_subVoicesLabel.setText("Sub Voices", juce::dontSendNotification);
+    m_subVoicesLabel.setJustificationType(juce::Justification::centred);
+    m_subVoicesLabel.attachToComponent(&m_subVoicesCombo, false);
+    addAndMakeVisible(m_subVoicesLabel);
+
+    // Setup drive oversampling combo
+    m_driveOversamplingCombo.addItem("Off", 1);
+    m_driveOversamplingCombo.addItem("2x", 2);
+    m_driveOversamplingCombo.addItem("4x", 3);
+    m_driveOversamplingCombo.setTooltip("Runs the distortion at a higher rate so its harmonics don't fold back
+"
+                                        "as aliasing. 4x is cleanest on the harder curves, at more CPU.");
+
+    if (const std::atomic<float>* const driveOversamplingParam =
+            m_audioProcessor.m_parameters.getRawParameterValue("driveOversampling"))
+    {
+        const int restoredIndex = juce::jlimit(0, m_driveOversamplingCombo.getNumItems() - 1,
+                                               static_cast<int>(driveOversamplingParam->load()));
+        m_driveOversamplingCombo.setSelectedItemIndex(restoredIndex, juce::dontSendNotification);
+    }
+
+    addAndMakeVisible(m_driveOversamplingCombo);
+
+    m_driveOversamplingLabel.setText("Oversampling", juce::dontSendNotification);
+    m_driveOversamplingLabel.setJustificationType(juce::Justification::centred);
+    m_driveOversamplingLabel.attachToComponent(&m_driveOversamplingCombo, false);
+    addAndMakeVisible(m_driveOversamplingLabel);
     
     // Setup about button
     m_aboutButton.setButtonText("?");
@@ -68,6 +146,13 @@ SubbertoneAudioProcessorEditor::SubbertoneAudioProcessorEditor(SubbertoneAudioPr
     
     m_pitchThresholdLabel.setMinimumHorizontalScale(0.85f);
 
+    // Processing load, and whether silence is being skipped
+    m_loadLabel.setFont(juce::Font(juce::FontOptions("Courier New", 12.0f, juce::Font::plain)));
+    m_loadLabel.setColour(juce::Label::textColourId, juce::Colour(0xff00ffff).withAlpha(0.7f));
+    m_loadLabel.setJustificationType(juce::Justification::centredLeft);
+    m_loadLabel.setTooltip("Processing time as a share of each block. Idle means the input is silent and processing is skipped.");
+    addAndMakeVisible(m_loadLabel);
+
     setSize(900, 550);
     
     // Start timer for signal level updates
@@ -83,6 +168,7 @@ SubbertoneAudioProcessorEditor::~SubbertoneAudioProcessorEditor()
 void SubbertoneAudioProcessorEditor::layoutTopBar(juce::Rectangle<int>& bounds)
 {
     m_aboutButton.setBounds(bounds.getWidth() - 40, 10, 30, 30);
+    m_loadLabel.setBounds(10, 10, 160, 30);
 }
 
 void SubbertoneAudioProcessorEditor::layoutVisualizer(juce::Rectangle<int>& bounds)
@@ -138,7 +224,21 @@ void SubbertoneAudioProcessorEditor::layoutControls(juce::Rectangle<int>& bounds
 
     constexpr int comboWidth = 130;
     constexpr int comboHeight = 24;
-    m_distortionTypeCombo.setBounds(comboRow.removeFromTop(comboHeight).withSizeKeepingCentre(comboWidth, comboHeight));
+    const juce::Rectangle<int> comboStrip = comboRow.removeFromTop(comboHeight);
+    m_distortionTypeCombo.setBounds(comboStrip.withSizeKeepingCentre(comboWidth, comboHeight));
+
+    // Under the pitch controls
+    const int pitchPairCentreX = leftStart + slotWidth + (pairGap / 2);
+    m_subTrackingCombo.setBounds(juce::Rectangle<int>(comboWidth, comboHeight).withCentre({ pitchPairCentreX, comboStrip.getCentreY() }));
+
+    // Under the mix/output pair
+    const int outputPairCentreX = rightStart + slotWidth + (pairGap / 2);
+    m_subVoicesCombo.setBounds(juce::Rectangle<int>(comboWidth, comboHeight).withCentre({ outputPairCentreX, comboStrip.getCentreY() }));
+
+    // Under the post-drive lowpass, beside the distortion type
+    constexpr int oversamplingComboWidth = 90;
+    const int postDriveCentreX = middleStart + (2 * (slotWidth + middleGap)) + (slotWidth / 2);
+    m_driveOversamplingCombo.setBounds(juce::Rectangle<int>(oversamplingComboWidth, comboHeight).withCentre({ postDriveCentreX, comboStrip.getCentreY() }));
 }
 
 void SubbertoneAudioProcessorEditor::resized()
@@ -215,6 +315,13 @@ void SubbertoneAudioProcessorEditor::timerCallback()
                                     : juce::String::formatted("Signal (RMS): %.1f dB", signalDb);
     
     m_waveformVisualizer.setSignalText(levelText, signalDb > threshold);
+
+    juce::String loadText = juce::String::formatted("CPU %.1f%%", m_audioProcessor.getProcessLoad());
+
+    if (m_audioProcessor.isIdle())
+        loadText << " (idle)";
+
+    m_loadLabel.setText(loadText, juce::dontSendNotification);
 }
 
 
@@ -53,13 +53,20 @@ private:
     juce::Slider m_fundamentalLimitSlider;
     
     juce::ComboBox m_distortionTypeCombo;
+    juce::ComboBox m_subTrackingCombo;
+    juce::ComboBox m_subVoicesCombo;
+    juce::ComboBox m_driveOversamplingCombo;
     
     juce::Label m_mixLabel;
     juce::Label m_distortionLabel;
     juce::Label m_toneLabel;
     juce::Label m_postDriveLowpassLabel;
     juce::Label m_distortionTypeLabel;
+    juce::Label m_subTrackingLabel;
+    juce::Label m_subVoicesLabel;
+    juce::Label m_driveOversamplingLabel;
     juce::Label m_outputGainLabel;
+    juce::Label m_loadLabel;
     juce::Label m_pitchThresholdLabel;
     juce::Label m_fundamentalLimitLabel;
     
@@ -72,6 +79,9 @@ private:
     juce::AudioProcessorValueTreeState::SliderAttachment   m_pitchThresholdAttachment;
     juce::AudioProcessorValueTreeState::SliderAttachment   m_fundamentalLimitAttachment;
     juce::AudioProcessorValueTreeState::ComboBoxAttachment m_distortionTypeAttachment;
+    juce::AudioProcessorValueTreeState::ComboBoxAttachment m_subTrackingAttachment;
+    juce::AudioProcessorValueTreeState::ComboBoxAttachment m_subVoicesAttachment;
+    juce::AudioProcessorValueTreeState::ComboBoxAttachment m_driveOversamplingAttachment;
     
     // About button
     juce::TextButton m_aboutButton;
@@ -20,13 +20,7 @@ SubbertoneAudioProcessor::SubbertoneAudioProcessor()
 #endif
       , m_parameters(*this, nullptr, juce::Identifier("SubbertoneParameters"), createParameterLayout())
 {
-    // Double buffering for visualization
-    for (int i = 0; i < 2; ++i)
-    {
-        m_inputVisualBuffer[i].resize(c_visualBufferSize, 0.0f);
-        m_outputVisualBuffer[i].resize(c_visualBufferSize, 0.0f);
-        m_harmonicResidualVisualBuffer[i].resize(c_visualBufferSize, 0.0f);
-    }
+    m_waveformFeed.prepare(c_numWaveformLanes, c_visualNumBuckets, c_visualBufferSize / c_visualNumBuckets);
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout SubbertoneAudioProcessor::createParameterLayout()
@@ -51,7 +45,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout SubbertoneAudioProcessor::cr
 
         std::make_unique<juce::AudioParameterFloat>("pitchThreshold", "Pitch Threshold", -60.0f, -20.0f, -40.0f),
 
-        std::make_unique<juce::AudioParameterFloat>("fundamentalLimit", "Max Fundamental", 100.0f, 800.0f, 250.0f)
+        std::make_unique<juce::AudioParameterFloat>("fundamentalLimit", "Max Fundamental", 100.0f, 800.0f, 250.0f),
+
+        std::make_unique<juce::AudioParameterChoice>(juce::ParameterID("subTracking", 1), "Sub Tracking", juce::StringArray{"Pitch", "Octave Divider"}, 0),
+
+        std::make_unique<juce::AudioParameterChoice>(juce::ParameterID("subVoices", 1), "Sub Voices", juce::StringArray{"Octave", "Octave + Two Octaves", "Octave + Fifth", "All"}, 0),
+
+        std::make_unique<juce::AudioParameterChoice>(juce::ParameterID("driveOversampling", 1), "Drive Oversampling", juce::StringArray{"Off", "2x", "4x"}, 0)
     };
 
     return parameterLayout;
@@ -167,18 +167,20 @@ bool SubbertoneAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts
 
 void SubbertoneAudioProcessor::releaseResources()
 {
-
+    m_sessionRecorder.stop();
 }
 
 void SubbertoneAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    m_currentMaxProcessBlockSize = std::clamp(samplesPerBlock, 1, c_maxProcessBlockSize);
+    // At least c_minProcessBlockSize, so a host that prepares tiny blocks and then
+    // bounces with big ones isn't chopped into tiny sub-blocks
+    m_currentMaxProcessBlockSize = std::clamp(samplesPerBlock, c_minProcessBlockSize, c_maxProcessBlockSize);
 
     // Prepare processors
     m_pitchDetector.prepare(sampleRate);
     m_subharmonicBuffer.resize(m_currentMaxProcessBlockSize, 0.0f);
 
-    m_subharmonicEngine.prepare(sampleRate, samplesPerBlock);
+    m_subharmonicEngine.prepare(sampleRate, m_currentMaxProcessBlockSize);
     m_pitchDetectBuffer.resize(m_currentMaxProcessBlockSize, 0.0f);
 
     // Prepare parameters
@@ -196,6 +198,11 @@ void SubbertoneAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBl
     m_toneSmoothed.setCurrentAndTargetValue(m_parameterCache.m_distortionTone);
     m_postDriveLowpassSmoothed.setCurrentAndTargetValue(m_parameterCache.m_postDriveLowpass);
     m_outputGainSmoothed.setCurrentAndTargetValue(m_parameterCache.m_outputGain);
+
+    m_silenceTracker.prepare();
+    m_silenceTracker.setTailLength(static_cast<int>(c_idleTailSeconds * sampleRate));
+    m_loadMeasurer.reset(sampleRate, samplesPerBlock);
+    m_sessionRecorder.prepare(*this, sampleRate, samplesPerBlock);
 }
 
 void SubbertoneAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
@@ -204,17 +211,54 @@ void SubbertoneAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
 
     juce::ScopedNoDenormals noDenormals;
 
-    const int totalNumInputChannels  = getTotalNumInputChannels();
-    const int totalNumOutputChannels = getTotalNumOutputChannels();
-    const int numChannelsToProcess = std::min(totalNumInputChannels, totalNumOutputChannels);
     const int numSamples = buffer.getNumSamples();
 
-    if (numSamples > m_currentMaxProcessBlockSize)
+    if (numSamples <= 0)
+        return;
+
+    juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer(m_loadMeasurer, numSamples);
+
+    m_sessionRecorder.recordBlock(buffer);
+
+    // Silence in and the sub has released: skip the detector and the engine altogether.
+    // Their filters and oscillators have run down to rest, so nothing is lost.
+    if (m_silenceTracker.canSkipBlock(buffer, getTotalNumInputChannels(), numSamples, m_subharmonicEngine.hasReleased()))
     {
         buffer.clear();
+        m_currentSignalLevelDb.store(0.0f);
+        m_currentFundamental.store(0.0f);
         return;
     }
 
+    // Hosts (offline bounces especially) can hand us more than prepareToPlay promised.
+    // Everything runs in sub-blocks no larger than what we prepared for; all the state
+    // lives in members, so it carries straight across the boundaries.
+    if (numSamples <= m_currentMaxProcessBlockSize)
+    {
+        processSubBlock(buffer);
+    }
+    else
+    {
+        float* const* channels = buffer.getArrayOfWritePointers();
+
+        for (int start = 0; start < numSamples; start += m_currentMaxProcessBlockSize)
+        {
+            const int subBlockSize = std::min(m_currentMaxProcessBlockSize, numSamples - start);
+            juce::AudioBuffer<float> subBlock(channels, buffer.getNumChannels(), start, subBlockSize);
+            processSubBlock(subBlock);
+        }
+    }
+
+    m_silenceTracker.blockProcessed(buffer, getTotalNumOutputChannels(), numSamples);
+}
+
+void SubbertoneAudioProcessor::processSubBlock(juce::AudioBuffer<float>& buffer)
+{
+    const int totalNumInputChannels  = getTotalNumInputChannels();
+    const int totalNumOutputChannels = getTotalNumOutputChannels();
+    const int numChannelsToProcess = std::min(totalNumInputChannels, totalNumOutputChannels);
+    const int numSamples = buffer.getNumSamples();
+
     for (int i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, numSamples);
 
@@ -270,6 +314,11 @@ void SubbertoneAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
     m_currentFundamental.store(detectedFundamental);
 
     // STEP 2: Process subharmonic engine with CURRENT fundamental
+    // (in octave divider mode it follows the mono input directly)
+    m_subharmonicEngine.setTrackingMode(static_cast<SubharmonicEngine::TrackingMode>(m_parameterCache.m_subTracking));
+    m_subharmonicEngine.setFundamentalLimit(fundamentalLimit);
+    m_subharmonicEngine.setSubVoices(static_cast<SubharmonicEngine::SubVoices>(m_parameterCache.m_subVoices));
+    m_subharmonicEngine.setDistortionOversampling(static_cast<SubDistortion::Oversampling>(m_parameterCache.m_driveOversampling));
     m_subharmonicEngine.process(m_subharmonicBuffer.data(), 
                                 numSamples,
                                 detectedFundamental,
@@ -277,7 +326,8 @@ void SubbertoneAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
                                 distortionType,
                                 distortionTone, 
                                 postDriveLowpass, 
-                                inputActive);
+                                inputActive,
+                                m_pitchDetectBuffer.data());
     
     // STEP 3: Apply mix + Output gain
     for (int channel = 0; channel < numChannelsToProcess; ++channel)
@@ -317,6 +367,9 @@ void SubbertoneAudioProcessor::updateParameterCache()
     m_parameterCache.m_outputGain       = juce::Decibels::decibelsToGain(m_parameters.getRawParameterValue("outputGain")->load());
     m_parameterCache.m_pitchThreshold   = std::pow(10.0f, m_parameters.getRawParameterValue("pitchThreshold")->load() / 20.0f);
     m_parameterCache.m_fundamentalLimit = m_parameters.getRawParameterValue("fundamentalLimit")->load();
+    m_parameterCache.m_subTracking      = static_cast<int>(m_parameters.getRawParameterValue("subTracking")->load());
+    m_parameterCache.m_subVoices        = static_cast<int>(m_parameters.getRawParameterValue("subVoices")->load());
+    m_parameterCache.m_driveOversampling = static_cast<int>(m_parameters.getRawParameterValue("driveOversampling")->load());
 }
 
 void SubbertoneAudioProcessor::updateVisualizerBuffers(juce::AudioBuffer<float>& buffer)
@@ -329,63 +382,15 @@ void SubbertoneAudioProcessor::updateVisualizerBuffers(juce::AudioBuffer<float>&
 
     const std::vector<float>& harmonicResidual = m_subharmonicEngine.getHarmonicResidualBuffer();
 
-    const int writeIndex = 1 - m_visualReadIndex.load(std::memory_order_relaxed);
-    const int baseWritePos = m_visualBufferWritePos[writeIndex].load(std::memory_order_relaxed);
+    const int numResidualSamples = juce::jmin(numSamples, static_cast<int>(harmonicResidual.size()));
 
-    for (int i = 0; i < numSamples; ++i)
-    {
-        const int writePos = (baseWritePos + i) % c_visualBufferSize;
-
-        m_inputVisualBuffer[writeIndex][writePos]  = m_pitchDetectBuffer[i];
-        m_outputVisualBuffer[writeIndex][writePos] = outputData[i];
-        m_harmonicResidualVisualBuffer[writeIndex][writePos] = (i < static_cast<int>(harmonicResidual.size())) ? harmonicResidual[i] : 0.0f;
-    }
+    m_waveformFeed.push(c_inputLane, m_pitchDetectBuffer.data(), numSamples);
+    m_waveformFeed.push(c_outputLane, outputData, numSamples);
+    m_waveformFeed.push(c_harmonicResidualLane, harmonicResidual.data(), numResidualSamples);
 
-    m_visualBufferWritePos[writeIndex].store((baseWritePos + numSamples) % c_visualBufferSize, std::memory_order_relaxed);
-    m_visualReadIndex.store(writeIndex, std::memory_order_release);
-}
-
-void SubbertoneAudioProcessor::getInputWaveform(std::vector<float>& dest) const
-{
-    if (dest.size() != c_visualBufferSize)
-        dest.resize(c_visualBufferSize);
+    // Residual may be shorter than the block; the remainder reads as silence
+    if (numResidualSamples < numSamples)
+        m_waveformFeed.pushSilence(c_harmonicResidualLane, numSamples - numResidualSamples);
 
-    const int readIndex = m_visualReadIndex.load(std::memory_order_acquire);
-    const int readPos   = m_visualBufferWritePos[readIndex].load(std::memory_order_relaxed);
-    
-    // Copy from circular buffer in the correct order
-    for (int i = 0; i < c_visualBufferSize; ++i)
-    {
-        dest[i] = m_inputVisualBuffer[readIndex][(readPos + i) % c_visualBufferSize];
-    }
-}
-
-void SubbertoneAudioProcessor::getOutputWaveform(std::vector<float>& dest) const
-{
-    if (dest.size() != c_visualBufferSize)
-        dest.resize(c_visualBufferSize);
-
-    const int readIndex = m_visualReadIndex.load(std::memory_order_acquire);
-    const int readPos   = m_visualBufferWritePos[readIndex].load(std::memory_order_relaxed);
-    
-    // Copy from circular buffer in the correct order
-    for (int i = 0; i < c_visualBufferSize; ++i)
-    {
-        dest[i] = m_outputVisualBuffer[readIndex][(readPos + i) % c_visualBufferSize];
-    }
-}
-
-void SubbertoneAudioProcessor::getHarmonicResidualWaveform(std::vector<float>& dest) const
-{
-    if (dest.size() != c_visualBufferSize)
-        dest.resize(c_visualBufferSize);
-
-    const int readIndex = m_visualReadIndex.load(std::memory_order_acquire);
-    const int readPos   = m_visualBufferWritePos[readIndex].load(std::memory_order_relaxed);
-    
-    // Copy from circular buffer in the correct order
-    for (int i = 0; i < c_visualBufferSize; ++i)
-    {
-        dest[i] = m_harmonicResidualVisualBuffer[readIndex][(readPos + i) % c_visualBufferSize];
-    }
+    m_waveformFeed.publish();
 }
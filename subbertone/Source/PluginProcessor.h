@@ -4,6 +4,9 @@
 
 #include "SubharmonicEngine.h"
 #include "PitchDetector.h"
+#include "WaveformSummaryFeed.h"
+#include "SilenceTracker.h"
+#include "SessionRecorder.h"
 
 #include <array>
 
@@ -43,14 +46,18 @@ public:
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
-    // Get current waveform data for visualization
-    void getInputWaveform(std::vector<float>& dest) const;
-    void getOutputWaveform(std::vector<float>& dest) const;
-    void getHarmonicResidualWaveform(std::vector<float>& dest) const;
+    // Waveform overview for visualization: per-pixel peaks of each lane.
+    // Lock free, for a single reader (the visualizer).
+    enum WaveformLane { c_inputLane = 0, c_outputLane = 1, c_harmonicResidualLane = 2, c_numWaveformLanes };
+    const WaveformSummaryFeed::Summary& readWaveformSummary() { return m_waveformFeed.read(); }
 
     float getCurrentSignalLevel() const { return m_currentSignalLevelDb.load(); }
     float getCurrentFundamental() const { return m_currentFundamental.load(); }
 
+    // Processing time as a percentage of the block's duration, and whether silence is being skipped
+    float getProcessLoad() const { return static_cast<float>(m_loadMeasurer.getLoadAsPercentage()); }
+    bool isIdle() const { return m_silenceTracker.isIdle(); }
+
     // Parameters
     juce::AudioProcessorValueTreeState m_parameters;
 
@@ -65,11 +72,15 @@ private:
         float m_outputGain = 1.0f;
         float m_pitchThreshold = -40.0f;
         float m_fundamentalLimit = 250.0f;
+        int m_subTracking = 0;
+        int m_subVoices = 0;
+        int m_driveOversampling = 0;
     };
 
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
     void updateParameterCache();
+    void processSubBlock(juce::AudioBuffer<float>& buffer);
     void updateVisualizerBuffers(juce::AudioBuffer<float>& buffer);
 
     PitchDetector m_pitchDetector;
@@ -78,19 +89,26 @@ private:
     SubharmonicEngine m_subharmonicEngine;
     std::vector<float> m_pitchDetectBuffer;
     
-    // Circular buffers for visualization
+    // Visualization: the last 2048 samples in 512 buckets
     static constexpr int c_visualBufferSize = 2048;
-    static constexpr int c_maxProcessBlockSize = 8192;
+    static constexpr int c_visualNumBuckets = 512;
+    static constexpr int c_minProcessBlockSize = 512;
+    static constexpr int c_maxProcessBlockSize = 8192;  // Larger host blocks are processed in sub-blocks
+
+    // The sub's release, the filters ringing out and the drive's latency all fit well
+    // inside this; anything longer shows in the output and holds off idling anyway
+    static constexpr double c_idleTailSeconds = 0.5;
 
     int m_currentMaxProcessBlockSize = c_maxProcessBlockSize;
 
-    // Double buffering for visualization
-    std::array<std::vector<float>, 2> m_inputVisualBuffer;
-    std::array<std::vector<float>, 2> m_outputVisualBuffer;
-    std::array<std::vector<float>, 2> m_harmonicResidualVisualBuffer;
-    std::array<std::atomic<int>, 2> m_visualBufferWritePos{ 0, 0 };
+    WaveformSummaryFeed m_waveformFeed;
+
+    SilenceTracker m_silenceTracker;
+    juce::AudioProcessLoadMeasurer m_loadMeasurer;
+
+    // Opt-in capture of the input and automation, for replaying sessions offline
+    SessionRecorder m_sessionRecorder;
 
-    std::atomic<int> m_visualReadIndex{ 0 };
     std::atomic<float> m_currentFundamental{ 0.0f };
     std::atomic<float> m_currentSignalLevelDb{ -100.0f };
     
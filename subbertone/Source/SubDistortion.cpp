@@ -0,0 +1,177 @@
+#include "SubDistortion.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Below this amount every curve passes the signal through untouched
+    constexpr float c_bypassAmount = 0.001f;
+
+    // Min and max through abs: GCC turns compares into branches, and won't vectorise a
+    // loop that then divides. Selects between constants are fine.
+    inline float minOf(float a, float b) noexcept { return 0.5f * (a + b - std::abs(a - b)); }
+    inline float maxOf(float a, float b) noexcept { return 0.5f * (a + b + std::abs(a - b)); }
+
+    inline float driveFor(float amount) noexcept
+    {
+        return 1.0f + amount * 1.5f;  // Gentle pre-gain for analogue-style saturation
+    }
+
+    // Smooth tanh saturation - classic analogue tape emulation
+    inline float tapeSaturation(float x) noexcept
+    {
+        // The approximation holds to about 1e-4 over +-5 and only creeps past +-1 beyond.
+        // Past +-10 it's well over, and far enough out its x^7 overflows, so stop there.
+        const float limited = minOf(10.0f, maxOf(-10.0f, x));
+        return minOf(1.0f, maxOf(-1.0f, juce::dsp::FastMathApproximations::tanh(limited)));
+    }
+
+    // Valve/tube-style saturation with 2nd and 3rd harmonics; the negative side has a
+    // slightly different curve for tube asymmetry
+    inline float valveWarmth(float x) noexcept
+    {
+        const bool positive = x > 0.0f;
+        const float linear = positive ? 1.5f : 1.4f;
+        const float cubic = positive ? 0.5f : 0.6f;
+        const float out = linear * x - cubic * x * x * x;
+
+        return minOf(1.0f, maxOf(-1.0f, out));
+    }
+
+    // Console preamp-style soft knee: linear up to the threshold, logarithmic above it
+    inline float consoleDrive(float x) noexcept
+    {
+        constexpr float threshold = 0.7f;
+
+        // Flat past threshold + 5 anyway; limiting it keeps minOf() exact for huge inputs
+        const float magnitude = minOf(10.0f, std::abs(x));
+        const float excess = minOf(5.0f, maxOf(0.0f, magnitude - threshold));   // Range the log1p fit holds over
+        const float shaped = minOf(magnitude, threshold) + 0.5f * juce::dsp::FastMathApproximations::logNPlusOne(excess);
+
+        return std::copysign(shaped, x);
+    }
+
+    // Transformer-style gentle S-curve, (2 / pi) atan(x * pi / 2)
+    inline float transformer(float x) noexcept
+    {
+        constexpr float halfPi = juce::MathConstants<float>::halfPi;
+
+        // atan of |x| folded into [0, 1] with atan(x) = pi/2 - atan(1/x), then a
+        // degree 9 odd polynomial (error about 1e-5). The reciprocal is kept finite at
+        // zero, where min() through abs would make NaN of inf - inf.
+        const float magnitude = std::abs(x * halfPi);
+        const float folded = magnitude > 1.0f ? 1.0f : 0.0f;
+        const float t = minOf(magnitude, 1.0f / maxOf(magnitude, 1.0e-20f));
+        const float t2 = t * t;
+        const float atanT = t * (0.9998660f + t2 * (-0.3302995f + t2 * (0.1801410f + t2 * (-0.0851330f + t2 * 0.0208351f))));
+        const float angle = atanT + folded * (halfPi - 2.0f * atanT);
+
+        return std::copysign(angle / halfPi, x);
+    }
+
+    // One pass of a curve over a block. No calls or branches inside, so it vectorises.
+    template <typename Curve>
+    void shapeBlock(float* data, const float* amounts, int numSamples, float preGain, Curve curve) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // A blend rather than a select on the curve's result, for the same reason as minOf()
+            const float amount = amounts[i];
+            const float wet = amount < c_bypassAmount ? 0.0f : 1.0f;
+            const float shaped = curve(data[i] * driveFor(amount) * preGain);
+            data[i] += wet * (shaped - data[i]);
+        }
+    }
+}
+
+void SubDistortion::prepare(double sampleRate, int maxBlockSize)
+{
+    juce::ignoreUnused(sampleRate);
+
+    // Transition bands are relative to the rate, so the same design serves every host rate
+    m_firstStage.design(c_firstStageTransition);
+    m_secondStage.design(c_secondStageTransition);
+
+    const size_t maxSize = static_cast<size_t>(maxBlockSize);
+    m_twoTimesBuffer.assign(maxSize * 2, 0.0f);
+    m_fourTimesBuffer.assign(maxSize * 4, 0.0f);
+    m_amountBuffer.assign(maxSize * 4, 0.0f);
+
+    setOversampling(m_oversampling);
+    reset();
+}
+
+void SubDistortion::reset()
+{
+    m_firstStage.reset();
+    m_secondStage.reset();
+}
+
+void SubDistortion::setOversampling(Oversampling newOversampling) noexcept
+{
+    if (newOversampling != m_oversampling)
+    {
+        m_oversampling = newOversampling;
+        reset();
+    }
+
+    float latency = 0.0f;
+
+    if (m_oversampling != Oversampling::Off)
+        latency += m_firstStage.getLatencyInSamples();
+
+    if (m_oversampling == Oversampling::FourTimes)
+        latency += 0.5f * m_secondStage.getLatencyInSamples();  // Counted at twice the host rate
+
+    m_latencySamples = juce::roundToInt(latency);
+}
+
+void SubDistortion::process(float* data, const float* amounts, int numSamples, int type) noexcept
+{
+    numSamples = std::min(numSamples, static_cast<int>(m_twoTimesBuffer.size() / 2));
+
+    if (m_oversampling == Oversampling::Off)
+    {
+        shape(data, amounts, numSamples, type);
+        return;
+    }
+
+    const int factor = m_oversampling == Oversampling::FourTimes ? 4 : 2;
+    const int oversampledSize = numSamples * factor;
+
+    // Each drive amount holds for its host-rate sample
+    float* const oversampledAmounts = m_amountBuffer.data();
+
+    for (int i = 0; i < numSamples; ++i)
+        std::fill_n(oversampledAmounts + i * factor, factor, amounts[i]);
+
+    float* const twoTimes = m_twoTimesBuffer.data();
+    m_firstStage.upsample(data, twoTimes, numSamples);
+
+    if (factor == 4)
+    {
+        float* const fourTimes = m_fourTimesBuffer.data();
+
+        m_secondStage.upsample(twoTimes, fourTimes, numSamples * 2);
+        shape(fourTimes, oversampledAmounts, oversampledSize, type);
+        m_secondStage.downsample(fourTimes, twoTimes, numSamples * 2);
+    }
+    else
+    {
+        shape(twoTimes, oversampledAmounts, oversampledSize, type);
+    }
+
+    m_firstStage.downsample(twoTimes, data, numSamples);
+}
+
+void SubDistortion::shape(float* data, const float* amounts, int numSamples, int type) noexcept
+{
+    switch (type)
+    {
+        case SoftClip:  shapeBlock(data, amounts, numSamples, 1.0f, tapeSaturation); break;
+        case HardClip:  shapeBlock(data, amounts, numSamples, 1.0f, valveWarmth);    break;
+        case Tube:      shapeBlock(data, amounts, numSamples, 1.0f, consoleDrive);   break;
+        case Foldback:  shapeBlock(data, amounts, numSamples, 0.7f, transformer);    break;  // Reduced gain for a gentler effect
+        default:        break;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "HalfBandResampler.h"
+#include <vector>
+
+/**
+ * The sub's drive stage: four saturation curves, optionally run at 2x or 4x the
+ * host rate so harmonics above Nyquist are filtered out instead of folding
+ * back. Each curve is a branch-free rational or polynomial approximation over
+ * a whole block, which the compiler vectorises; the up and down samplers are
+ * polyphase IIR half-bands (HalfBandResampler).
+ *
+ * Oversampling delays the output by getLatencyInSamples(); callers comparing
+ * it against the dry signal should delay that to match.
+ */
+class SubDistortion
+{
+public:
+    // Choice order matches the "distortionType" parameter
+    enum Type
+    {
+        SoftClip = 0,   // "Tape Saturation"
+        HardClip,       // "Valve Warmth"
+        Tube,           // "Console Drive"
+        Foldback        // "Transformer"
+    };
+
+    enum class Oversampling
+    {
+        Off = 0,
+        TwoTimes,
+        FourTimes
+    };
+
+    SubDistortion()  = default;
+    ~SubDistortion() = default;
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    // Cheap enough for the audio thread; the samplers restart from silence on a change
+    void setOversampling(Oversampling newOversampling) noexcept;
+
+    // Host-rate samples, rounded
+    int getLatencyInSamples() const noexcept { return m_latencySamples; }
+
+    // In place. amounts holds the drive (0 to 1) for each sample.
+    void process(float* data, const float* amounts, int numSamples, int type) noexcept;
+
+private:
+    void shape(float* data, const float* amounts, int numSamples, int type) noexcept;
+
+    // 70dB of rejection with the passband to 0.3 of the host rate; the sub's harmonics
+    // that high are far down and the post-drive lowpass usually takes them anyway.
+    // The 4x stage only has that band to keep, so it can have a wide transition.
+    static constexpr size_t c_firstStageCoefficients = 4;
+    static constexpr size_t c_secondStageCoefficients = 4;
+    static constexpr double c_firstStageTransition = 0.1;
+    static constexpr double c_secondStageTransition = 0.17;
+
+    Oversampling m_oversampling = Oversampling::Off;
+    int m_latencySamples = 0;
+
+    HalfBandResampler<c_firstStageCoefficients> m_firstStage;
+    HalfBandResampler<c_secondStageCoefficients> m_secondStage;
+
+    // Scratch, sized in prepare()
+    std::vector<float> m_twoTimesBuffer;
+    std::vector<float> m_fourTimesBuffer;
+    std::vector<float> m_amountBuffer;
+};
@@ -0,0 +1,154 @@
+#include "SubOscillatorBank.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr int c_chunkSize = 16;
+
+    // Phase offsets of a gliding accumulator after j samples are j * increment + step * j(j+1)/2
+    constexpr std::array<float, c_chunkSize> c_ramp      { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+    constexpr std::array<float, c_chunkSize> c_triangle  { 0, 1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 66, 78, 91, 105, 120 };
+
+    // Adds gain * sin(2 * pi * phase) to dest, for phase in [0, 1). The phase is folded
+    // into a quarter cycle with a triangle (abs, no compares), then a degree 9 odd
+    // polynomial (error below 4e-6) is evaluated. No calls or branches, so it vectorises.
+    void addSine(const float* phase, float* dest, float gain, int numSamples) noexcept
+    {
+        constexpr float c1 =  1.5707963268f;   // (pi/2)^n / n!, alternating
+        constexpr float c3 = -0.6459640975f;
+        constexpr float c5 =  0.0796926262f;
+        constexpr float c7 = -0.0046817541f;
+        constexpr float c9 =  0.0001604411f;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // A quarter cycle on, sin(2 pi phase) = sin(pi/2 * z) for the triangle
+            // z = 1 - 4|shifted - 0.5|, which runs -1..1..-1 over the cycle
+            float shifted = phase[i] + 0.25f;
+            shifted -= static_cast<float>(static_cast<int>(shifted));
+
+            const float z = 1.0f - 4.0f * std::abs(shifted - 0.5f);
+            const float z2 = z * z;
+
+            dest[i] += gain * z * (c1 + z2 * (c3 + z2 * (c5 + z2 * (c7 + z2 * c9))));
+        }
+    }
+}
+
+void SubOscillatorBank::prepare(double sampleRate, int maxBlockSize)
+{
+    m_sampleRate = sampleRate;
+    m_glideSamples = std::max(1, static_cast<int>(c_glideSeconds * sampleRate));
+
+    m_phaseBuffer.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+
+    m_voices[OctaveDown].ratio = 0.5;
+    m_voices[TwoOctavesDown].ratio = 0.25;
+    m_voices[FifthDown].ratio = 2.0 / 3.0;
+
+    reset();
+    updateGains();
+}
+
+void SubOscillatorBank::reset()
+{
+    for (auto& voice : m_voices)
+    {
+        voice.phase = 0.0;
+        voice.increment = 0.0;
+        voice.incrementStep = 0.0;
+        voice.glideSamplesRemaining = 0;
+    }
+}
+
+void SubOscillatorBank::setVoiceLevel(Voice voice, float level)
+{
+    if (m_voices[voice].level != level)
+    {
+        m_voices[voice].level = level;
+        updateGains();
+    }
+}
+
+void SubOscillatorBank::updateGains()
+{
+    float sumOfSquares = 0.0f;
+
+    for (const auto& voice : m_voices)
+        sumOfSquares += voice.level * voice.level;
+
+    const float normalisation = sumOfSquares > 0.0f ? 1.0f / std::sqrt(sumOfSquares) : 0.0f;
+
+    for (size_t i = 0; i < m_voices.size(); ++i)
+        m_gains[i] = m_voices[i].level * normalisation;
+}
+
+void SubOscillatorBank::setFundamental(double fundamentalHz)
+{
+    for (auto& voice : m_voices)
+    {
+        const double targetIncrement = fundamentalHz * voice.ratio / m_sampleRate;
+
+        if (voice.increment <= 0.0)
+        {
+            // Starting from silence, nothing to glide from
+            voice.increment = targetIncrement;
+            voice.glideSamplesRemaining = 0;
+        }
+        else
+        {
+            voice.incrementStep = (targetIncrement - voice.increment) / static_cast<double>(m_glideSamples);
+            voice.glideSamplesRemaining = m_glideSamples;
+        }
+    }
+}
+
+void SubOscillatorBank::process(float* output, int numSamples) noexcept
+{
+    numSamples = std::min(numSamples, static_cast<int>(m_phaseBuffer.size()));
+    juce::FloatVectorOperations::clear(output, numSamples);
+
+    for (size_t v = 0; v < m_voices.size(); ++v)
+    {
+        auto& voice = m_voices[v];
+        const bool active = m_gains[v] > 0.0f;
+
+        // Phases a chunk at a time in closed form, so there's no per-sample dependency
+        // to serialise on. Silent voices still advance, so they come in at the right
+        // pitch and phase.
+        for (int start = 0; start < numSamples;)
+        {
+            const bool gliding = voice.glideSamplesRemaining > 0;
+            const int chunk = std::min({ c_chunkSize, numSamples - start, gliding ? voice.glideSamplesRemaining : c_chunkSize });
+            const double step = gliding ? voice.incrementStep : 0.0;
+
+            if (active)
+            {
+                const float basePhase = static_cast<float>(voice.phase);
+                const float increment = static_cast<float>(voice.increment);
+                const float stepFloat = static_cast<float>(step);
+                float* phases = m_phaseBuffer.data() + start;
+
+                for (int j = 0; j < chunk; ++j)
+                {
+                    const float phase = basePhase + c_ramp[static_cast<size_t>(j)] * increment + c_triangle[static_cast<size_t>(j)] * stepFloat;
+                    phases[j] = phase - static_cast<float>(static_cast<int>(phase));
+                }
+            }
+
+            // Advance past the chunk: chunk increments, each one step further on while gliding
+            voice.phase += chunk * voice.increment + step * (0.5 * chunk * (chunk + 1));
+            voice.phase -= std::floor(voice.phase);
+            voice.increment += chunk * step;
+
+            if (gliding)
+                voice.glideSamplesRemaining -= chunk;
+
+            start += chunk;
+        }
+
+        if (active)
+            addSine(m_phaseBuffer.data(), output, m_gains[v], numSamples);
+    }
+}
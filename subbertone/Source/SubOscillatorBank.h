@@ -0,0 +1,67 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+/**
+ * Bank of sine voices below a fundamental: an octave down, two octaves down and
+ * a fifth down. Each voice is a phase accumulator that glides to a new pitch
+ * sample by sample; a block of phases is turned into sines in one pass with a
+ * branch-free polynomial the compiler vectorises, so several voices cost about
+ * what one table-lookup oscillator did per sample.
+ *
+ * Voices at zero level are skipped. Levels are normalised to equal power so
+ * adding voices doesn't push the sum into the engine's clamp.
+ */
+class SubOscillatorBank
+{
+public:
+    enum Voice
+    {
+        OctaveDown = 0,
+        TwoOctavesDown,
+        FifthDown,
+        NumVoices
+    };
+
+    SubOscillatorBank()  = default;
+    ~SubOscillatorBank() = default;
+
+    void prepare(double sampleRate, int maxBlockSize);
+
+    // Silences the bank; the next fundamental starts every voice at phase zero without gliding
+    void reset();
+
+    void setVoiceLevel(Voice voice, float level);
+
+    // New target pitch, glided to over c_glideSeconds
+    void setFundamental(double fundamentalHz);
+
+    // Overwrites numSamples of output with the sum of the active voices
+    void process(float* output, int numSamples) noexcept;
+
+private:
+    struct VoiceState
+    {
+        double ratio = 0.5;               // Of the fundamental
+        float level = 0.0f;
+        double phase = 0.0;               // Cycles, [0, 1)
+        double increment = 0.0;           // Cycles per sample
+        double incrementStep = 0.0;       // Per sample while gliding
+        int glideSamplesRemaining = 0;
+    };
+
+    void updateGains();
+
+    double m_sampleRate = 44100.0;
+    int m_glideSamples = 1;
+
+    std::array<VoiceState, NumVoices> m_voices;
+    std::array<float, NumVoices> m_gains {};   // Levels after normalisation
+
+    // Scratch, sized in prepare()
+    std::vector<float> m_phaseBuffer;
+
+    static constexpr double c_glideSeconds = 0.05;
+};
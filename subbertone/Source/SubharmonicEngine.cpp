@@ -26,14 +26,13 @@ void SubharmonicEngine::prepare(double newSampleRate, int maxBlockSize)
     // Reset state
     m_currentFrequency = 0.0;
     m_targetFrequency = 0.0;
-    m_lastSetFrequency = 0.0;
     m_envelopeFollower = 0.0;
     m_envelopeTarget = 0.0;
     m_signalPresent = false;
     m_releaseGain = 1.0;
     m_signalOnCounter = 0;
     m_signalOffCounter = 0;
-    m_filterUpdateCounter = 0;
+    m_distortionPathActive = false;
 
     m_signalOnThreshold = static_cast<int>(m_sampleRate * 0.0013);
     m_signalOffThreshold = static_cast<int>(m_sampleRate * 0.5);
@@ -43,82 +42,75 @@ void SubharmonicEngine::prepare(double newSampleRate, int maxBlockSize)
 
     m_sineBuffer.resize(normalSize);
     m_cleanSineBuffer.resize(normalSize);
+    m_subVoiceBuffer.resize(normalSize);
     m_harmonicResidualBuffer.resize(normalSize);
+    m_driveBuffer.resize(normalSize);
+    m_cleanReferenceBuffer.resize(normalSize);
 
     // Clear buffers
     std::fill(m_sineBuffer.begin(), m_sineBuffer.end(), 0.0f);
     std::fill(m_cleanSineBuffer.begin(), m_cleanSineBuffer.end(), 0.0f);
+    std::fill(m_subVoiceBuffer.begin(), m_subVoiceBuffer.end(), 0.0f);
     std::fill(m_harmonicResidualBuffer.begin(), m_harmonicResidualBuffer.end(), 0.0f);
 
     // Prepare filters and oscillator
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = m_sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(maxBlockSize);
-    spec.numChannels = 1;
-
-    // Initialize the band-limited sine oscillator with 512-point wavetable
-    m_sineOscillator.prepare(spec);
-    // Use a larger wavetable for better quality at low frequencies
-    m_sineOscillator.initialise([](float x) { return std::sin(x); }, 2048);
-    m_sineOscillator.setFrequency(100.0f); // Start with a default frequency to avoid startup artifacts
-
-    // Tone filter
-    m_toneFilter.prepare(spec);
-    m_toneFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    m_toneFilter.reset();
+    // Sub voices, generated a block at a time
+    m_oscillatorBank.prepare(m_sampleRate, maxBlockSize);
+    setSubVoices(m_subVoices);
 
-    // Post-drive lowpass
-    m_postDriveLowpassFilter.prepare(spec);
-    m_postDriveLowpassFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    m_postDriveLowpassFilter.reset();
-
-    // High-pass filter for DC blocking
-    m_highpassFilter.prepare(spec);
-    m_highpassFilter.setType(juce::dsp::StateVariableTPTFilterType::highpass);
-    m_highpassFilter.setCutoffFrequency(20.0f);
-    m_highpassFilter.reset();
-
-    // Post-subtraction filter to smooth harmonic extraction artifacts
-    m_postSubtractionFilter.prepare(spec);
-    m_postSubtractionFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    m_postSubtractionFilter.setCutoffFrequency(4000.0f);  // Gentle roll-off
-    m_postSubtractionFilter.reset();
-
-    // Low frequency smoothing filter - helps with sub-100Hz oscillation
-    m_lowFreqSmoothingFilter.prepare(spec);
-    m_lowFreqSmoothingFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    m_lowFreqSmoothingFilter.setCutoffFrequency(200.0f);  // Smooth low frequencies
-    m_lowFreqSmoothingFilter.reset();
-
-    // Anti-aliasing filters - prepare at native rate
-    const float cutoffFreq = static_cast<float>(spec.sampleRate * 0.45);
-
-    const juce::dsp::IIR::Coefficients<float>::Ptr coeffs1 = juce::dsp::IIR::Coefficients<float>::makeLowPass(spec.sampleRate, cutoffFreq, 0.3f);
-    const juce::dsp::IIR::Coefficients<float>::Ptr coeffs2 = juce::dsp::IIR::Coefficients<float>::makeLowPass(spec.sampleRate, cutoffFreq, 0.3f);
-
-    m_antiAliasingFilter1.prepare(spec);
-    m_antiAliasingFilter1.coefficients = coeffs1;
-    m_antiAliasingFilter1.reset();
-
-    m_antiAliasingFilter2.prepare(spec);
-    m_antiAliasingFilter2.coefficients = coeffs2;
-    m_antiAliasingFilter2.reset();
+    // Octave divider, band limited to the top of the detection range until a pitch estimate steers it
+    m_octaveDivider.prepare(m_sampleRate, c_minSignalFrequency, c_maxSignalFrequency);
+    m_dividerBandLimit = c_dividerDefaultBandLimitHz;
+    m_octaveDivider.setBandLimit(m_dividerBandLimit);
+
+    // Clean path: 20Hz DC blocker, then the tone lowpass
+    m_dcBlockingFilter.setStage(0, BiquadCoefficients::makeHighPass(m_sampleRate, 20.0, 0.7));
+    m_dcBlockingFilter.reset();
+
+    m_toneFilter.prepare(m_sampleRate);
+    m_toneFilter.setCutoffFrequency(m_toneSmoothed.getCurrentValue());
+
+    // Drive, and the delay that keeps the clean sine in line with it
+    m_distortion.prepare(m_sampleRate, maxBlockSize);
+    m_cleanReferenceDelay.setSize(1, maxBlockSize + c_maxDistortionLatency);
+    m_cleanReferencePosition = 0;
 
     // Pre-distortion filter
-    const juce::dsp::IIR::Coefficients<float>::Ptr preDistCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowPass(spec.sampleRate, 2000.0f, 0.7f);
-    m_preDistortionFilter.prepare(spec);
-    m_preDistortionFilter.coefficients = preDistCoeffs;
+    m_preDistortionFilter.setStage(0, BiquadCoefficients::makeLowPass(m_sampleRate, 2000.0, 0.7));
     m_preDistortionFilter.reset();
 
-    // DC blocking filter - 20Hz high-pass
-    const juce::dsp::IIR::Coefficients<float>::Ptr dcBlockCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(spec.sampleRate, 20.0f, 0.7f);
-    m_dcBlockingFilter.prepare(spec);
-    m_dcBlockingFilter.coefficients = dcBlockCoeffs;
-    m_dcBlockingFilter.reset();
+    // Post-drive lowpass
+    m_postDriveLowpassFilter.prepare(m_sampleRate);
+    m_postDriveLowpassFilter.setCutoffFrequency(m_postDriveLowpassSmoothed.getCurrentValue());
+
+    // Anti-aliasing filters - light filtering at native rate
+    const double antiAliasingCutoff = m_sampleRate * 0.45;
+    m_antiAliasingFilters.setStage(0, BiquadCoefficients::makeLowPass(m_sampleRate, antiAliasingCutoff, 0.3));
+    m_antiAliasingFilters.setStage(1, BiquadCoefficients::makeLowPass(m_sampleRate, antiAliasingCutoff, 0.3));
+    m_antiAliasingFilters.reset();
+
+    // Harmonic residual: 20Hz highpass for DC, then a gentle 4kHz roll-off to smooth
+    // extraction artifacts (Butterworth, as the state variable filters these replace)
+    m_residualFilters.setStage(0, BiquadCoefficients::makeHighPass(m_sampleRate, 20.0, juce::MathConstants<double>::sqrt2 * 0.5));
+    m_residualFilters.setStage(1, BiquadCoefficients::makeLowPass(m_sampleRate, 4000.0, juce::MathConstants<double>::sqrt2 * 0.5));
+    m_residualFilters.reset();
 
     m_isPrepared = true;  // Mark as prepared after all setup is complete
 }
 
+void SubharmonicEngine::setSubVoices(SubVoices voices)
+{
+    m_subVoices = voices;
+
+    const bool twoOctaves = voices == SubVoices::OctaveAndTwoOctaves || voices == SubVoices::All;
+    const bool fifth = voices == SubVoices::OctaveAndFifth || voices == SubVoices::All;
+
+    // The octave leads; the others sit under it
+    m_oscillatorBank.setVoiceLevel(SubOscillatorBank::OctaveDown, 1.0f);
+    m_oscillatorBank.setVoiceLevel(SubOscillatorBank::TwoOctavesDown, twoOctaves ? c_twoOctavesLevel : 0.0f);
+    m_oscillatorBank.setVoiceLevel(SubOscillatorBank::FifthDown, fifth ? c_fifthLevel : 0.0f);
+}
+
 void SubharmonicEngine::calculateEnvelopeCoefficients()
 {
     // Convert time constants to filter coefficients
@@ -174,7 +166,8 @@ void SubharmonicEngine::process(float* outputBuffer,
                                 int distortionType,
                                 float toneFreq,
                                 float postDriveLowpass,
-                                bool inputActive)
+                                bool inputActive,
+                                const float* input)
 {
     // Validate parameters and check if engine is prepared
     if (!outputBuffer || numSamples <= 0 || numSamples > c_maxBlockSizeSamples || !m_isPrepared)
@@ -207,6 +200,33 @@ void SubharmonicEngine::process(float* outputBuffer,
 
     std::fill(m_harmonicResidualBuffer.begin(), m_harmonicResidualBuffer.begin() + requiredSize, 0.0f);
 
+    // Octave divider: the sub comes straight from the input, sample by sample. The pitch
+    // estimate only keeps harmonics out of the divider's detector, and the divider's own
+    // lock stands in for it below, so gating and the tone clamp follow without lag.
+    const bool useDivider = m_trackingMode == TrackingMode::OctaveDivider && input != nullptr;
+
+    if (useDivider)
+    {
+        if (fundamental > c_minSignalFrequency && fundamental < c_maxSignalFrequency)
+        {
+            const float bandLimit = fundamental * c_dividerBandLimitRatio;
+
+            if (std::abs(bandLimit - m_dividerBandLimit) > m_dividerBandLimit * 0.05f)
+            {
+                m_dividerBandLimit = bandLimit;
+                m_octaveDivider.setBandLimit(m_dividerBandLimit);
+            }
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+            m_subVoiceBuffer[static_cast<size_t>(i)] = m_octaveDivider.processSample(input[i]);
+
+        fundamental = m_octaveDivider.getInputFrequency();
+
+        if (fundamental > m_fundamentalLimit)
+            fundamental = 0.0f;
+    }
+
     // Signal detection with hysteresis
     const bool currentSignalDetected = inputActive && fundamental > c_minSignalFrequency && fundamental < c_maxSignalFrequency;
 
@@ -282,15 +302,8 @@ void SubharmonicEngine::process(float* outputBuffer,
             m_currentFrequency = m_currentFrequency * adaptiveSmoothingCoeff + m_targetFrequency * (1.0 - adaptiveSmoothingCoeff);
         }
 
-        // Only update oscillator frequency if it has changed significantly
-        // For low frequencies, be even more conservative to maintain phase
-        const double frequencyTolerance = (m_currentFrequency < 100.0) ? 0.5 : 0.1;
-
-        if (std::abs(m_currentFrequency - m_lastSetFrequency) > frequencyTolerance)
-        {
-            m_sineOscillator.setFrequency(static_cast<float>(m_currentFrequency));
-            m_lastSetFrequency = m_currentFrequency;
-        }
+        // The bank glides to it sample by sample, so it can be retargeted every block
+        m_oscillatorBank.setFundamental(m_currentFrequency * 2.0);
     }
     // Keep the oscillator running and fade with envelope when no signal is present.
 
@@ -305,150 +318,130 @@ void SubharmonicEngine::process(float* outputBuffer,
     {
         m_currentFrequency = 0.0;
         m_targetFrequency = 0.0;
-        m_lastSetFrequency = 0.0;
-        m_sineOscillator.reset();
+        m_oscillatorBank.reset();
     }
 
-    // Generate sine wave with consistent envelope for this block
-    for (int i = 0; i < numSamples; ++i)
-    {
-        // Always generate sine wave to maintain phase continuity
-        float filtered = 0.0f;
+    // Sub voices for the whole block (the divider already filled them)
+    if (!useDivider && m_currentFrequency > c_minSignalFrequency)
+        m_oscillatorBank.process(m_subVoiceBuffer.data(), numSamples);
 
-        if (m_currentFrequency > c_minSignalFrequency)  // Only if we have a valid frequency
-        {
-            // Generate band-limited sine wave using JUCE's oscillator
-            // The oscillator expects a zero input for pure sine generation
-            float sineSample = m_sineOscillator.processSample(0.0f);
+    // Clean path: scaled sub -> DC blocker -> tone lowpass. With no valid frequency the
+    // filters are fed silence and ring out.
+    float* const cleanSine = m_cleanSineBuffer.data();
 
-            // Ensure the sine wave is properly scaled with more headroom
-            sineSample *= c_sineHeadroom; // More headroom to prevent clipping
+    if (m_currentFrequency > c_minSignalFrequency)
+        juce::FloatVectorOperations::multiply(cleanSine, m_subVoiceBuffer.data(), c_sineHeadroom, numSamples);
+    else
+        juce::FloatVectorOperations::clear(cleanSine, numSamples);
 
-            // Apply DC blocker first to prevent any DC offset issues
-            const float dcCorrected = m_dcBlockingFilter.processSample(sineSample);
+    m_dcBlockingFilter.process(cleanSine, numSamples);
 
-            // Apply tone filter after DC blocking
-            if ((m_filterUpdateCounter++ % c_filterUpdateInterval) == 0)
-                m_toneFilter.setCutoffFrequency(m_toneSmoothed.getNextValue());
+    // The tone cutoff steps once per sub-block and the filter interpolates between steps
+    for (int start = 0; start < numSamples; start += c_filterUpdateInterval)
+    {
+        const int subBlockSize = std::min(c_filterUpdateInterval, numSamples - start);
+        m_toneFilter.process(cleanSine + start, subBlockSize, m_toneSmoothed.skip(subBlockSize));
+    }
 
-            const float toneFiltered = m_toneFilter.processSample(0, dcCorrected);
+    // Skip the whole distortion path while the drive is off and staying off. Its filters
+    // restart from silence when it comes back, which is where feeding them zeros left them.
+    const bool distortionActive = m_distortionSmoothed.getCurrentValue() > c_distortionBypassThreshold
+                                  || m_distortionSmoothed.getTargetValue() > c_distortionBypassThreshold;
 
-            // THIS WAS PRODUCING A DISCONTINUITY IN THE SIGNAL WHEN DOING BIG JUMPS IN PITCH
-            // For low frequencies, apply additional smoothing last
-            //filtered = (m_currentFrequency < c_lowFreqSmoothingHz) ? m_lowFreqSmoothingFilter.processSample(0, toneFiltered) : toneFiltered;
-            filtered = toneFiltered;
-        }
-        else
+    if (!distortionActive)
+    {
+        if (m_distortionPathActive)
         {
-            // No valid frequency - output silence and keep filters in sync
-            filtered = m_toneFilter.processSample(0, 0.0f);
+            m_preDistortionFilter.reset();
+            m_distortion.reset();
+            m_cleanReferenceDelay.clear();
+            m_postDriveLowpassFilter.reset();
+            m_antiAliasingFilters.reset();
+            m_residualFilters.reset();
+            m_distortionPathActive = false;
         }
 
-        // Store clean sine AFTER tone filter for better phase alignment
-        m_cleanSineBuffer[static_cast<size_t>(i)] = filtered;
+        m_distortionSmoothed.skip(numSamples);
+        m_postDriveLowpassFilter.setCutoffFrequency(m_postDriveLowpassSmoothed.skip(numSamples));
 
-        // Only copy to m_sineBuffer if we're actually going to distort
-        // This prevents any artifacts when distortion is disabled
-        m_sineBuffer[static_cast<size_t>(i)] = (m_distortionSmoothed.getCurrentValue() > 0.01f) ? filtered : 0.0f;
+        // Clean subharmonic sine with the consistent block envelope
+        for (int i = 0; i < numSamples; ++i)
+            outputBuffer[i] = std::clamp(std::clamp(cleanSine[i], -1.0f, 1.0f) * blockEnvelope, -1.0f, 1.0f);
     }
-
-    // If there's no signal present, let the envelope fade out smoothly.
-
-    // Process without oversampling
-
-    for (int i = 0; i < numSamples; ++i)
+    else
     {
-        float sample = m_sineBuffer[static_cast<size_t>(i)];
+        m_distortionPathActive = true;
 
-        // Pre-distortion filtering
-        sample = m_preDistortionFilter.processSample(sample);
+        // Data flow: clean sine -> pre-distortion lowpass -> drive (oversampled or not)
+        // -> post-drive lowpass -> anti-aliasing (light filtering at native rate)
+        float* const distorted = m_sineBuffer.data();
+        std::copy_n(cleanSine, numSamples, distorted);
 
-        // Apply distortion
-        sample = applyDistortion(sample, m_distortionSmoothed.getNextValue(), distortionType);
+        m_preDistortionFilter.process(distorted, numSamples);
 
-        // Post-drive lowpass
-        if ((m_filterUpdateCounter++ % c_filterUpdateInterval) == 0)
-            m_postDriveLowpassFilter.setCutoffFrequency(m_postDriveLowpassSmoothed.getNextValue());
-
-        sample = m_postDriveLowpassFilter.processSample(0, sample);
-
-        // Anti-aliasing filters (light filtering at native rate)
-        sample = m_antiAliasingFilter1.processSample(sample);
-        sample = m_antiAliasingFilter2.processSample(sample);
-
-        m_sineBuffer[static_cast<size_t>(i)] = sample;
-    }
-
-    // Data flow: clean sine -> optional distortion -> harmonic extraction -> mix -> output.
-    // Mix original sine and distorted signals with bounds checking
-    for (int i = 0; i < numSamples; ++i)
-    {
-        const size_t idx = static_cast<size_t>(i);
+        float* const driveAmounts = m_driveBuffer.data();
 
-        // Bounds check
-        if (idx >= m_cleanSineBuffer.size() || idx >= m_sineBuffer.size())
+        if (m_distortionSmoothed.isSmoothing())
         {
-            outputBuffer[i] = 0.0f;
-            continue;
+            for (int i = 0; i < numSamples; ++i)
+                driveAmounts[i] = m_distortionSmoothed.getNextValue();
+        }
+        else
+        {
+            juce::FloatVectorOperations::fill(driveAmounts, m_distortionSmoothed.getTargetValue(), numSamples);
         }
 
-        // Get the original clean sine wave
-        float sine = m_cleanSineBuffer[idx];
+        m_distortion.process(distorted, driveAmounts, numSamples, distortionType);
 
-        // Get the distorted signal
-        float distorted = m_sineBuffer[idx]; // Now contains the processed signal
+        for (int start = 0; start < numSamples; start += c_filterUpdateInterval)
+        {
+            const int subBlockSize = std::min(c_filterUpdateInterval, numSamples - start);
+            m_postDriveLowpassFilter.process(distorted + start, subBlockSize, m_postDriveLowpassSmoothed.skip(subBlockSize));
+        }
 
-        // Clamp values to prevent extreme outputs
-        sine = std::max(-1.0f, std::min(1.0f, sine));
-        distorted = std::max(-1.0f, std::min(1.0f, distorted));
+        // Oversampling has already band limited the drive
+        const int distortionLatency = m_distortion.getLatencyInSamples();
 
-        // Apply the consistent block envelope
-        float envelopedSine = sine * blockEnvelope;
-        float envelopedDistorted = distorted * blockEnvelope;
+        if (distortionLatency == 0)
+            m_antiAliasingFilters.process(distorted, numSamples);
 
-        // When distortion is minimal, output the clean sine wave
-        // When distortion is high, extract the harmonic content
-        float output;
+        // The clean sine to subtract, delayed to line up with the drive's output
+        const float* cleanReference = cleanSine;
 
-        if (m_distortionSmoothed.getCurrentValue() < 0.01f)
+        if (distortionLatency > 0)
         {
-            // No distortion - output clean subharmonic sine wave
-            output = envelopedSine;
+            m_cleanReferenceDelay.write(0, m_cleanReferencePosition, cleanSine, numSamples);
+            m_cleanReferenceDelay.read(0, m_cleanReferencePosition - distortionLatency, m_cleanReferenceBuffer.data(), numSamples);
+            m_cleanReferencePosition = m_cleanReferenceDelay.wrap(m_cleanReferencePosition + numSamples);
+            cleanReference = m_cleanReferenceBuffer.data();
+        }
 
-            // Keep filters in sync
-            m_highpassFilter.processSample(0, 0.0f);
-            m_postSubtractionFilter.processSample(0, 0.0f);
+        // Harmonic extraction: subtract clean from distorted to isolate the harmonics,
+        // then highpass away DC and smooth harsh artifacts
+        float* const residual = m_harmonicResidualBuffer.data();
 
-            if (idx < m_harmonicResidualBuffer.size())
-            {
-                m_harmonicResidualBuffer[idx] = 0.0f;
-            }
-        }
-        else
-        {
-            // Harmonic extraction for distorted signals
-            // Subtract clean from distorted to isolate harmonics
-            const float harmonics = envelopedDistorted - envelopedSine;
+        for (int i = 0; i < numSamples; ++i)
+            residual[i] = (std::clamp(distorted[i], -1.0f, 1.0f) - std::clamp(cleanReference[i], -1.0f, 1.0f)) * blockEnvelope;
 
-            // Apply high-pass filter to remove DC
-            const float highPassed = m_highpassFilter.processSample(0, harmonics);
+        m_residualFilters.process(residual, numSamples);
 
-            // Apply post-subtraction lowpass to smooth any harsh artifacts
-            const float smoothedHarmonics = m_postSubtractionFilter.processSample(0, highPassed);
+        // Mix between clean sine and extracted harmonics based on distortion amount
+        const float distortionAmount = m_distortionSmoothed.getCurrentValue();
+        const float harmonicMix = distortionAmount < c_distortionBypassThreshold ? 0.0f
+                                                                                 : std::min(1.0f, distortionAmount * 2.0f); // Scale up for more audible effect
 
-            // Store harmonic residual for visualization
-            if (idx < m_harmonicResidualBuffer.size())
-            {
-                m_harmonicResidualBuffer[idx] = smoothedHarmonics;
-            }
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float envelopedSine = std::clamp(cleanSine[i], -1.0f, 1.0f) * blockEnvelope;
+            const float output = envelopedSine * (1.0f - harmonicMix) + residual[i] * harmonicMix;
 
-            // Mix between clean sine and extracted harmonics based on distortion amount
-            const float harmonicMix = std::min(1.0f, m_distortionSmoothed.getCurrentValue() * 2.0f); // Scale up for more audible effect
-            output = (envelopedSine * (1.0f - harmonicMix) + smoothedHarmonics * harmonicMix);
+            // Final output clamping
+            outputBuffer[i] = std::clamp(output, -1.0f, 1.0f);
         }
 
-        // Final output clamping
-        outputBuffer[i] = std::max(-1.0f, std::min(1.0f, output));
+        // The residual only shows once the harmonics are mixed in
+        if (harmonicMix == 0.0f)
+            juce::FloatVectorOperations::clear(residual, numSamples);
     }
 
     // Apply release gain when signal is lost to fade to silence smoothly.
@@ -473,83 +466,8 @@ void SubharmonicEngine::process(float* outputBuffer,
             m_envelopeTarget = 0.0;
             m_currentFrequency = 0.0;
             m_targetFrequency = 0.0;
-            m_lastSetFrequency = 0.0;
 
-            m_sineOscillator.reset();
+            m_oscillatorBank.reset();
         }
     }
 }
-
-float SubharmonicEngine::applyDistortion(float sample, float amount, int type)
-{
-    if (amount < 0.001f)
-        return sample;
-
-    // More gentle pre-gain for analogue-style saturation
-    const float drive = 1.0f + amount * 1.5f;  // Less aggressive drive
-
-    switch (type)
-    {
-        case SoftClip:  // Renamed to "Tape Saturation" in UI
-        {
-            // Smooth tanh saturation - classic analogue tape emulation
-            const float x = sample * drive;
-            return std::tanh(x);  // Direct tanh without normalization
-        }
-
-        case HardClip:  // Renamed to "Valve Warmth" in UI
-        {
-            // Valve/tube-style saturation with 2nd and 3rd harmonics
-            const float x = sample * drive;
-
-            // Asymmetric tube curve for even harmonics
-            if (x > 0)
-            {
-                const float out = 1.5f * x - 0.5f * x * x * x;
-                return std::clamp(out, -1.0f, 1.0f);  // Clamp instead of normalize
-            }
-            else
-            {
-                // Slightly different curve for negative side (tube asymmetry)
-                const float out = 1.4f * x - 0.6f * x * x * x;
-                return std::clamp(out, -1.0f, 1.0f);
-            }
-        }
-
-        case Tube:  // Renamed to "Console Drive" in UI
-        {
-            // Console preamp-style saturation
-            const float x = sample * drive;
-
-            // Soft knee compression curve
-            const float threshold = 0.7f;
-
-            if (std::abs(x) <= threshold)
-            {
-                return x;
-            }
-            else
-            {
-                const float sign = x > 0 ? 1.0f : -1.0f;
-                const float excess = std::abs(x) - threshold;
-
-                // Smooth logarithmic curve above threshold
-                return sign * (threshold + std::log1p(excess) * 0.5f);
-            }
-        }
-
-        case Foldback:  // Renamed to "Transformer" in UI
-        {
-            // Transformer-style saturation with gentle S-curve
-            const float x = sample * drive * 0.7f;  // Reduced gain for gentler effect
-
-            // Classic S-curve using arctangent
-            return (2.0f / juce::MathConstants<float>::pi) * std::atan(x * juce::MathConstants<float>::pi / 2.0f);
-        }
-
-        default:
-            break;
-    }
-
-    return sample;
-}
@@ -1,6 +1,11 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "FilterCascade.h"
+#include "OctaveDivider.h"
+#include "RingBuffer.h"
+#include "SubDistortion.h"
+#include "SubOscillatorBank.h"
 #include <atomic>
 
 class SubharmonicEngine
@@ -9,16 +14,40 @@ public:
     SubharmonicEngine()  = default;
     ~SubharmonicEngine() = default;
     
+    // How the sub follows the input
+    enum class TrackingMode
+    {
+        Pitch = 0,      // Sine oscillator retuned from the pitch detector, smoothed per block
+        OctaveDivider   // Per sample divider locked to the input, the pitch estimate only steers its band limit
+    };
+
     void prepare(double sampleRate, int maxBlockSize);
-    void process(float* outputBuffer, int numSamples, float fundamental, float distortionAmount, int distortionType, float toneFreq, float postDriveLowpass, bool inputActive);
+    // Which sub voices sound; the octave divider only ever produces the octave
+    enum class SubVoices
+    {
+        Octave = 0,
+        OctaveAndTwoOctaves,
+        OctaveAndFifth,
+        All
+    };
+
+    void setTrackingMode(TrackingMode mode) { m_trackingMode = mode; }
+    void setSubVoices(SubVoices voices);
+    void setDistortionOversampling(SubDistortion::Oversampling oversampling) { m_distortion.setOversampling(oversampling); }
+    void setFundamentalLimit(float limitHz) { m_fundamentalLimit = limitHz; }
+
+    // input is the mono signal the divider follows; only read in OctaveDivider mode
+    void process(float* outputBuffer, int numSamples, float fundamental, float distortionAmount, int distortionType, float toneFreq, float postDriveLowpass, bool inputActive, const float* input = nullptr);
     
     // Get harmonic residual buffer for visualization
     const std::vector<float>& getHarmonicResidualBuffer() const { return m_harmonicResidualBuffer; }
+
+    // True once the sub has fully released and the oscillators have stopped
+    bool hasReleased() const { return !m_signalPresent && m_currentFrequency == 0.0; }
     
 private:
     void updateEnvelope(bool signalDetected);
     void calculateEnvelopeCoefficients();
-    float applyDistortion(float sample, float amount, int type);
 
     static constexpr int c_maxBlockSizeSamples = 8192;
     static constexpr float c_minSignalFrequency = 20.0f;
@@ -27,17 +56,27 @@ private:
     static constexpr float c_maxToneHz = 20000.0f;
     static constexpr float c_envelopeSilenceThreshold = 0.0001f;
     static constexpr float c_sineHeadroom = 0.7f;
-    static constexpr float c_lowFreqSmoothingHz = 100.0f;
+    static constexpr float c_distortionBypassThreshold = 0.01f;   // Below this the distortion path is skipped
+    static constexpr int c_maxDistortionLatency = 16;
     static constexpr double c_parameterSmoothingSeconds = 0.02;
+    static constexpr float c_twoOctavesLevel = 0.7f;              // Relative to the octave voice
+    static constexpr float c_fifthLevel = 0.5f;
+    static constexpr float c_dividerBandLimitRatio = 1.5f;         // Divider lowpass relative to the pitch estimate
+    static constexpr float c_dividerDefaultBandLimitHz = 400.0f;   // Until there is one
 
     // Core parameters
     double m_sampleRate = 0.0;
-    juce::dsp::Oscillator<float> m_sineOscillator { [](float x) { return std::sin(x); } };
+    SubOscillatorBank m_oscillatorBank;
+    SubVoices m_subVoices = SubVoices::Octave;
+
+    TrackingMode m_trackingMode = TrackingMode::Pitch;
+    OctaveDivider m_octaveDivider;
+    float m_dividerBandLimit = 0.0f;
+    float m_fundamentalLimit = c_maxSignalFrequency;
     
     // Frequency management
     double m_currentFrequency = 0.0;
     double m_targetFrequency = 0.0;
-    double m_lastSetFrequency = 0.0;
     static constexpr double c_frequencySmoothingCoeff = 0.99;
     
     // Envelope parameters
@@ -57,39 +96,38 @@ private:
     int m_signalOnThreshold = 64;     // Computed in prepare()
     int m_signalOffThreshold = 24000; // Computed in prepare()
     
-    // Filters
-    juce::dsp::IIR::Filter<float> m_dcBlockingFilter;
-    juce::dsp::StateVariableTPTFilter<float> m_toneFilter;
-    juce::dsp::StateVariableTPTFilter<float> m_postDriveLowpassFilter;
-    juce::dsp::StateVariableTPTFilter<float> m_highpassFilter;
-    juce::dsp::StateVariableTPTFilter<float> m_postSubtractionFilter;
-    juce::dsp::StateVariableTPTFilter<float> m_lowFreqSmoothingFilter;
-    juce::dsp::IIR::Filter<float> m_preDistortionFilter;
-    juce::dsp::IIR::Filter<float> m_antiAliasingFilter1;
-    juce::dsp::IIR::Filter<float> m_antiAliasingFilter2;
+    // Filters, each run over the whole block. Clean path: DC blocker then tone.
+    BiquadCascade<1> m_dcBlockingFilter;
+    ModulatedLowpass m_toneFilter;
+
+    // Distortion path: pre-distortion lowpass, drive, post-drive lowpass, anti-aliasing
+    // pair (only without oversampling), then the residual's highpass and post-subtraction lowpass
+    BiquadCascade<1> m_preDistortionFilter;
+    SubDistortion m_distortion;
+    ModulatedLowpass m_postDriveLowpassFilter;
+    BiquadCascade<2> m_antiAliasingFilters;
+    BiquadCascade<2> m_residualFilters;
+    bool m_distortionPathActive = false;
     int m_currentMaxBlockSize = 0;
     
-    // Distortion types
-    enum DistortionType
-    {
-        SoftClip = 0,
-        HardClip,
-        Tube,
-        Foldback
-    };
-    
     // Processing buffers
     std::vector<float> m_sineBuffer;
     std::vector<float> m_cleanSineBuffer;
+    std::vector<float> m_subVoiceBuffer;
     std::vector<float> m_harmonicResidualBuffer;
+    std::vector<float> m_driveBuffer;
+
+    // Clean sine delayed to line up with the oversampled drive for harmonic extraction
+    RingBuffer<float> m_cleanReferenceDelay;
+    std::vector<float> m_cleanReferenceBuffer;
+    int m_cleanReferencePosition = 0;
 
     // Smoothed parameters (sample-accurate control)
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> m_distortionSmoothed;
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> m_toneSmoothed;
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> m_postDriveLowpassSmoothed;
 
-    static constexpr int c_filterUpdateInterval = 16;
-    int m_filterUpdateCounter = 0;
+    static constexpr int c_filterUpdateInterval = 16;   // Samples per cutoff step of the modulated filters
     
     // Thread safety
     std::atomic<bool> m_isPrepared{false};
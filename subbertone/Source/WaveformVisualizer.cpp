@@ -11,24 +11,13 @@ WaveformVisualizer::WaveformVisualizer(SubbertoneAudioProcessor& audioProcessor)
     setInterceptsMouseClicks(true, false);
     
     // Initialize history buffers
-    m_inputHistory.resize(c_historySize);
-    m_outputHistory.resize(c_historySize);
-    m_harmonicResidualHistory.resize(c_historySize);
-    
-    for (int i = 0; i < c_historySize; ++i)
-    {
-        m_inputHistory[i].resize(512, 0.0f);
-        m_outputHistory[i].resize(512, 0.0f);
-        m_harmonicResidualHistory[i].resize(512, 0.0f);
-    }
+    m_inputHistory.assign(c_historySize * c_historyPoints, 0.0f);
+    m_outputHistory.assign(c_historySize * c_historyPoints, 0.0f);
+    m_harmonicResidualHistory.assign(c_historySize * c_historyPoints, 0.0f);
 
-    m_inputBuffer.resize(2048, 0.0f);
-    m_outputBuffer.resize(2048, 0.0f);
-    m_harmonicResidualBuffer.resize(2048, 0.0f);
-    
     m_openGLContext.setRenderer(this);
     m_openGLContext.attachTo(*this);
-    m_openGLContext.setContinuousRepainting(true);
+    m_openGLContext.setContinuousRepainting(false); // The timer triggers each frame
     
     startTimerHz(60); // 60 FPS update
 }
@@ -51,25 +40,13 @@ void WaveformVisualizer::paint(juce::Graphics& g)
         return;
     }
     
-    // Draw text overlay on top of OpenGL
-    g.setFont(juce::Font(juce::FontOptions("Courier New", 18.0f, juce::Font::bold)));
-    
-    // Draw INPUT with toggle state
-    g.setColour(m_showInput ? m_inputColor : m_inputColor.withAlpha(0.3f));
-    g.drawText("INPUT" + juce::String(m_showInput ? "" : " (OFF)"), 10, 10, 150, 25, juce::Justification::left);
-    
-    // Draw HARMONIC RESIDUAL with toggle state in the middle
-    g.setColour(m_showHarmonicResidual ? m_harmonicResidualColor : m_harmonicResidualColor.withAlpha(0.3f));
-    g.drawText("HARMONICS" + juce::String(m_showHarmonicResidual ? "" : " (OFF)"), 10, getHeight() / 2 - 12, 150, 25, juce::Justification::left);
-    
-    // Draw OUTPUT with toggle state
-    g.setColour(m_showOutput ? m_outputColor : m_outputColor.withAlpha(0.3f));
-    g.drawText("OUTPUT" + juce::String(m_showOutput ? "" : " (OFF)"), 10, getHeight() - 35, 150, 25, juce::Justification::left);
-    
-    // Add click instruction
-    g.setColour(m_textColor.withAlpha(0.6f));
-    g.setFont(juce::Font(juce::FontOptions("Courier New", 12.0f, juce::Font::plain)));
-    g.drawText("Click top/middle/bottom to toggle waveforms", getWidth() - 280, 10, 275, 20, juce::Justification::right);
+    // Draw text overlay on top of OpenGL, labels from the cache
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (m_labelsImageDirty || m_labelsImage.getWidth() != juce::roundToInt(getWidth() * scale))
+        renderLabelsImage(scale);
+
+    g.drawImage(m_labelsImage, getLocalBounds().toFloat());
     
     // Draw fundamental frequency
     const float fundamental = m_audioProcessor.getCurrentFundamental();
@@ -102,73 +79,66 @@ void WaveformVisualizer::paint(juce::Graphics& g)
     }
 }
 
-void WaveformVisualizer::timerCallback()
+void WaveformVisualizer::resized()
 {
-    // Update waveform history
-    m_audioProcessor.getInputWaveform(m_inputBuffer);
-    m_audioProcessor.getOutputWaveform(m_outputBuffer);
-    m_audioProcessor.getHarmonicResidualWaveform(m_harmonicResidualBuffer);
-    
-    // Downsample to 512 points for performance
-    const int targetSize = 512;
-    m_inputHistory[m_historyWritePos].resize(targetSize);
-    m_outputHistory[m_historyWritePos].resize(targetSize);
-    m_harmonicResidualHistory[m_historyWritePos].resize(targetSize);
-    
-    if (!m_inputBuffer.empty())
-    {
-        const float ratio = m_inputBuffer.size() / float(targetSize);
-        for (int i = 0; i < targetSize; ++i)
-        {
-            const int idx = static_cast<int>(i * ratio);
-            m_inputHistory[m_historyWritePos][i] = m_inputBuffer[idx] * 2.0f; // Scale up for visibility
-        }
-    }
+    m_labelsImageDirty = true;
+}
+
+void WaveformVisualizer::renderLabelsImage(float scale)
+{
+    m_labelsImageDirty = false;
+
+    const int width = juce::jmax(1, juce::roundToInt(getWidth() * scale));
+    const int height = juce::jmax(1, juce::roundToInt(getHeight() * scale));
+
+    if (m_labelsImage.getWidth() != width || m_labelsImage.getHeight() != height)
+        m_labelsImage = juce::Image(juce::Image::ARGB, width, height, true);
     else
-    {
-        // Clear if no input
-        for (int i = 0; i < targetSize; ++i)
-        {
-            m_inputHistory[m_historyWritePos][i] = 0.0f;
-        }
-    }
+        m_labelsImage.clear(m_labelsImage.getBounds());
+
+    juce::Graphics g(m_labelsImage);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
+    g.setFont(juce::Font(juce::FontOptions("Courier New", 18.0f, juce::Font::bold)));
     
-    if (!m_outputBuffer.empty())
-    {
-        const float ratio = m_outputBuffer.size() / float(targetSize);
-        for (int i = 0; i < targetSize; ++i)
-        {
-            const int idx = static_cast<int>(i * ratio);
-            m_outputHistory[m_historyWritePos][i] = m_outputBuffer[idx] * 2.0f; // Scale up for visibility
-        }
-    }
-    else
-    {
-        // Clear if no output
-        for (int i = 0; i < targetSize; ++i)
-        {
-            m_outputHistory[m_historyWritePos][i] = 0.0f;
-        }
-    }
+    // Draw INPUT with toggle state
+    g.setColour(m_showInput ? m_inputColor : m_inputColor.withAlpha(0.3f));
+    g.drawText("INPUT" + juce::String(m_showInput ? "" : " (OFF)"), 10, 10, 150, 25, juce::Justification::left);
+    
+    // Draw HARMONIC RESIDUAL with toggle state in the middle
+    g.setColour(m_showHarmonicResidual ? m_harmonicResidualColor : m_harmonicResidualColor.withAlpha(0.3f));
+    g.drawText("HARMONICS" + juce::String(m_showHarmonicResidual ? "" : " (OFF)"), 10, getHeight() / 2 - 12, 150, 25, juce::Justification::left);
+    
+    // Draw OUTPUT with toggle state
+    g.setColour(m_showOutput ? m_outputColor : m_outputColor.withAlpha(0.3f));
+    g.drawText("OUTPUT" + juce::String(m_showOutput ? "" : " (OFF)"), 10, getHeight() - 35, 150, 25, juce::Justification::left);
     
-    if (!m_harmonicResidualBuffer.empty())
+    // Add click instruction
+    g.setColour(m_textColor.withAlpha(0.6f));
+    g.setFont(juce::Font(juce::FontOptions("Courier New", 12.0f, juce::Font::plain)));
+    g.drawText("Click top/middle/bottom to toggle waveforms", getWidth() - 280, 10, 275, 20, juce::Justification::right);
+}
+
+void WaveformVisualizer::timerCallback()
+{
+    // Update waveform history from the processor's per-pixel peaks
+    const auto& summary = m_audioProcessor.readWaveformSummary();
+
+    const int rowOffset = m_historyWritePos * c_historyPoints;
+
+    const auto copyPeaks = [&summary, rowOffset](std::vector<float>& history, int lane)
     {
-        const float ratio = m_harmonicResidualBuffer.size() / float(targetSize);
+        const auto* buckets = summary.getLane(lane);
+        const int numPoints = juce::jmin(c_historyPoints, summary.numBuckets);
+        float* row = history.data() + rowOffset;
 
-        for (int i = 0; i < targetSize; ++i)
-        {
-            const int idx = static_cast<int>(i * ratio);
-            m_harmonicResidualHistory[m_historyWritePos][i] = m_harmonicResidualBuffer[idx] * 2.0f; // Scale up for visibility
-        }
-    }
-    else
-    {
-        // Clear if no harmonic residual
-        for (int i = 0; i < targetSize; ++i)
-        {
-            m_harmonicResidualHistory[m_historyWritePos][i] = 0.0f;
-        }
-    }
+        for (int i = 0; i < numPoints; ++i)
+            row[i] = buckets[i].getPeak() * 2.0f; // Scale up for visibility
+    };
+
+    copyPeaks(m_inputHistory, SubbertoneAudioProcessor::c_inputLane);
+    copyPeaks(m_outputHistory, SubbertoneAudioProcessor::c_outputLane);
+    copyPeaks(m_harmonicResidualHistory, SubbertoneAudioProcessor::c_harmonicResidualLane);
     
     // Update animation
     m_timeValue += 0.002f; // Slowed down by 10x
@@ -176,14 +146,15 @@ void WaveformVisualizer::timerCallback()
     // Signal-based rotation
     float signalEnergy = 0.0f;
 
-    if (!m_inputHistory.empty() && !m_inputHistory[m_historyWritePos].empty())
     {
         // Calculate RMS energy of current input
-        for (float sample : m_inputHistory[m_historyWritePos])
+        const float* row = m_inputHistory.data() + rowOffset;
+
+        for (int i = 0; i < c_historyPoints; ++i)
         {
-            signalEnergy += sample * sample;
+            signalEnergy += row[i] * row[i];
         }
-        signalEnergy = std::sqrt(signalEnergy / m_inputHistory[m_historyWritePos].size());
+        signalEnergy = std::sqrt(signalEnergy / c_historyPoints);
     }
 
     m_historyWritePos = (m_historyWritePos + 1) % c_historySize;
@@ -214,8 +185,18 @@ void WaveformVisualizer::timerCallback()
     // Trigger OpenGL repaint
     m_openGLContext.triggerRepaint();
     
-    // Also trigger normal repaint for text overlay
-    repaint();
+    // The overlay only needs the F0 readout redrawn, and only when it changes
+    const int fundamentalTenths = juce::jmax(0, juce::roundToInt(m_audioProcessor.getCurrentFundamental() * 10.0f));
+
+    if (fundamentalTenths != m_shownFundamentalTenths)
+    {
+        // Losing or finding the signal also shows or hides the level text
+        if ((fundamentalTenths > 0) != (m_shownFundamentalTenths > 0))
+            repaint(getSignalTextArea());
+
+        m_shownFundamentalTenths = fundamentalTenths;
+        repaint(getReadoutArea());
+    }
 }
 
 void WaveformVisualizer::mouseDown(const juce::MouseEvent& event)
@@ -241,14 +222,18 @@ void WaveformVisualizer::mouseDown(const juce::MouseEvent& event)
         m_showOutput = !m_showOutput;
     }
     
+    m_labelsImageDirty = true;
     repaint();
 }
 
 void WaveformVisualizer::setSignalText(const juce::String& text, bool aboveThreshold)
 {
+    if (text == m_signalText && aboveThreshold == m_signalAboveThreshold)
+        return;
+
     m_signalText = text;
     m_signalAboveThreshold = aboveThreshold;
-    repaint();
+    repaint(getSignalTextArea());
 }
 
 void WaveformVisualizer::newOpenGLContextCreated()
@@ -327,7 +312,7 @@ void WaveformVisualizer::drawPerspectiveGrid()
     glEnd();
 }
 
-void WaveformVisualizer::drawWaveform3D(const std::vector<std::vector<float>>& history, const juce::Colour& color, float yOffset, bool isInput)
+void WaveformVisualizer::drawWaveform3D(const std::vector<float>& history, const juce::Colour& color, float yOffset, bool isInput)
 {
     using namespace juce::gl;
     
@@ -353,10 +338,7 @@ void WaveformVisualizer::drawWaveform3D(const std::vector<std::vector<float>>& h
     {
         const int histIdx = (m_historyWritePos - h - 1 + c_historySize) % c_historySize;
 
-        const std::vector<float>& waveform = history[histIdx];
-        
-        if (waveform.empty() || waveform.size() < 2)
-            continue;
+        const float* waveform = history.data() + histIdx * c_historyPoints;
         
         const float intensity = 1.0f - static_cast<float>(h) / c_historySize;
         const float zPos = -static_cast<float>(h) * 0.3f;
@@ -368,9 +350,9 @@ void WaveformVisualizer::drawWaveform3D(const std::vector<std::vector<float>>& h
         glLineWidth(lineWidth);
         
         glBegin(GL_LINE_STRIP);
-        for (size_t i = 0; i < waveform.size(); ++i)
+        for (int i = 0; i < c_historyPoints; ++i)
         {
-            const float x = (i / float(waveform.size() - 1)) * 16.0f - 8.0f; // Full width
+            const float x = (i / float(c_historyPoints - 1)) * 16.0f - 8.0f; // Full width
             const float y = waveform[i] * 2.0f + yOffset;
             glVertex3f(x, y, zPos);
         }
@@ -13,6 +13,7 @@ public:
     ~WaveformVisualizer() override;
     
     void paint(juce::Graphics&) override;
+    void resized() override;
     void timerCallback() override;
 
     void mouseDown(const juce::MouseEvent& event) override;
@@ -30,24 +31,31 @@ public:
     bool m_showHarmonicResidual = true;
     
 private:
-    void drawWaveform3D(const std::vector<std::vector<float>>& history, const juce::Colour& color, float yOffset, bool isInput);
+    void drawWaveform3D(const std::vector<float>& history, const juce::Colour& color, float yOffset, bool isInput);
     void drawPerspectiveGrid();
 
+    // Overlay: lane labels are cached in an image, readouts repaint only their own area
+    void renderLabelsImage(float scale);
+    juce::Rectangle<int> getReadoutArea() const { return { getWidth() - 180, getHeight() - 60, 170, 50 }; }
+    juce::Rectangle<int> getSignalTextArea() const { return { getWidth() / 2 - 85, getHeight() - 35, 170, 25 }; }
+
     SubbertoneAudioProcessor& m_audioProcessor;
     juce::OpenGLContext m_openGLContext;
     
-    // Waveform data with history for trails
+    // Waveform data with history for trails: c_historySize rows of c_historyPoints,
+    // allocated once and overwritten a row at a time
     static constexpr int c_historySize = 32;
+    static constexpr int c_historyPoints = 512;
 
     int m_historyWritePos = 0;
 
-    std::vector<std::vector<float>> m_inputHistory;
-    std::vector<std::vector<float>> m_outputHistory;
-    std::vector<std::vector<float>> m_harmonicResidualHistory;
+    std::vector<float> m_inputHistory;
+    std::vector<float> m_outputHistory;
+    std::vector<float> m_harmonicResidualHistory;
 
-    std::vector<float> m_inputBuffer;
-    std::vector<float> m_outputBuffer;
-    std::vector<float> m_harmonicResidualBuffer;
+    juce::Image m_labelsImage;
+    bool m_labelsImageDirty = true;
+    int m_shownFundamentalTenths = -1;
     
     // PS1 Wipeout style colors
     const juce::Colour m_bgColor{ 0xff000510 };     // Deep blue-black
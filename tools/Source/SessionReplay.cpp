@@ -0,0 +1,277 @@
+// Replays a session captured by SessionRecorder through a plugin and times it.
+//
+// A plugin records its input and automation when it's prepared with the
+// SAMMYJS_CAPTURE_DIR environment variable set (see shared/Source/SessionRecorder.h).
+// This feeds that exact stream back through the built plugin, block by block
+// and with the same block sizes and parameter changes, and times every
+// processBlock() call against the block's realtime budget.
+//
+// Blocks are fed at realtime pace by default, so the plugin's background
+// threads see the same timing they did in the session; --fast runs them back
+// to back. Gaps where the recorder dropped blocks are filled with silence.
+//
+//   SessionReplay [--fast] [--output <file.wav>] [--top <n>] <capture.sjcap> <plugin>
+//
+// Prints the time per block (mean, 99th percentile and worst), how many blocks
+// went over budget, and the n slowest (default 10) with their position in the
+// session. --output writes what the plugin produced.
+
+#include <JuceHeader.h>
+#include "SessionRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct BlockTiming
+    {
+        int index = 0;
+        juce::int64 startSample = 0;
+        int numSamples = 0;
+        double milliseconds = 0.0;
+        double budgetMilliseconds = 0.0;
+    };
+
+    // Capture parameter index to plugin parameter, by name where the order doesn't line up
+    std::vector<juce::AudioProcessorParameter*> mapParameters(const juce::StringArray& names, juce::AudioPluginInstance& instance)
+    {
+        const auto& parameters = instance.getParameters();
+        std::vector<juce::AudioProcessorParameter*> mapping(static_cast<size_t>(names.size()), nullptr);
+
+        for (int i = 0; i < names.size(); ++i)
+        {
+            if (i < parameters.size() && parameters[i]->getName(128) == names[i])
+            {
+                mapping[static_cast<size_t>(i)] = parameters[i];
+                continue;
+            }
+
+            for (auto* parameter : parameters)
+                if (parameter->getName(128) == names[i])
+                    mapping[static_cast<size_t>(i)] = parameter;
+
+            if (mapping[static_cast<size_t>(i)] == nullptr)
+                std::cout << "warning: the plugin has no parameter \"" << names[i] << "\"; its automation is ignored" << std::endl;
+        }
+
+        return mapping;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    const bool fast = args.containsOption("--fast");
+    const juce::String outputPath = args.getValueForOption("--output");
+    const int numSlowest = args.containsOption("--top") ? args.getValueForOption("--top").getIntValue() : 10;
+
+    juce::StringArray positional;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        if (args[i] == "--output" || args[i] == "--top")
+            ++i;  // and its value
+        else if (! args[i].isOption())
+            positional.add(args[i].text);
+    }
+
+    if (positional.size() != 2)
+    {
+        std::cout << "Usage: SessionReplay [--fast] [--output <file.wav>] [--top <n>] <capture.sjcap> <plugin>" << std::endl;
+        return 1;
+    }
+
+    const juce::File captureFile = juce::File::getCurrentWorkingDirectory().getChildFile(positional[0]);
+    juce::FileInputStream capture(captureFile);
+    SessionRecorder::Header header;
+
+    if (capture.failedToOpen() || ! header.read(capture))
+    {
+        std::cout << "Can't read " << captureFile.getFullPathName() << " as a capture" << std::endl;
+        return 1;
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::AudioPluginFormatManager formatManager;
+    formatManager.addDefaultFormats();
+
+    juce::OwnedArray<juce::PluginDescription> descriptions;
+
+    for (auto* format : formatManager.getFormats())
+        if (format->fileMightContainThisPluginType(positional[1]))
+            format->findAllTypesForFile(descriptions, positional[1]);
+
+    if (descriptions.isEmpty())
+    {
+        std::cout << "No plugin found in " << positional[1] << std::endl;
+        return 1;
+    }
+
+    juce::String error;
+    auto instance = formatManager.createPluginInstance(*descriptions[0], header.sampleRate, header.maxBlockSize, error);
+
+    if (instance == nullptr)
+    {
+        std::cout << "Can't load " << positional[1] << ": " << error << std::endl;
+        return 1;
+    }
+
+    if (instance->getName() != header.pluginName)
+        std::cout << "warning: captured from " << header.pluginName << " but replaying through " << instance->getName() << std::endl;
+
+    const auto parameters = mapParameters(header.parameterNames, *instance);
+
+    instance->enableAllBuses();
+    instance->setNonRealtime(false);
+    instance->prepareToPlay(header.sampleRate, header.maxBlockSize);
+
+    const int numChannels = juce::jmax(header.numChannels, instance->getTotalNumInputChannels(), instance->getTotalNumOutputChannels());
+    juce::AudioBuffer<float> buffer(numChannels, header.maxBlockSize);
+    juce::MidiBuffer midi;
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    if (outputPath.isNotEmpty())
+    {
+        const auto outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(outputPath);
+        outputFile.deleteFile();
+
+        std::unique_ptr<juce::OutputStream> stream = outputFile.createOutputStream();
+
+        if (stream != nullptr)
+            writer.reset(wav.createWriterFor(stream.get(), header.sampleRate,
+                                             static_cast<unsigned int>(instance->getTotalNumOutputChannels()), 32, {}, 0));
+
+        if (writer == nullptr)
+        {
+            std::cout << "Can't write " << outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        stream.release(); // owned by the writer now
+    }
+
+    std::cout << "Replaying " << captureFile.getFileName() << " (" << header.pluginName << ", "
+              << header.sampleRate << " Hz) through " << instance->getName()
+              << (fast ? "" : " at realtime pace") << std::endl;
+
+    std::vector<BlockTiming> timings;
+    SessionRecorder::Block block;
+    juce::int64 position = 0;
+    juce::int64 gapSamples = 0;
+    const auto replayStart = Clock::now();
+
+    // The buffer is already sized to numSamples and filled with the input
+    auto processBlock = [&](int numSamples)
+    {
+        const auto start = Clock::now();
+        instance->processBlock(buffer, midi);
+        const auto end = Clock::now();
+
+        BlockTiming timing;
+        timing.index = static_cast<int>(timings.size());
+        timing.startSample = position;
+        timing.numSamples = numSamples;
+        timing.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+        timing.budgetMilliseconds = 1000.0 * numSamples / header.sampleRate;
+        timings.push_back(timing);
+
+        if (writer != nullptr)
+            writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+
+        position += numSamples;
+        midi.clear();
+
+        if (! fast)
+            std::this_thread::sleep_until(replayStart + std::chrono::duration<double>(static_cast<double>(position) / header.sampleRate));
+    };
+
+    while (block.read(capture, header.numChannels))
+    {
+        for (const auto& [index, value] : block.parameterChanges)
+            if (juce::isPositiveAndBelow(index, static_cast<int>(parameters.size())) && parameters[static_cast<size_t>(index)] != nullptr)
+                parameters[static_cast<size_t>(index)]->setValue(value);
+
+        for (int done = 0; done < block.gapSamples; done += header.maxBlockSize)
+        {
+            const int numSamples = juce::jmin(header.maxBlockSize, block.gapSamples - done);
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            buffer.clear();
+            processBlock(numSamples);
+        }
+
+        gapSamples += block.gapSamples;
+
+        if (block.numSamples > 0)
+        {
+            // More channels than captured: the rest are silent, as they would have been
+            buffer.setSize(numChannels, block.numSamples, false, false, true);
+            buffer.clear();
+
+            for (int channel = 0; channel < header.numChannels; ++channel)
+                buffer.copyFrom(channel, 0, block.audio, channel, 0, block.numSamples);
+
+            processBlock(block.numSamples);
+        }
+    }
+
+    instance->releaseResources();
+
+    if (timings.empty())
+    {
+        std::cout << "The capture has no blocks in it" << std::endl;
+        return 1;
+    }
+
+    std::vector<double> sorted;
+
+    for (const auto& timing : timings)
+        sorted.push_back(timing.milliseconds);
+
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0.0;
+    int numOverBudget = 0;
+
+    for (const auto& timing : timings)
+    {
+        total += timing.milliseconds;
+        numOverBudget += timing.milliseconds > timing.budgetMilliseconds ? 1 : 0;
+    }
+
+    const auto percentile99 = sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)];
+
+    std::cout << std::endl
+              << timings.size() << " blocks, " << juce::String(static_cast<double>(position) / header.sampleRate, 2) << " s"
+              << (gapSamples > 0 ? " (" + juce::String(static_cast<double>(gapSamples) / header.sampleRate, 2) + " s of gaps filled with silence)" : juce::String())
+              << std::endl
+              << "per block: mean " << juce::String(total / static_cast<double>(timings.size()), 3) << " ms"
+              << ", 99% " << juce::String(percentile99, 3) << " ms"
+              << ", worst " << juce::String(sorted.back(), 3) << " ms" << std::endl
+              << numOverBudget << " blocks over their realtime budget" << std::endl << std::endl;
+
+    auto slowest = timings;
+    std::sort(slowest.begin(), slowest.end(), [](const auto& a, const auto& b) { return a.milliseconds > b.milliseconds; });
+    slowest.resize(std::min(slowest.size(), static_cast<size_t>(juce::jmax(0, numSlowest))));
+
+    for (const auto& timing : slowest)
+    {
+        std::cout << "  block " << juce::String(timing.index).paddedLeft(' ', 7)
+                  << "  at " << juce::String(static_cast<double>(timing.startSample) / header.sampleRate, 3).paddedLeft(' ', 9) << " s"
+                  << "  " << juce::String(timing.numSamples).paddedLeft(' ', 5) << " samples"
+                  << "  " << juce::String(timing.milliseconds, 3).paddedLeft(' ', 9) << " ms"
+                  << " (" << juce::String(100.0 * timing.milliseconds / timing.budgetMilliseconds, 0) << "% of budget)"
+                  << std::endl;
+    }
+
+    return 0;
+}
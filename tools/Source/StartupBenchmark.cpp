@@ -0,0 +1,176 @@
+// Startup cost benchmark for the built plugins.
+//
+// Loads each plugin the way a host does during a scan or a session load, and
+// times the steps up to the first audio it hands back:
+//
+//   create       load the binary and instantiate the processor
+//   prepare      prepareToPlay()
+//   first block  the first processBlock() call
+//
+// Each plugin is run twice. The realtime pass is what a host waits for before
+// audio flows; plugins that build their engines in the background pass audio
+// through until they're done, so it doesn't include that work. The offline pass
+// (setNonRealtime) makes them wait for it in the first block, so "first audio"
+// there is the time to fully processed output. The binary is already loaded by
+// then, so its create time is the warm one.
+//
+// Resident memory is read after creating the instance and again after the first
+// block, each against the figure from before the plugin was loaded.
+//
+//   StartupBenchmark [--sample-rate <hz>] [--block-size <n>] <plugin> [<plugin> ...]
+//
+// Plugins are paths to .vst3 bundles (or .component on macOS). Returns non-zero
+// if any of them fails to load.
+
+#include <JuceHeader.h>
+#include "ProcessMemory.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct Timings
+    {
+        double createMs = 0.0;
+        double prepareMs = 0.0;
+        double firstBlockMs = 0.0;
+        juce::int64 createdBytes = 0;
+        juce::int64 firstBlockBytes = 0;
+
+        double getFirstAudioMs() const  { return createMs + prepareMs + firstBlockMs; }
+    };
+
+    bool run(juce::AudioPluginFormatManager& formatManager, const juce::PluginDescription& description,
+             double sampleRate, int blockSize, bool offline, Timings& timings, juce::String& error)
+    {
+        const auto baseline = ProcessMemory::getResidentBytes();
+
+        auto start = Clock::now();
+        auto instance = formatManager.createPluginInstance(description, sampleRate, blockSize, error);
+        timings.createMs = millisecondsSince(start);
+
+        if (instance == nullptr)
+            return false;
+
+        timings.createdBytes = ProcessMemory::getResidentBytes() - baseline;
+
+        instance->enableAllBuses();
+        instance->setNonRealtime(offline);
+
+        start = Clock::now();
+        instance->prepareToPlay(sampleRate, blockSize);
+        timings.prepareMs = millisecondsSince(start);
+
+        // A quiet sine, so plugins that skip silent input still do their work
+        const int numChannels = juce::jmax(instance->getTotalNumInputChannels(), instance->getTotalNumOutputChannels());
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(channel, i, 0.1f * std::sin(juce::MathConstants<float>::twoPi * 220.0f * static_cast<float>(i / sampleRate)));
+
+        start = Clock::now();
+        instance->processBlock(buffer, midi);
+        timings.firstBlockMs = millisecondsSince(start);
+
+        timings.firstBlockBytes = ProcessMemory::getResidentBytes() - baseline;
+
+        instance->releaseResources();
+        return true;
+    }
+
+    void printTimings(const char* pass, const Timings& timings)
+    {
+        std::cout << "  " << juce::String(pass).paddedRight(' ', 9)
+                  << "create " << juce::String(timings.createMs, 1).paddedLeft(' ', 8) << " ms"
+                  << "  prepare " << juce::String(timings.prepareMs, 1).paddedLeft(' ', 8) << " ms"
+                  << "  first block " << juce::String(timings.firstBlockMs, 1).paddedLeft(' ', 8) << " ms"
+                  << "  first audio " << juce::String(timings.getFirstAudioMs(), 1).paddedLeft(' ', 8) << " ms"
+                  << "  resident +" << ProcessMemory::formatMegabytes(timings.createdBytes)
+                  << " / +" << ProcessMemory::formatMegabytes(timings.firstBlockBytes)
+                  << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    const double sampleRate = args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+    const int blockSize = args.containsOption("--block-size") ? args.getValueForOption("--block-size").getIntValue() : 512;
+
+    juce::StringArray pluginPaths;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        if (args[i].isOption())
+            ++i;  // and its value
+        else
+            pluginPaths.add(args[i].text);
+    }
+
+    if (pluginPaths.isEmpty())
+    {
+        std::cout << "Usage: StartupBenchmark [--sample-rate <hz>] [--block-size <n>] <plugin> [<plugin> ...]" << std::endl;
+        return 1;
+    }
+
+    // Plugins expect a message manager, as they would have in a host
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::AudioPluginFormatManager formatManager;
+    formatManager.addDefaultFormats();
+
+    std::cout << "Plugin startup (" << sampleRate << " Hz, " << blockSize << " sample blocks)" << std::endl
+              << "resident memory is after create / after the first block" << std::endl << std::endl;
+
+    int numFailures = 0;
+
+    for (const auto& path : pluginPaths)
+    {
+        juce::OwnedArray<juce::PluginDescription> descriptions;
+
+        for (auto* format : formatManager.getFormats())
+            if (format->fileMightContainThisPluginType(path))
+                format->findAllTypesForFile(descriptions, path);
+
+        if (descriptions.isEmpty())
+        {
+            std::cout << "FAIL " << path << ": no plugin found" << std::endl;
+            ++numFailures;
+            continue;
+        }
+
+        for (const auto* description : descriptions)
+        {
+            std::cout << description->name << " (" << description->pluginFormatName << ")" << std::endl;
+
+            Timings realtime, offline;
+            juce::String error;
+
+            if (! run(formatManager, *description, sampleRate, blockSize, false, realtime, error)
+             || ! run(formatManager, *description, sampleRate, blockSize, true, offline, error))
+            {
+                std::cout << "  FAIL " << error << std::endl;
+                ++numFailures;
+                continue;
+            }
+
+            printTimings("realtime", realtime);
+            printTimings("offline", offline);
+            std::cout << std::endl;
+        }
+    }
+
+    return numFailures == 0 ? 0 : 1;
+}